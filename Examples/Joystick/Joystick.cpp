@@ -36,6 +36,16 @@ void Joystick::Destroy(Game& game)
 	renderer.SetCamera(nullptr);
 }
 
+void Joystick::Suspend(Game& game)
+{
+	game.GetRenderer().SetCamera(nullptr);
+}
+
+void Joystick::Resume(Game& game)
+{
+	game.GetRenderer().SetCamera(&m_camera);
+}
+
 void Joystick::Update(Game& game)
 {
 	IInput& input = game.GetInput();
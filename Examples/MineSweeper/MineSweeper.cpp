@@ -33,6 +33,7 @@ const int Grid::s_adjacentTiles[][2] =
 
 Grid::Grid() : m_uiMineCount(0), m_uiMarkedCount(0), m_uiMarkedCorrectlyCount(0)
 {
+	SetTileTexture("tile");
 }
 
 int Grid::Update(IInput& input)
@@ -51,6 +52,7 @@ int Grid::Update(IInput& input)
 			if(bMouse1 && !pTile->marked)
 			{
 				pTile->selsected = true;
+				MarkTileDirty(m_numTiles.x * arrayPos.y + arrayPos.x);
 				if(pTile->mine)
 				{
 					bMine = true;
@@ -91,6 +93,7 @@ int Grid::Update(IInput& input)
 									if(!m_tiles[newIndex].marked)
 									{
 										m_tiles[newIndex].selsected = true;
+										MarkTileDirty(newIndex);
 
 										if(m_tiles[newIndex].minesNearby == 0)
 										{
@@ -108,6 +111,7 @@ int Grid::Update(IInput& input)
 				if (m_uiMarkedCount < m_uiMineCount || pTile->marked)
 				{
 					pTile->marked = !pTile->marked;
+					MarkTileDirty(m_numTiles.x * arrayPos.y + arrayPos.x);
 
 					if (pTile->marked)
 					{
@@ -141,7 +145,7 @@ int Grid::Update(IInput& input)
 	return static_cast<int>(GameStatus::Playing);
 }
 
-void Grid::Render(IRenderer& renderer) const
+void Grid::Render(IRenderer& renderer, const Camera* pCamera) const
 {
 	std::ostringstream stream;
 	stream << "Mines: "<< m_uiMineCount - m_uiMarkedCount;
@@ -150,7 +154,7 @@ void Grid::Render(IRenderer& renderer) const
 	renderer.GetDisplayMode(nullptr,&height);
 	renderer.DrawString(stream.str().c_str(),glm::vec3(0.0f,height - 50.0f,0));
 
-	IGrid::Render(renderer);
+	IGrid::Render(renderer, pCamera);
 }
 
 bool Grid::Load(std::ifstream& stream)
@@ -183,6 +187,7 @@ void Grid::Reset()
 	m_uiMarkedCorrectlyCount = 0;
 
 	BuildGrid();
+	MarkAllDirty();
 }
 
 void Grid::RenderTileCallback(IRenderer& renderer, const Tile& tile, const glm::mat4& T) const
@@ -215,10 +220,29 @@ void Grid::RenderTileCallback(IRenderer& renderer, const Tile& tile, const glm::
 				nullptr, FontAlignment::Center);
 		}
 
-		renderer.DrawSprite("tile",T,glm::vec4(glm::vec3(1.0f),0.8f));
 	}
 }
 
+bool Grid::GetTileSprite(const Tile& tile, SpriteInstance& sprite) const
+{
+	if(tile.selsected)
+		return false;
+
+	sprite.color = glm::vec4(glm::vec3(1.0f),0.8f);
+	sprite.tiling = glm::vec2(1.0f);
+	sprite.cellId = 0;
+
+	return true;
+}
+
+bool Grid::HasOverlay(const Tile& tile) const
+{
+	if(tile.selsected)
+		return tile.mine || (tile.minesNearby != 0);
+
+	return tile.marked;
+}
+
 void Grid::Expand(const glm::uvec2& pos)
 {
 	for (auto iter : s_adjacentTiles)
@@ -232,6 +256,7 @@ void Grid::Expand(const glm::uvec2& pos)
 			if(!m_tiles[newIndex].marked && !m_tiles[newIndex].mine && !m_tiles[newIndex].selsected)
 			{
 				m_tiles[newIndex].selsected = true;
+				MarkTileDirty(newIndex);
 
 				if(m_tiles[newIndex].minesNearby == 0)
 				{
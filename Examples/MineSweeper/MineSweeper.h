@@ -36,7 +36,7 @@ public:
 	virtual int Update(IInput&);
 
 	// Renders the grid
-	virtual void Render(IRenderer&) const;
+	void Render(IRenderer& renderer, const Camera* pCamera = nullptr) const override;
 
 	// Loads the grid from stream
 	virtual bool Load(std::ifstream& stream);
@@ -49,7 +49,13 @@ public:
 
 protected:
 
-	// Callback method called by IGrid to render each tile of the grid
+	// Unselected tiles are drawn as a sprite
+	virtual bool GetTileSprite(const Tile&, SpriteInstance&) const;
+
+	// Only marked tiles and selected tiles showing a mine or a count have text drawn over them
+	virtual bool HasOverlay(const Tile&) const;
+
+	// Callback method called by IGrid to render the text of the tiles with an overlay
 	virtual void RenderTileCallback(IRenderer&,const Tile&, const glm::mat4&) const;
 
 private:
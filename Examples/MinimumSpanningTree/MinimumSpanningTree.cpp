@@ -33,6 +33,18 @@ void MinimumSpanningTree::Destroy(Game& game)
 	renderer.SetCamera(nullptr);
 }
 
+void MinimumSpanningTree::Suspend(Game& game)
+{
+	game.GetRenderer().SetCamera(nullptr);
+	game.EnableEventWaiting(false);
+}
+
+void MinimumSpanningTree::Resume(Game& game)
+{
+	game.GetRenderer().SetCamera(&m_camera);
+	game.EnableEventWaiting(true);
+}
+
 void MinimumSpanningTree::Update(Game& game)
 {
 	IInput& input = game.GetInput();
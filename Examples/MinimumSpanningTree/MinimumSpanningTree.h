@@ -32,6 +32,12 @@ public:
 	// Called only once when the plugin is destroyed
 	virtual void Destroy(class Game& game);
 
+	// Called when the game switches to another state while this state stays resident
+	virtual void Suspend(class Game& game);
+
+	// Called when the game switches back to this state while it is resident
+	virtual void Resume(class Game& game);
+
 	// Called every frame to update the state of the game
 	virtual void Update(class Game& game);
 
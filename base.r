@@ -1,6 +1,9 @@
 shader lineShader shaders/LineVertexShader.vert shaders/LinePixelShader.frag
 shader textShader shaders/TextVertexShader.vert shaders/TextPixelShader.frag
-shader sprite shaders/SpriteVertexShader.vert shaders/SpritePixelShader.frag
+shader sprite shaders/SpriteVertexShader.vert shaders/SpritePixelShader.frag texture tiling animation alphaTest
+shader particle shaders/ParticleVertexShader.vert shaders/ParticlePixelShader.frag
+shader spriteBatch shaders/SpriteBatchVertexShader.vert shaders/SpriteBatchPixelShader.frag
+shader sprite2D shaders/Sprite2DVertexShader.vert shaders/SpriteBatchPixelShader.frag
 font font textures/font.png
 texture button textures/button.png
 texture blank textures/blank.png
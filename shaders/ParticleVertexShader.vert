@@ -0,0 +1,26 @@
+#version 330
+
+// Input vertex data, different for all executions of this shader.
+layout(location = 0) in vec3 vertexPosition_modelspace;
+layout(location = 1) in vec2 vertexUV;
+
+// Per particle data, different for each instance
+layout(location = 2) in vec3 particlePosition;
+layout(location = 3) in float particleSize;
+layout(location = 4) in vec4 particleColor;
+
+// Output data ; will be interpolated for each fragment.
+out vec2 UV;
+out vec4 color;
+
+// Values that stay constant for the whole mesh.
+uniform mat4 MVP;
+
+void main()
+{
+	// Output position of the vertex, in clip space
+	gl_Position = MVP * vec4(particlePosition + vertexPosition_modelspace * particleSize, 1);
+
+	UV = vertexUV;
+	color = particleColor;
+}
@@ -0,0 +1,39 @@
+#version 330
+
+// Input vertex data, different for all executions of this shader.
+layout(location = 0) in vec3 vertexPosition_modelspace;
+layout(location = 1) in vec2 vertexUV;
+
+// Per sprite data, different for each instance
+layout(location = 2) in vec2 spritePosition;
+layout(location = 3) in vec2 spriteScale;
+layout(location = 4) in float spriteRotation;
+layout(location = 5) in float spriteLayer;
+layout(location = 6) in vec4 spriteColor;
+layout(location = 7) in float spriteCellId;
+
+// Output data ; will be interpolated for each fragment.
+out vec2 UV;
+out vec4 color;
+
+// Values that stay constant for the whole mesh.
+uniform mat4 MVP;
+uniform vec2 tileSize;
+
+void main()
+{
+	// Scale, rotate, then translate the quad
+	float c = cos(spriteRotation);
+	float s = sin(spriteRotation);
+
+	vec2 pos = vertexPosition_modelspace.xy * spriteScale;
+	pos = vec2(pos.x * c - pos.y * s, pos.x * s + pos.y * c) + spritePosition;
+
+	// Output position of the vertex, in clip space
+	gl_Position = MVP * vec4(pos, spriteLayer, 1);
+
+	vec2 uvOffset = vec2(mod(spriteCellId,tileSize.x), floor(spriteCellId / tileSize.x));
+
+	UV = (uvOffset + vertexUV) / tileSize;
+	color = spriteColor;
+}
@@ -0,0 +1,30 @@
+#version 330
+
+// Input vertex data, different for all executions of this shader.
+layout(location = 0) in vec3 vertexPosition_modelspace;
+layout(location = 1) in vec2 vertexUV;
+
+// Per sprite data, different for each instance
+layout(location = 2) in mat4 spriteTransformation;
+layout(location = 6) in vec4 spriteColor;
+layout(location = 7) in vec2 spriteTiling;
+layout(location = 8) in float spriteCellId;
+
+// Output data ; will be interpolated for each fragment.
+out vec2 UV;
+out vec4 color;
+
+// Values that stay constant for the whole mesh.
+uniform mat4 MVP;
+uniform vec2 tileSize;
+
+void main()
+{
+	// Output position of the vertex, in clip space
+	gl_Position = MVP * spriteTransformation * vec4(vertexPosition_modelspace,1);
+
+	vec2 uvOffset = vec2(mod(spriteCellId,tileSize.x), floor(spriteCellId / tileSize.x));
+
+	UV = (uvOffset + vertexUV) / tileSize * spriteTiling;
+	color = spriteColor;
+}
@@ -1,19 +1,30 @@
 #version 330
 
+// Features: TEXTURE, ALPHA_TEST, see ShaderFeature
+
+#ifdef TEXTURE
 // Interpolated values from the vertex shaders
 in vec2 UV;
 
+uniform sampler2D textureSampler;
+#endif
+
 out vec4 outColor;
 
 // Values that stay constant for the whole mesh.
-uniform sampler2D textureSampler;
 uniform vec4 uniformColor;
 
 void main()
 {
+#ifdef TEXTURE
 	// Output color = color of the texture at the specified UV
 	outColor = texture( textureSampler, UV ) * uniformColor;
-	
+#else
+	outColor = uniformColor;
+#endif
+
+#ifdef ALPHA_TEST
 	if(outColor.a <= 0.0)
 		discard;
+#endif
 }
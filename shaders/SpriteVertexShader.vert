@@ -1,5 +1,8 @@
 #version 330
 
+// Features: TEXTURE, TILING, ANIMATION, see ShaderFeature
+// Variants without TEXTURE do not output UVs
+
 // Input vertex data, different for all executions of this shader.
 layout(location = 0) in vec3 vertexPosition_modelspace;
 layout(location = 1) in vec2 vertexUV;
@@ -19,7 +22,17 @@ void main()
 	// Output position of the vertex, in clip space
 	gl_Position = MVP * transformation * vec4(vertexPosition_modelspace,1);
 
+#ifdef TEXTURE
+#ifdef ANIMATION
 	vec2 uvOffset = vec2(mod(tileIndex,tileSize.x), floor(tileIndex / tileSize.x));
 
-	UV = (uvOffset + vertexUV) / tileSize * tiling;
+	UV = (uvOffset + vertexUV) / tileSize;
+#else
+	UV = vertexUV;
+#endif
+
+#ifdef TILING
+	UV *= tiling;
+#endif
+#endif
 }
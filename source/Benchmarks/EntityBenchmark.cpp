@@ -0,0 +1,167 @@
+// Compares updating entities stored in an EntityWorld with updating objects held in a vector of unique_ptr
+// usage: EntityBenchmark [entity count] [worker count]
+
+#include "EntityWorld.h"
+#include "JobSystem.h"
+#include "Timer.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <glm/vec2.hpp>
+
+struct Position
+{
+	glm::vec2 value;
+};
+
+struct Velocity
+{
+	glm::vec2 value;
+};
+
+struct Lifetime
+{
+	float value;
+};
+
+// Game objects as they are written in the plugins today
+class IObject
+{
+public:
+
+	virtual ~IObject() {}
+	virtual void Update(float dt) = 0;
+};
+
+class MovingObject : public IObject
+{
+public:
+
+	MovingObject(const glm::vec2& pos, const glm::vec2& vel) : m_pos(pos), m_vel(vel), m_fLifetime(10.0f) {}
+
+	void Update(float dt) override
+	{
+		m_pos += m_vel * dt;
+		m_fLifetime -= dt;
+	}
+
+private:
+
+	glm::vec2 m_pos;
+	glm::vec2 m_vel;
+	float m_fLifetime;
+};
+
+const unsigned int UPDATES = 100;
+const float DT = 1.0f / 60.0f;
+
+int main(int size, char** cmd)
+{
+	unsigned int uiEntities = 100000;
+	unsigned int uiWorkers = 0;
+
+	if (size >= 2)
+	{
+		uiEntities = (unsigned int)atoi(cmd[1]);
+	}
+
+	if (size >= 3)
+	{
+		uiWorkers = (unsigned int)atoi(cmd[2]);
+	}
+
+	JobSystem jobs(uiWorkers);
+	Timer theTimer;
+
+	// Objects are created in between other allocations, like objects created over the course of a game
+	std::vector<std::unique_ptr<IObject>> objects;
+	std::vector<std::unique_ptr<int>> padding;
+
+	for (unsigned int i = 0; i < uiEntities; ++i)
+	{
+		objects.emplace_back(new MovingObject(glm::vec2((float)i, 0.0f), glm::vec2(1.0f, 2.0f)));
+		padding.emplace_back(new int[(i % 7) * 8 + 1]);
+	}
+
+	theTimer.Start();
+
+	for (unsigned int update = 0; update < UPDATES; ++update)
+	{
+		for (auto& pObject : objects)
+		{
+			pObject->Update(DT);
+		}
+	}
+
+	double fObjectTime = theTimer.GetTime();
+
+	EntityWorld world;
+
+	theTimer.Start();
+
+	for (unsigned int i = 0; i < uiEntities; ++i)
+	{
+		world.Create(Position{ glm::vec2((float)i, 0.0f) }, Velocity{ glm::vec2(1.0f, 2.0f) }, Lifetime{ 10.0f });
+	}
+
+	double fCreateTime = theTimer.GetTime();
+
+	theTimer.Start();
+
+	for (unsigned int update = 0; update < UPDATES; ++update)
+	{
+		world.ForEach<Position, const Velocity, Lifetime>([](Entity, Position& pos, const Velocity& vel, Lifetime& lifetime)
+		{
+			pos.value += vel.value * DT;
+			lifetime.value -= DT;
+		});
+	}
+
+	double fForEachTime = theTimer.GetTime();
+
+	theTimer.Start();
+
+	for (unsigned int update = 0; update < UPDATES; ++update)
+	{
+		world.ParallelForEachChunk<Position, const Velocity, Lifetime>(jobs, [](unsigned int count, const Entity*, Position* pPos, const Velocity* pVel, Lifetime* pLifetime)
+		{
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				pPos[i].value += pVel[i].value * DT;
+				pLifetime[i].value -= DT;
+			}
+		});
+	}
+
+	double fParallelTime = theTimer.GetTime();
+
+	// Structural changes: every other entity loses its velocity, then a third of them get destroyed
+	std::vector<Entity> entities;
+	world.ForEach<Position>([&entities](Entity e, Position&) { entities.push_back(e); });
+
+	theTimer.Start();
+
+	for (unsigned int i = 0; i < entities.size(); i += 2)
+	{
+		world.Remove<Velocity>(entities[i]);
+	}
+
+	for (unsigned int i = 0; i < entities.size(); i += 3)
+	{
+		world.Destroy(entities[i]);
+	}
+
+	double fChangeTime = theTimer.GetTime();
+	const double fPerEntity = 1e9 / ((double)uiEntities * UPDATES);
+
+	std::cout << "Entities: " << uiEntities << ", workers: " << jobs.GetNumWorkers() << ", left: " << world.GetNumEntities() << std::endl;
+	std::cout << "unique_ptr objects: " << fObjectTime * fPerEntity << " ns/entity" << std::endl;
+	std::cout << "ForEach: " << fForEachTime * fPerEntity << " ns/entity" << std::endl;
+	std::cout << "ParallelForEachChunk: " << fParallelTime * fPerEntity << " ns/entity" << std::endl;
+	std::cout << "Create: " << (fCreateTime * 1e9 / uiEntities) << " ns/entity" << std::endl;
+	std::cout << "Remove and destroy: " << (fChangeTime * 1e9 / (entities.size() / 2 + entities.size() / 3)) << " ns/entity" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,105 @@
+// Measures the scheduling overhead of the job system
+// usage: JobBenchmark [job count] [worker count]
+
+#include "JobSystem.h"
+#include "Timer.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+
+int main(int size, char** cmd)
+{
+	unsigned int uiJobs = 1000000;
+	unsigned int uiWorkers = 0;
+
+	if (size >= 2)
+	{
+		uiJobs = (unsigned int)atoi(cmd[1]);
+	}
+
+	if (size >= 3)
+	{
+		uiWorkers = (unsigned int)atoi(cmd[2]);
+	}
+
+	JobSystem jobs(uiWorkers);
+	std::atomic<unsigned int> executed(0);
+
+	Timer theTimer;
+
+	// Empty jobs queued by the main thread, most of them are stolen by the workers
+	JobCounter counter;
+
+	theTimer.Start();
+
+	for (unsigned int i = 0; i < uiJobs; ++i)
+	{
+		jobs.Run([&executed] { executed.fetch_add(1, std::memory_order_relaxed); }, &counter);
+	}
+
+	jobs.Wait(counter);
+
+	double fRunTime = theTimer.GetTime();
+
+	// Each job queues the next one from a worker, which measures the latency of a dependency chain
+	const unsigned int uiChain = uiJobs / 100 + 1;
+	JobCounter chainCounter;
+	std::function<void(unsigned int)> next = [&](unsigned int i)
+	{
+		if (i < uiChain)
+		{
+			jobs.Run([&next, i] { next(i + 1); }, &chainCounter);
+		}
+	};
+
+	theTimer.Start();
+
+	next(0);
+	jobs.Wait(chainCounter);
+
+	double fChainTime = theTimer.GetTime();
+
+	// Jobs released by a dependency
+	JobCounter first;
+	JobCounter second;
+
+	theTimer.Start();
+
+	for (unsigned int i = 0; i < uiJobs / 2; ++i)
+	{
+		jobs.Run([&executed] { executed.fetch_add(1, std::memory_order_relaxed); }, &first);
+	}
+
+	for (unsigned int i = 0; i < uiJobs / 2; ++i)
+	{
+		jobs.Run([&executed] { executed.fetch_add(1, std::memory_order_relaxed); }, &second, &first);
+	}
+
+	jobs.Wait(second);
+
+	double fDependencyTime = theTimer.GetTime();
+
+	// A parallel for with one element per batch is the worst case of ParallelFor()
+	theTimer.Start();
+
+	// Without workers, ParallelFor() runs the whole range inline as a single batch
+	std::atomic<unsigned int> batches(0);
+
+	jobs.ParallelFor(uiJobs, 1, [&executed, &batches](unsigned int begin, unsigned int end)
+	{
+		executed.fetch_add(end - begin, std::memory_order_relaxed);
+		batches.fetch_add(1, std::memory_order_relaxed);
+	});
+
+	double fParallelForTime = theTimer.GetTime();
+
+	std::cout << "Jobs: " << uiJobs << ", workers: " << jobs.GetNumWorkers() << ", executed: " << executed.load() << std::endl;
+	std::cout << "Run: " << (fRunTime * 1e9 / uiJobs) << " ns/job" << std::endl;
+	std::cout << "Chain: " << (fChainTime * 1e9 / uiChain) << " ns/job" << std::endl;
+	std::cout << "Dependency: " << (fDependencyTime * 1e9 / uiJobs) << " ns/job" << std::endl;
+	std::cout << "ParallelFor: " << (fParallelForTime * 1e9 / batches.load()) << " ns/batch, " << batches.load() << " batches";
+	std::cout << ((batches.load() == 1) ? " (run inline)" : "") << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,98 @@
+// Measures the CPU cost of updating and preparing particles for rendering
+// usage: ParticleBenchmark [particle count] [frames] [worker count]
+// With a worker count, particles are updated by the job system, 0 uses every hardware thread
+
+#include "ParticleSystem.h"
+#include "JobSystem.h"
+#include "Timer.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+int main(int size, char** cmd)
+{
+	unsigned int uiParticles = 1000000;
+	unsigned int uiFrames = 600;
+
+	if (size >= 2)
+	{
+		uiParticles = (unsigned int)atoi(cmd[1]);
+	}
+
+	if (size >= 3)
+	{
+		uiFrames = (unsigned int)atoi(cmd[2]);
+	}
+
+	std::unique_ptr<JobSystem> pJobs;
+
+	if (size >= 4)
+	{
+		pJobs.reset(new JobSystem((unsigned int)atoi(cmd[3])));
+	}
+
+	const float dt = 1.0f / 60.0f;
+
+	ParticleEmitterDesc desc;
+	desc.spawnArea = glm::vec2(100.0f);
+	desc.velocityMin = glm::vec2(-50.0f);
+	desc.velocityMax = glm::vec2(50.0f);
+	desc.acceleration = glm::vec2(0.0f, -9.8f);
+	desc.lifetimeMin = 2.0f;
+	desc.lifetimeMax = 4.0f;
+	desc.maxParticles = uiParticles;
+	desc.spawnRate = uiParticles / desc.lifetimeMin;
+	desc.color = ParticleCurve<glm::vec4>(glm::vec4(1.0f), glm::vec4(1.0f, 0.5f, 0.0f, 0.0f));
+	desc.size = ParticleCurve<float>(1.0f, 4.0f);
+
+	ParticleSystem particles;
+	particles.CreateEmitter(desc);
+
+	if (pJobs)
+	{
+		JobSystem* pJobSystem = pJobs.get();
+		particles.SetParallelFor([pJobSystem](unsigned int count, unsigned int batchSize, const std::function<void(unsigned int, unsigned int)>& body)
+		{
+			pJobSystem->ParallelFor(count, batchSize, body);
+		});
+	}
+
+	// Fill up the emitter before measuring
+	while (particles.GetCount() < uiParticles)
+	{
+		particles.Update(dt);
+	}
+
+	std::vector<ParticleVertex> vertices(uiParticles);
+
+	double fUpdateTime = 0.0;
+	double fBuildTime = 0.0;
+	double fParticleFrames = 0.0;
+
+	Timer theTimer;
+
+	for (unsigned int i = 0; i < uiFrames; ++i)
+	{
+		theTimer.Start();
+		particles.Update(dt);
+		fUpdateTime += theTimer.GetTime();
+
+		const ParticleEmitter& emitter = particles.GetEmitter(0);
+
+		theTimer.Start();
+		emitter.BuildVertices(vertices.data());
+		fBuildTime += theTimer.GetTime();
+
+		fParticleFrames += emitter.GetCount();
+	}
+
+	std::cout << "Particles: " << uiParticles << ", frames: " << uiFrames << ", workers: " << (pJobs ? pJobs->GetNumWorkers() : 0) << std::endl;
+	std::cout << "Update: " << (fUpdateTime * 1e9 / fParticleFrames) << " ns/particle, "
+			  << (fUpdateTime * 1e3 / uiFrames) << " ms/frame" << std::endl;
+	std::cout << "Build vertices: " << (fBuildTime * 1e9 / fParticleFrames) << " ns/particle, "
+			  << (fBuildTime * 1e3 / uiFrames) << " ms/frame" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,131 @@
+// Replays a render capture recorded with F12 in game and measures the cost of submitting and presenting each frame
+// usage: RenderReplay [capture file] [repeat count] [threaded]
+// threaded: renders on the render thread, submission then overlaps with the replay of the next frame
+// Must be run from the directory containing base.r. To measure without a GPU, run with a software rasterizer, ex: LIBGL_ALWAYS_SOFTWARE=1 on Mesa
+
+#include "Game.h"
+#include "RenderCapture.h"
+#include "Timer.h"
+#include "MainWindow.h"
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int size, char** cmd)
+{
+	const char* pFile = "capture.rcap";
+	unsigned int uiRepeat = 10;
+	bool bThreaded = false;
+
+	if (size >= 2)
+	{
+		pFile = cmd[1];
+	}
+
+	if (size >= 3)
+	{
+		uiRepeat = (unsigned int)atoi(cmd[2]);
+	}
+
+	if (size >= 4)
+	{
+		bThreaded = (std::string(cmd[3]) == "threaded");
+	}
+
+	try
+	{
+		// The reader owns the world camera given to the renderer, so it must outlive the game
+		RenderCaptureReader capture;
+		Game game;
+
+		if (!capture.Load(pFile))
+		{
+			std::cout << "Could not load render capture: " << pFile << std::endl;
+			return 1;
+		}
+
+		IRenderer& renderer = game.GetRenderer();
+		IResourceManager& rm = renderer.GetResourceManager();
+
+		// Textures of the game states are not part of base.r, replace the missing ones with a blank texture
+		// Meshes that are not loaded by base.r are skipped by the renderer
+		for (auto& texture : capture.GetTextures())
+		{
+			TextureInfo info;
+			if (!rm.GetTextureInfo(texture, info))
+			{
+				rm.LoadTexture(texture, "textures/blank.png");
+			}
+		}
+
+		renderer.EnableVSync(false);
+		renderer.EnableRenderThread(bThreaded);
+
+		const unsigned int uiFrames = capture.GetNumFrames();
+
+		std::vector<double> frameTimes;
+		frameTimes.reserve(uiFrames * uiRepeat);
+
+		double fSubmitTime = 0.0;
+		double fPresentTime = 0.0;
+		double fDrawCalls = 0.0;
+		double fInstances = 0.0;
+
+		Timer theTimer;
+
+		for (unsigned int i = 0; i < uiRepeat && !glfwWindowShouldClose(GetMainWindow()); ++i)
+		{
+			for (unsigned int frame = 0; frame < uiFrames; ++frame)
+			{
+				theTimer.Start();
+				capture.Replay(frame, renderer);
+				double fSubmit = theTimer.GetTime();
+
+				renderer.Present();
+				double fTotal = theTimer.GetTime();
+
+				glfwPollEvents();
+
+				const RenderStats& stats = renderer.GetStats();
+
+				fSubmitTime += fSubmit;
+				fPresentTime += stats.presentTime;
+				fDrawCalls += stats.drawCalls;
+				fInstances += stats.instances;
+				frameTimes.push_back(fTotal);
+			}
+		}
+
+		if (frameTimes.empty())
+			return 0;
+
+		std::sort(frameTimes.begin(), frameTimes.end());
+
+		double fFrames = (double)frameTimes.size();
+		double fTotalTime = 0.0;
+		for (double t : frameTimes)
+		{
+			fTotalTime += t;
+		}
+
+		std::cout << "Capture: " << pFile << ", frames: " << uiFrames << ", replayed: " << frameTimes.size() << (bThreaded ? ", render thread" : "") << std::endl;
+		std::cout << "Frame: " << (fTotalTime * 1e3 / fFrames) << " ms avg, "
+				  << (frameTimes.front() * 1e3) << " ms min, "
+				  << (frameTimes[frameTimes.size() * 95 / 100] * 1e3) << " ms 95th, "
+				  << (frameTimes.back() * 1e3) << " ms max" << std::endl;
+		std::cout << "Submit: " << (fSubmitTime * 1e3 / fFrames) << " ms/frame, Present: " << (fPresentTime * 1e3 / fFrames) << " ms/frame" << std::endl;
+		std::cout << "Draw calls: " << (fDrawCalls / fFrames) << "/frame, instances: " << (fInstances / fFrames) << "/frame" << std::endl;
+	}
+	catch (std::string msg)
+	{
+		std::cout << msg << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -4,7 +4,7 @@ namespace UI
 {
 
 ProgressBar::ProgressBar(const glm::vec2& start, const glm::vec2& end, const DELEGATE& callback) : m_pos(start),
-	m_start(start), m_end(end), m_callback(callback)
+	m_start(start), m_end(end), m_callback(callback), m_space(World)
 {
 }
 
@@ -39,7 +39,7 @@ void ProgressBar::Render(IRenderer& renderer)
 		glm::vec3(m_end,-100.0f)
 	};
 
-	renderer.SetRenderSpace(World);
+	renderer.SetRenderSpace(m_space);
 
 	renderer.DrawLine(progStart,2,2.0f,glm::vec4(1.0f,0.0f,0.0f,1.0f));
 	renderer.DrawLine(progEnd,2,2.0f);
@@ -51,6 +51,11 @@ void ProgressBar::SetProgress(float v)
 	m_pos.x = m_start.x + dist * glm::clamp(v,0.0f,1.0f);
 }
 
+void ProgressBar::SetRenderSpace(RenderSpace space)
+{
+	m_space = space;
+}
+
 void ProgressBar::SetPos(const glm::vec2& pos)
 {
 	glm::vec2 diff = (m_end - m_start) * 0.5f;
@@ -37,12 +37,16 @@ public:
 
 	void SetPos(const glm::vec2& pos);
 
+	// Sets the space the bar is drawn in, World by default
+	void SetRenderSpace(RenderSpace space);
+
 private:
 
 	glm::vec2 m_pos;
 	glm::vec2 m_start;
 	glm::vec2 m_end;
 	DELEGATE m_callback;
+	RenderSpace m_space;
 
 };
 
@@ -1,7 +1,7 @@
 #include "GLFWInit.h"
 #include <GLFW/glfw3.h>
-#include <cassert>
 #include "Log.h"
+#include <cstdlib>
 
 //todo: figure out how to use c++ exceptions with glfw
 
@@ -13,14 +13,30 @@ static void ErrorCallback(int, const char* error)
 
 GLFWInit::GLFWInit()
 {
-	glfwSetErrorCallback(ErrorCallback);
+	m_bInitialized = (glfwInit() == GL_TRUE);
 
-	assert(glfwInit() == GL_TRUE);
+	// Any error after this point is fatal
+	if (m_bInitialized)
+	{
+		glfwSetErrorCallback(ErrorCallback);
+	}
+	else
+	{
+		Log::Instance().Write("Failed to initialize GLFW, only the headless plug-ins can be used");
+	}
 }
 
 GLFWInit::~GLFWInit()
 {
-	glfwTerminate();
+	if (m_bInitialized)
+	{
+		glfwTerminate();
+	}
+}
+
+bool GLFWInit::IsInitialized() const
+{
+	return m_bInitialized;
 }
 
 
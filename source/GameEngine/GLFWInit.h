@@ -2,12 +2,19 @@
 #define _GLFWINIT_
 
 // initializes glfw
+// GLFW cannot be initialized without a display, the game can then only run headless, see NullRenderer and NullInput
 class GLFWInit
 {
 public:
 
 	GLFWInit();
 	~GLFWInit();
+
+	bool IsInitialized() const;
+
+private:
+
+	bool m_bInitialized;
 };
 
 #endif
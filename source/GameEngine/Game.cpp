@@ -2,20 +2,32 @@
 #include "Game.h"
 #include "Log.h"
 #include "ResourceFileLoader.h"
+#include "RandomGenerator.h"
+#include "Profiler.h"
+#include "MainWindow.h"
 #include <string>
 #include <sstream>
 #include <ctime>
 #include <iomanip>
 #include <iostream>
 #include <thread>
+#include <algorithm>
+#include <random>
 
 #include <GLFW/glfw3.h>
 #include <glm/vec3.hpp>
 
 using namespace std;
 
-Game::Game() : m_fDT(0.0), m_fTimeElapsed(0.0), m_uiFrameCounter(0), m_uiFPS(0),
-m_pRenderer(nullptr), m_pInput(nullptr), m_bDrawFPS(false)
+// Used instead of polling the events when there is no window
+static void ProcessNoEvents()
+{
+}
+
+Game::Game(const std::string& renderer, const std::string& input) : m_fDT(0.0), m_fFrameDT(0.0), m_fTimeElapsed(0.0), m_uiFrameCounter(0), m_uiFPS(0),
+m_pRenderer(nullptr), m_pInput(nullptr), m_rendererPlugin(renderer), m_inputPlugin(input), m_bHeadless(false), m_bQuit(false), m_bDrawFPS(false), m_bLowLatency(false), m_uiSavedFramesInFlight(0), m_fWorkTime(0.0), m_fFrameInterval(0.0),
+m_fFixedStep(0.0), m_uiMaxSteps(5), m_fAccumulator(0.0), m_fAlpha(0.0), m_bInputConsumed(true), m_fFocusedFPS(0.0), m_fUnfocusedFPS(0.0), m_fIconifiedFPS(10.0),
+m_uiMaxFrames(0), m_fMaxTime(0.0)
 {
 	LoadPlugins();
 
@@ -29,6 +41,18 @@ Game::~Game()
 	Log::Instance().Write("Shutting Down");
 
 	m_StateMachine.RemoveState(*this);
+
+	if (!m_frameStatsFile.empty())
+	{
+		if (m_frameStats.Dump(m_frameStatsFile))
+		{
+			Log::Instance().Write("Frame statistics written to " + m_frameStatsFile);
+		}
+		else
+		{
+			Log::Instance().Write("Failed to write the frame statistics to " + m_frameStatsFile);
+		}
+	}
 }
 
 std::string Game::GetCurrentStateName() const
@@ -45,14 +69,116 @@ void Game::SetNextState(const std::string& state)
 	}
 }
 
+void Game::PreloadState(const std::string& state)
+{
+	m_StateMachine.Preload(state, *this);
+}
+
+float Game::GetPreloadProgress() const
+{
+	return m_StateMachine.GetPreloadProgress();
+}
+
+void Game::SetResidentStates(unsigned int uiMaxStates, unsigned int uiMaxBytes)
+{
+	m_StateMachine.SetResidentLimit(uiMaxStates, uiMaxBytes);
+}
+
+void Game::SetRunLimit(unsigned int uiFrames, double fSeconds)
+{
+	m_uiMaxFrames = uiFrames;
+	m_fMaxTime = fSeconds;
+
+	EnableEventWaiting(false);
+}
+
+bool Game::IsStateChangeReady() const
+{
+	if (m_NextState.empty())
+		return false;
+
+	// The time a preload takes varies, so recordings switch states right away to replay the same updates
+	if (m_pInput->IsRecording() || m_pInput->IsReplaying())
+		return true;
+
+	return !m_StateMachine.IsPreloading(m_NextState);
+}
+
+void Game::EnableLowLatency(bool bEnable)
+{
+	if (bEnable == m_bLowLatency)
+		return;
+
+	m_bLowLatency = bEnable;
+
+	if (bEnable)
+	{
+		// Only the frame being drawn may be queued, so input is never sampled more than a frame ahead of the display
+		m_uiSavedFramesInFlight = m_pRenderer->GetMaxFramesInFlight();
+		m_pRenderer->SetMaxFramesInFlight(1);
+	}
+	else
+	{
+		m_pRenderer->SetMaxFramesInFlight(m_uiSavedFramesInFlight);
+	}
+}
+
+void Game::DelayInput(double fElapsed)
+{
+	bool bVSync = false;
+	m_pRenderer->GetDisplayMode(nullptr, nullptr, &bVSync);
+
+	// Without vsync the next frame can start right away, so there is nothing to gain by waiting
+	if (!bVSync)
+	{
+		m_fFrameInterval = 0.0;
+		return;
+	}
+
+	// With vsync, frames are paced by the refresh rate, which is estimated from the frame times
+	m_fFrameInterval = (m_fFrameInterval > 0.0) ? (m_fFrameInterval + (m_fFrameDT - m_fFrameInterval) * 0.1) : m_fFrameDT;
+
+	// Sample input as late as possible while leaving enough time to finish the frame before the next refresh
+	const double fSafetyMargin = 0.002;
+	double fDelay = m_fFrameInterval - fElapsed - (m_fWorkTime * 1.5) - fSafetyMargin;
+
+	if (fDelay > 0.0)
+	{
+		std::this_thread::sleep_for(std::chrono::microseconds((long long)(fDelay * 1e6)));
+	}
+}
+
+void Game::SetFixedTimestep(double fStep, unsigned int uiMaxSteps)
+{
+	assert(uiMaxSteps > 0);
+
+	m_fFixedStep = fStep;
+	m_uiMaxSteps = uiMaxSteps;
+	m_fAccumulator = 0.0;
+	m_fAlpha = 0.0;
+}
+
+double Game::GetInterpolation() const
+{
+	return m_fAlpha;
+}
+
 void Game::Quit() const
 {
-	glfwSetWindowShouldClose(glfwGetCurrentContext(), GL_TRUE);
+	m_bQuit = true;
 }
 
 void Game::EnableEventWaiting(bool bEnable)
 {
-	if (bEnable)
+	// Benchmarks and replays do not get events to wake up from
+	bEnable = bEnable && (m_uiMaxFrames == 0) && (m_fMaxTime <= 0.0) && !m_pInput->IsReplaying();
+
+	if (m_bHeadless)
+	{
+		m_pProccessEvents = ProcessNoEvents;
+		bEnable = false;
+	}
+	else if (bEnable)
 	{
 		m_pProccessEvents = glfwWaitEvents;
 	}
@@ -60,23 +186,103 @@ void Game::EnableEventWaiting(bool bEnable)
 	{
 		m_pProccessEvents = glfwPollEvents;
 	}
+
+	// Screens that wait for events are mostly static, so unchanged frames do not need to be presented
+	m_pRenderer->EnableFrameElision(bEnable);
 }
 
 void Game::LoadPlugins()
 {
-	m_plugins.FreeAllPlugins();
+	// The renderer stays resident, so its window, context and resource cache survive a reload
+	if (m_pRenderer == nullptr)
+	{
+		IPlugin* pPlugin = m_plugins.LoadPlugin(m_rendererPlugin);
+		assert(pPlugin->GetPluginType() == DLLType::Rendering); // check to make sure the renderer is actually the renderer
+
+		m_pRenderer = static_cast<IRenderer*>(pPlugin);
 
-	IPlugin* pPlugin = m_plugins.LoadPlugin("renderer");
-	assert(pPlugin->GetPluginType() == DLLType::Rendering); // check to make sure the renderer is actually the renderer
+		// The headless renderer does not create a window, GLFW may not even be initialized
+		m_bHeadless = !m_glfwInit.IsInitialized() || (GetMainWindow() == nullptr);
+	}
 
-	m_pRenderer = static_cast<IRenderer*>(pPlugin);
+	m_plugins.FreePlugin(DLLType::Input);
 
-	pPlugin = m_plugins.LoadPlugin("input");
+	IPlugin* pPlugin = m_plugins.LoadPlugin(m_inputPlugin);
 	assert(pPlugin->GetPluginType() == DLLType::Input); // check to make sure the input is actually the input plugin
 
 	m_pInput = static_cast<IInput*>(pPlugin);
 }
 
+void Game::SetFrameRateLimit(double fFocused, double fUnfocused, double fIconified)
+{
+	m_fFocusedFPS = fFocused;
+	m_fUnfocusedFPS = fUnfocused;
+
+	// Nothing is drawn while iconified, without a cap the loop would only poll events as fast as it can
+	m_fIconifiedFPS = (fIconified > 0.0) ? fIconified : 10.0;
+}
+
+const FramePacing& Game::GetFramePacing() const
+{
+	return m_limiter.GetPacing();
+}
+
+FrameStats& Game::GetFrameStats()
+{
+	return m_frameStats;
+}
+
+void Game::DumpFrameStatsOnExit(const std::string& file)
+{
+	m_frameStatsFile = file;
+}
+
+bool Game::RecordInput(const std::string& file)
+{
+	unsigned int uiSeed = std::random_device()();
+
+	if (!m_pInput->BeginRecording(file, uiSeed))
+	{
+		Log::Instance().Write("Failed to record the input to " + file);
+		return false;
+	}
+
+	RandomGenerator::Instance().Seed(uiSeed);
+
+	Log::Instance().Write("Recording the input to " + file);
+
+	return true;
+}
+
+bool Game::ReplayInput(const std::string& file)
+{
+	unsigned int uiSeed = 0;
+
+	if (!m_pInput->BeginReplay(file, uiSeed))
+	{
+		Log::Instance().Write("Failed to replay the input of " + file);
+		return false;
+	}
+
+	RandomGenerator::Instance().Seed(uiSeed);
+	EnableEventWaiting(false);
+
+	Log::Instance().Write("Replaying the input of " + file);
+
+	return true;
+}
+
+double Game::GetFrameRateLimit() const
+{
+	if (m_pRenderer->IsIconified())
+		return m_fIconifiedFPS;
+
+	if (m_bHeadless)
+		return m_fFocusedFPS;
+
+	return glfwGetWindowAttrib(GetMainWindow(), GLFW_FOCUSED) ? m_fFocusedFPS : m_fUnfocusedFPS;
+}
+
 IRenderer& Game::GetRenderer()
 {
 	return *m_pRenderer;
@@ -92,6 +298,11 @@ PluginManager& Game::GetPM()
 	return m_plugins;
 }
 
+JobSystem& Game::GetJobs()
+{
+	return m_jobs;
+}
+
 double Game::GetDt() const
 {
 	return m_fDT;
@@ -103,24 +314,93 @@ int Game::Run()
 	Timer theTimer;
 	theTimer.Start();
 
+	// The time between the frames before and after the window was iconified is not a frame time
+	bool bSkipFrameTime = true;
+
+	unsigned int uiFrames = 0;
+
 	// Loop while the user has not quit
-	while(!glfwWindowShouldClose(glfwGetCurrentContext()))
+	while(!m_bQuit && (m_bHeadless || !glfwWindowShouldClose(GetMainWindow())))
 	{
+		{
+			PROFILE_SCOPE("Wait");
+
+			// Wait until the frame is due
+			m_limiter.SetTargetFPS(GetFrameRateLimit());
+			m_limiter.Wait();
+
+			if (!m_pRenderer->IsIconified())
+			{
+				// Wait for the GPU before sampling input, so that queued frames do not add input latency
+				m_pRenderer->WaitForFrames();
+
+				if (m_bLowLatency)
+				{
+					DelayInput(theTimer.GetTime() - fOldTime);
+				}
+			}
+		}
+
 		double t = theTimer.GetTime();
-		m_fDT = t - fOldTime;
+		m_fFrameDT = t - fOldTime;
+		m_fDT = (m_fFixedStep > 0.0) ? m_fFixedStep : m_fFrameDT;
 		fOldTime = t;
 
+		// Work handed to the main thread by jobs, ex: uploading resources loaded in the background
+		{
+			PROFILE_SCOPE("Main thread jobs");
+			m_jobs.RunMainThreadJobs();
+		}
+
 		if (!m_pRenderer->IsIconified())
 		{
+			if (!bSkipFrameTime)
+			{
+				m_frameStats.AddFrame(m_fFrameDT);
+			}
+
+			bSkipFrameTime = false;
+
 			// Update the game
-			Update();
+			{
+				PROFILE_SCOPE("Update");
+
+				if (m_pInput->IsReplaying())
+				{
+					// The recording already holds the updates of each frame, one is replayed per frame
+					Update();
+
+					if ((m_fFixedStep > 0.0) && m_StateMachine.HasState())
+					{
+						m_fAlpha = 0.0;
+						m_StateMachine.GetState().Interpolate(*this, m_fAlpha);
+					}
+				}
+				else if (m_fFixedStep > 0.0)
+				{
+					FixedUpdate();
+				}
+				else
+				{
+					Update();
+				}
+			}
 
 			// Render the game
 			Draw();
+
+			// Time spent on the CPU to produce the frame, from sampling input to presenting
+			m_fWorkTime += (theTimer.GetTime() - t - m_fWorkTime) * 0.1;
+
+			++uiFrames;
+			if (((m_uiMaxFrames > 0) && (uiFrames >= m_uiMaxFrames)) || ((m_fMaxTime > 0.0) && (t >= m_fMaxTime)))
+			{
+				Quit();
+			}
 		}
 		else
 		{
-			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			bSkipFrameTime = true;
 			ProccessInput();
 		}
 	}
@@ -128,12 +408,59 @@ int Game::Run()
 	return 0;
 }
 
-void Game::Update()
+void Game::FixedUpdate()
 {
-	ProccessInput();
+	m_fAccumulator += m_fFrameDT;
+
+	// Drop the time that cannot be caught up, else each slow frame would need more updates than the last one
+	m_fAccumulator = std::min(m_fAccumulator, m_fFixedStep * m_uiMaxSteps);
+
+	// Window events are processed once per frame, even if no update is due
+	// The input is only reset once an update has seen it, so that a frame without update does not drop it
+	if (m_bInputConsumed)
+	{
+		m_pInput->Poll();
+		m_bInputConsumed = false;
+	}
+
+	(*m_pProccessEvents)();
+
+	// A pending state change is applied right away, so that a state never gets drawn before its first update
+	for (unsigned int i = 0; (i < m_uiMaxSteps) && ((m_fAccumulator >= m_fFixedStep) || IsStateChangeReady()); ++i)
+	{
+		// The extra updates only reset the input of the previous update, so that a press is seen by a single update
+		if (i > 0)
+		{
+			m_pInput->Poll();
+		}
+
+		Update(false);
+		m_bInputConsumed = true;
+
+		m_fAccumulator = std::max(0.0, m_fAccumulator - m_fFixedStep);
+	}
+
+	m_fAlpha = m_fAccumulator / m_fFixedStep;
+
+	if (m_StateMachine.HasState())
+	{
+		m_StateMachine.GetState().Interpolate(*this, m_fAlpha);
+	}
+}
+
+void Game::Update(bool bProcessInput)
+{
+	if (bProcessInput)
+	{
+		ProccessInput();
+	}
+
+	// Record the input, or replace it and the time step with the recorded ones
+	bool bReplaying = m_pInput->IsReplaying();
+	m_pInput->EndFrame(m_fDT);
 
 	// If There has been a state change,
-	if(!m_NextState.empty())
+	if(IsStateChangeReady())
 	{
 		// switch states
 		m_StateMachine.SetState(m_NextState,*this);
@@ -142,6 +469,14 @@ void Game::Update()
 		m_NextState.clear();
 	}
 
+	// The state change is applied first, so that a replay ending before the first update still leaves a state to draw
+	if (bReplaying && !m_pInput->IsReplaying())
+	{
+		Log::Instance().Write("Replay complete");
+		Quit();
+		return;
+	}
+
 	if (m_pInput->KeyPress(KEY_ESCAPE))
 	{
 		if (m_StateMachine.HasState())
@@ -167,9 +502,18 @@ void Game::Update()
 		m_bDrawFPS = !m_bDrawFPS;
 	}
 
-	if (m_bDrawFPS)
+	if (m_pInput->KeyPress(KEY_F11))
 	{
-		UpdateFPS();
+		m_pRenderer->SetFullscreen(!m_pRenderer->IsFullscreen());
+	}
+
+	// Capture the next frames so that they can be replayed offline by the RenderReplay benchmark
+	if (m_pInput->KeyPress(KEY_F12) && !m_pRenderer->IsCapturing())
+	{
+		if (m_pRenderer->BeginCapture("capture.rcap", 60))
+		{
+			Log::Instance().Write("Capturing 60 frames to capture.rcap");
+		}
 	}
 
 	m_StateMachine.GetState().Update(*this);
@@ -178,7 +522,7 @@ void Game::Update()
 
 void Game::UpdateFPS()
 {
-	m_fTimeElapsed += m_fDT;
+	m_fTimeElapsed += m_fFrameDT;
 	++m_uiFrameCounter;
 
 	if (m_fTimeElapsed > 0.99)
@@ -186,7 +530,45 @@ void Game::UpdateFPS()
 		m_uiFPS = m_uiFrameCounter;
 		m_uiFrameCounter = 0;
 		m_fTimeElapsed = 0;
+
+		BuildOverlayText();
+	}
+	else if (m_overlayText[0].empty())
+	{
+		BuildOverlayText();
+	}
+}
+
+void Game::BuildOverlayText()
+{
+	const FramePacing& pacing = m_limiter.GetPacing();
+
+	std::stringstream stream;
+	stream << "FPS: " << m_uiFPS << std::fixed << std::setprecision(2) << " Frame: " << pacing.meanInterval * 1000.0
+		   << "ms Jitter: " << pacing.jitter * 1000.0 << "ms Max: " << pacing.maxDeviation * 1000.0 << "ms";
+	m_overlayText[0] = stream.str();
+
+	// Statistics of the last frame presented
+	const RenderStats& stats = m_pRenderer->GetStats();
+
+	stream.str("");
+	stream << "Draws: " << stats.drawCalls << " Instances: " << stats.instances << " Binds: " << stats.stateChanges + stats.textureBinds
+		   << " Upload: " << stats.bytesUploaded / 1024 << "KB Present: " << stats.presentTime * 1000.0 << "ms";
+
+	if (stats.resolutionScale < 1.0f)
+	{
+		stream << " Res: " << (int)(stats.resolutionScale * 100.0f) << "% GPU: " << stats.worldGpuTime * 1000.0 << "ms";
 	}
+
+	m_overlayText[1] = stream.str();
+
+	const FrameTimeSummary& summary = m_frameStats.GetSummary();
+
+	stream.str("");
+	stream << "Min: " << summary.min * 1000.0 << " Avg: " << summary.avg * 1000.0 << " p50: " << summary.p50 * 1000.0
+		   << " p95: " << summary.p95 * 1000.0 << " p99: " << summary.p99 * 1000.0 << " Max: " << summary.max * 1000.0
+		   << "ms Hitches: " << summary.hitches << "/" << summary.frames;
+	m_overlayText[2] = stream.str();
 }
 
 void Game::ProccessInput()
@@ -198,25 +580,81 @@ void Game::ProccessInput()
 
 void Game::Draw()
 {
-	m_StateMachine.GetState().Draw(*this);
-
-	if(m_bDrawFPS)
 	{
-		DrawFPS();
+		PROFILE_SCOPE("Draw");
+
+		if (m_StateMachine.HasState())
+		{
+			m_StateMachine.GetState().Draw(*this);
+		}
+
+		if(m_bDrawFPS)
+		{
+			UpdateFPS();
+			DrawFPS();
+		}
 	}
 
+	PROFILE_SCOPE("Present");
 	m_pRenderer->Present();
 }
 
 void Game::DrawFPS()
 {
 	int height;
-
-	std::stringstream stream;
-	stream << "FPS: " << m_uiFPS;
 	m_pRenderer->GetDisplayMode(nullptr,&height);
 
 	m_pRenderer->SetRenderSpace(RenderSpace::Screen);
 
-	m_pRenderer->DrawString(stream.str().c_str(),glm::vec3(0.0f,height,-10.0f));
+	m_pRenderer->DrawString(m_overlayText[0].c_str(),glm::vec3(0.0f,height,-10.0f));
+	m_pRenderer->DrawString(m_overlayText[1].c_str(),glm::vec3(0.0f,height - 50.0f,-10.0f),glm::vec4(1.0f),25.0f);
+	m_pRenderer->DrawString(m_overlayText[2].c_str(),glm::vec3(0.0f,height - 80.0f,-10.0f),glm::vec4(1.0f),25.0f);
+
+	DrawFrameHistogram();
+}
+
+void Game::DrawFrameHistogram()
+{
+	// Bins of the histogram cover frame times up to twice the hitch threshold
+	const unsigned int uiBins = 60;
+	const float fBarWidth = 4.0f;
+	const float fMaxHeight = 100.0f;
+	const glm::vec3 origin(10.0f, 10.0f, -10.0f);
+
+	const double fThreshold = m_frameStats.GetHitchThreshold();
+	const double fBinWidth = 2.0 * fThreshold / uiBins;
+
+	m_frameStats.GetHistogram(fBinWidth, uiBins, m_histogram);
+
+	unsigned int uiMaxCount = *std::max_element(m_histogram.begin(), m_histogram.end());
+
+	if (uiMaxCount == 0)
+		return;
+
+	for (unsigned int i = 0; i < uiBins; ++i)
+	{
+		if (m_histogram[i] == 0)
+			continue;
+
+		float x = origin.x + (i + 0.5f) * fBarWidth;
+		glm::vec3 bar[2] =
+		{
+			glm::vec3(x, origin.y, origin.z),
+			glm::vec3(x, origin.y + fMaxHeight * m_histogram[i] / uiMaxCount, origin.z)
+		};
+
+		// Hitches are drawn in red
+		glm::vec4 color = ((i * fBinWidth) >= fThreshold) ? glm::vec4(1.0f, 0.0f, 0.0f, 1.0f) : glm::vec4(0.0f, 1.0f, 0.0f, 1.0f);
+		m_pRenderer->DrawLine(bar, 2, fBarWidth, color);
+	}
+
+	// Marker at the 99th percentile
+	float p99 = origin.x + (float)std::min(m_frameStats.GetSummary().p99 / fBinWidth, (double)uiBins) * fBarWidth;
+	glm::vec3 marker[2] =
+	{
+		glm::vec3(p99, origin.y, origin.z),
+		glm::vec3(p99, origin.y + fMaxHeight + 10.0f, origin.z)
+	};
+
+	m_pRenderer->DrawLine(marker, 2, 2.0f, glm::vec4(1.0f, 1.0f, 0.0f, 1.0f));
 }
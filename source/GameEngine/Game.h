@@ -8,6 +8,9 @@
 #include "GLFWInit.h"
 #include "IInput.h"
 #include "IRenderer.h"
+#include "JobSystem.h"
+#include "FrameLimiter.h"
+#include "FrameStats.h"
 
 #ifdef _WIN32
 #ifdef GAME_ENGINE_EXPORT
@@ -29,24 +32,79 @@ class Game
 public:
 
 	// Init GLFW, load dlls, load the base resource file
-	GAME_ENGINE_API Game();
+	// renderer and input are the plugin files loaded, without the extension
+	GAME_ENGINE_API Game(const std::string& renderer = "renderer", const std::string& input = "input");
 	GAME_ENGINE_API ~Game();
 
 	// Get the current state
 	GAME_ENGINE_API std::string GetCurrentStateName() const;
 
 	// Change the current state
+	// If the state is being preloaded, the current state keeps running until the preload completes
 	GAME_ENGINE_API void SetNextState(const std::string& state);
 
+	// Loads the plugin and reads the resources of a state in the background while the current state keeps running
+	// Switching to the state with SetNextState() then avoids most of the freeze of loading it
+	GAME_ENGINE_API void PreloadState(const std::string& state);
+
+	// Returns the progress of the preload in [0, 1], 1 if nothing is being preloaded
+	GAME_ENGINE_API float GetPreloadProgress() const;
+
+	// Keeps up to uiMaxStates states and their resources in memory after switching away from them, so that switching back is immediate
+	// The least recently used states are destroyed once their textures use more than uiMaxBytes
+	// The limits apply from the next state change, uiMaxStates = 0 destroys each state when leaving it. By default 2 states and 256 MB
+	GAME_ENGINE_API void SetResidentStates(unsigned int uiMaxStates, unsigned int uiMaxBytes);
+
 	// Enables waiting for events if bEnable is true. This means that the game loop will be put to sleep until there is user input
 	// If bEnable is false, the game loop will not wait for user input, which is the default state
 	GAME_ENGINE_API void EnableEventWaiting(bool bEnable);
 
+	// Enables the low latency mode if bEnable is true
+	// Only one frame is queued on the GPU and, with vsync, input is sampled as late as possible before the frame is drawn
+	// Disabling it restores the frames in flight limit that was set before it was enabled
+	GAME_ENGINE_API void EnableLowLatency(bool bEnable);
+
+	// Runs IGameState::Update() every fStep seconds, independently of the frame rate, fStep = 0 updates once per frame, which is the default
+	// Each frame runs as many updates as needed to catch up, but no more than uiMaxSteps, the time left over is dropped so that
+	// a slow update cannot make the next frame even slower. IGameState::Interpolate() gets called before each Draw()
+	GAME_ENGINE_API void SetFixedTimestep(double fStep, unsigned int uiMaxSteps = 5);
+
+	// Returns how far the current frame is between the last update and the next one, always 0 unless the timestep is fixed
+	GAME_ENGINE_API double GetInterpolation() const;
+
+	// Caps the frame rate while the window is focused, unfocused or iconified, a cap <= 0 removes it
+	// Frames are paced by sleeping for most of the wait, so a cap lowers the CPU usage, unlike vsync
+	// There is no cap by default, except while iconified where the game runs at 10 frames per second, which is also used if fIconified <= 0
+	GAME_ENGINE_API void SetFrameRateLimit(double fFocused, double fUnfocused, double fIconified = 10.0);
+
+	// Returns the pacing of the frames measured over the last second
+	GAME_ENGINE_API const FramePacing& GetFramePacing() const;
+
+	// Frame times of the frames drawn, the F6 overlay shows their percentiles and histogram
+	GAME_ENGINE_API FrameStats& GetFrameStats();
+
+	// Writes the frame time statistics of the session to file when the game exits, an empty string disables it
+	GAME_ENGINE_API void DumpFrameStatsOnExit(const std::string& file);
+
+	// Records the input and the time step of every update to file, along with the seed of the RandomGenerator
+	// Must be called before Run(), returns false if the file cannot be created
+	GAME_ENGINE_API bool RecordInput(const std::string& file);
+
+	// Replays a recording made with RecordInput(), each frame runs a single update with the recorded input and time step
+	// The game quits once the recording ends, so that benchmarks can be repeated with the same input
+	// Must be called before Run(), returns false if the file is not a recording
+	GAME_ENGINE_API bool ReplayInput(const std::string& file);
+
+	// Quits after uiFrames frames have been drawn or fSeconds seconds since Run(), whichever comes first, 0 disables a limit
+	// Event waiting is disabled while there is a limit, so that the game never sleeps on input that will not come
+	GAME_ENGINE_API void SetRunLimit(unsigned int uiFrames, double fSeconds);
+
 	// Quit the game during the beginning of the next frame
 	GAME_ENGINE_API void Quit() const;
 
 	// Reload component plugins
-	// todo: should add a feature that allows the user to select which plugin is loaded
+	// The renderer is only loaded once, so its window and resources are kept across reloads
+	// The plugin files are the ones passed to the constructor
 	GAME_ENGINE_API void LoadPlugins();
 
 	// Get Functions
@@ -55,7 +113,11 @@ public:
 	GAME_ENGINE_API IInput& GetInput();
 	GAME_ENGINE_API PluginManager& GetPM();
 
-	// time differential between frames in seconds
+	// Job system shared by the engine and the plugins
+	// Jobs queued with JobSystem::RunOnMainThread() run at the beginning of each frame, before the update
+	GAME_ENGINE_API JobSystem& GetJobs();
+
+	// time differential between updates in seconds, this is the fixed timestep if there is one
 	GAME_ENGINE_API double GetDt() const;
 
 private:
@@ -64,9 +126,13 @@ private:
 
 	PluginManager m_plugins;
 
+	// Declared after the plugins so that queued jobs finish before the plugins are unloaded
+	JobSystem m_jobs;
+
 	GameStateMachine m_StateMachine;
 
 	double m_fDT;
+	double m_fFrameDT; // time between frames, differs from m_fDT when the timestep is fixed
 	double m_fTimeElapsed;
 	unsigned int m_uiFrameCounter;
 	unsigned int m_uiFPS;
@@ -74,11 +140,49 @@ private:
 	// Component Interfaces
 	IRenderer* m_pRenderer;
 	IInput* m_pInput;
+	std::string m_rendererPlugin;
+	std::string m_inputPlugin;
+
+	// true if the renderer did not create a window, there are then no window events to process
+	bool m_bHeadless;
+
+	// Set by Quit()
+	mutable bool m_bQuit;
 
 	std::string m_NextState;
 
 	bool m_bDrawFPS;
 
+	// Text of the F6 overlay, rebuilt once per second
+	std::string m_overlayText[3];
+
+	FrameStats m_frameStats;
+	std::string m_frameStatsFile;
+	std::vector<unsigned int> m_histogram;
+
+	// Low latency mode, see EnableLowLatency()
+	bool m_bLowLatency;
+	unsigned int m_uiSavedFramesInFlight; // limit of the renderer before low latency mode was enabled
+	double m_fWorkTime; // average time taken by Update() and Draw()
+	double m_fFrameInterval; // average time between frames while vsync is enabled
+
+	// Fixed timestep, see SetFixedTimestep()
+	double m_fFixedStep;
+	unsigned int m_uiMaxSteps;
+	double m_fAccumulator; // simulation time not yet updated
+	double m_fAlpha;
+	bool m_bInputConsumed; // true once an update has seen the input, which can then be reset
+
+	// Frame rate caps, see SetFrameRateLimit()
+	FrameLimiter m_limiter;
+	double m_fFocusedFPS;
+	double m_fUnfocusedFPS;
+	double m_fIconifiedFPS;
+
+	// Run limits, see SetRunLimit()
+	unsigned int m_uiMaxFrames;
+	double m_fMaxTime;
+
 	void (*m_pProccessEvents)(void);
 
 private:
@@ -88,14 +192,32 @@ private:
 	GAME_ENGINE_API int Run();
 	friend int main(int n, char**);
 
-	void Update();
+	// Returns true if the state changes during the next update
+	bool IsStateChangeReady() const;
+
+	// Runs a single update of the game, bProcessInput is false if the caller already processed the input of the update
+	void Update(bool bProcessInput = true);
 	void UpdateFPS();
+	void BuildOverlayText();
+
+	// Runs the updates due this frame at the fixed timestep
+	void FixedUpdate();
 
 	void ProccessInput();
 
+	// Returns the frame rate cap that applies to the current state of the window
+	double GetFrameRateLimit() const;
+
+	// Sleeps so that input gets sampled just in time to finish the frame before the next refresh
+	// fElapsed: time since input was last sampled
+	void DelayInput(double fElapsed);
+
 	void Draw();
 	void DrawFPS();
 
+	// Draws the histogram of the frame times of the rolling window with the line renderer
+	void DrawFrameHistogram();
+
 	// Prevent copying
 	Game(const Game&) = delete;
 	Game& operator =(const Game&) = delete;
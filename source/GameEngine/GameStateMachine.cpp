@@ -1,38 +1,236 @@
 #include "Game.h"
 #include "Log.h"
 #include "ResourceFileLoader.h"
+#include "MainWindow.h"
 #include <GLFW/glfw3.h>
+#include <algorithm>
 
 using namespace std;
 
-GameStateMachine::GameStateMachine() : m_pCurrentState(nullptr) {}
+GameStateMachine::GameStateMachine() : m_pCurrentState(nullptr), m_uiMaxResident(2), m_uiMaxResidentBytes(256 * 1024 * 1024) {}
 
 void GameStateMachine::SetState(const std::string& state, Game& game)
 {
-	RemoveState(game);
+	FinishPreload(game);
+	SuspendState(game);
 
-	IPlugin* pPlugin = game.GetPM().LoadPlugin("./plugin/" + state + '/' + state);
-	assert(pPlugin->GetPluginType() == DLLType::Game);
+	IResourceManager& rm = game.GetRenderer().GetResourceManager();
 
-	LoadResourceFile(string(pPlugin->GetName()) + ".r",game,"./plugin/" + string(pPlugin->GetName()));
+	auto iter = find_if(m_resident.begin(), m_resident.end(), [&state](const ResidentState& resident)
+	{
+		return resident.name == state;
+	});
+
+	if(iter != m_resident.end())
+	{
+		game.GetPM().AttachPlugin(iter->plugin);
+		m_pCurrentState = iter->pState;
+		m_currentName = state;
+		m_resident.erase(iter);
+
+		rm.SetScope(m_pCurrentState->GetName());
+		m_pCurrentState->Resume(game);
+
+		Log::Instance().Write("Resuming state: " + state);
+	}
+	else
+	{
+		IPlugin* pPlugin = game.GetPM().LoadPlugin("./plugin/" + state + '/' + state);
+		assert(pPlugin->GetPluginType() == DLLType::Game);
+
+		// Resources loaded by the state are released along with the state
+		rm.SetScope(pPlugin->GetName());
+
+		LoadResourceFile(string(pPlugin->GetName()) + ".r",game,"./plugin/" + string(pPlugin->GetName()));
+
+		m_pCurrentState = static_cast<IGameState*>(pPlugin);
+		m_currentName = state;
+		m_pCurrentState->Init(game);
 
-	m_pCurrentState = static_cast<IGameState*>(pPlugin);
-	m_pCurrentState->Init(game);
+		// Update change to log
+		Log::Instance().Write("Changing state to: " + state);
+	}
 
-	// Update change to log
-	Log::Instance().Write("Changing state to: " + state);
+	// update window caption, there is no window when running headless
+	GLFWwindow* pWindow = GetMainWindow();
+	if (pWindow != nullptr)
+	{
+		glfwSetWindowTitle(pWindow, state.c_str());
+	}
 
-	// update window caption
-	glfwSetWindowTitle(glfwGetCurrentContext(),state.c_str());
+	// What was preloaded and not used by the state is not needed anymore
+	game.GetPM().ReleasePrefetched();
+	rm.ClearPrefetched();
 
 }
 
 void GameStateMachine::RemoveState(Game& game)
+{
+	FinishPreload(game);
+	DestroyState(game);
+
+	unsigned int uiMaxResident = m_uiMaxResident;
+	m_uiMaxResident = 0;
+
+	EnforceResidentLimit(game);
+
+	m_uiMaxResident = uiMaxResident;
+}
+
+void GameStateMachine::SetResidentLimit(unsigned int uiMaxStates, unsigned int uiMaxBytes)
+{
+	m_uiMaxResident = uiMaxStates;
+	m_uiMaxResidentBytes = uiMaxBytes;
+}
+
+bool GameStateMachine::IsResident(const std::string& state) const
+{
+	return find_if(m_resident.begin(), m_resident.end(), [&state](const ResidentState& resident)
+	{
+		return resident.name == state;
+	}) != m_resident.end();
+}
+
+void GameStateMachine::SuspendState(Game& game)
+{
+	if(m_pCurrentState == nullptr)
+		return;
+
+	if(m_uiMaxResident == 0)
+	{
+		DestroyState(game);
+		return;
+	}
+
+	m_pCurrentState->Suspend(game);
+
+	// The resources stay referenced by the scope of the state
+	ResidentState resident = { m_currentName, game.GetPM().DetachPlugin(DLLType::Game), m_pCurrentState };
+	m_resident.push_front(resident);
+
+	m_pCurrentState = nullptr;
+	m_currentName.clear();
+
+	game.GetRenderer().GetResourceManager().SetScope("");
+
+	EnforceResidentLimit(game);
+}
+
+void GameStateMachine::DestroyState(Game& game)
 {
 	if(m_pCurrentState != nullptr)
 	{
+		string scope = m_pCurrentState->GetName();
+
 		m_pCurrentState->Destroy(game);
 		m_pCurrentState = nullptr;
+		m_currentName.clear();
 		game.GetPM().FreePlugin(DLLType::Game);
+
+		// Shared resources stay loaded, the rest are evicted once the texture budget is exceeded
+		IResourceManager& rm = game.GetRenderer().GetResourceManager();
+		rm.ReleaseScope(scope);
+		rm.SetScope("");
+	}
+}
+
+void GameStateMachine::EnforceResidentLimit(Game& game)
+{
+	IResourceManager& rm = game.GetRenderer().GetResourceManager();
+
+	while(!m_resident.empty())
+	{
+		unsigned int uiBytes = 0;
+		for(const ResidentState& resident : m_resident)
+		{
+			uiBytes += rm.GetScopeMemory(resident.pState->GetName());
+		}
+
+		if((m_resident.size() <= m_uiMaxResident) && (uiBytes <= m_uiMaxResidentBytes))
+			break;
+
+		ResidentState& evicted = m_resident.back();
+		string scope = evicted.pState->GetName();
+
+		Log::Instance().Write("Evicting resident state: " + evicted.name);
+
+		evicted.pState->Destroy(game);
+		m_resident.pop_back();
+
+		rm.ReleaseScope(scope);
+	}
+}
+
+void GameStateMachine::Preload(const std::string& state, Game& game)
+{
+	// Resident states are already loaded
+	if(((m_pPreload != nullptr) && (m_pPreload->state == state)) || IsResident(state))
+		return;
+
+	FinishPreload(game);
+
+	m_pPreload.reset(new PreloadStatus());
+	m_pPreload->state = state;
+	m_pPreload->uiDone = 0;
+	m_pPreload->uiTotal = 2;
+
+	Log::Instance().Write("Preloading: " + state);
+
+	// The jobs only use objects that outlive the preload, see FinishPreload()
+	PreloadStatus* pStatus = m_pPreload.get();
+	PluginManager* pPM = &game.GetPM();
+	IResourceManager* pRM = &game.GetRenderer().GetResourceManager();
+	JobSystem* pJobs = &game.GetJobs();
+	string folder = "./plugin/" + state;
+
+	pJobs->Run([pStatus, pPM, folder, state]
+	{
+		// Errors are reported by LoadPlugin() when the state is set
+		string error;
+		pPM->Prefetch(folder + '/' + state, error);
+
+		pStatus->uiDone++;
+	}, &pStatus->counter);
+
+	pJobs->Run([pStatus, pRM, pJobs, folder, state]
+	{
+		auto pEntries = make_shared<vector<ResourceFileEntry>>();
+		ReadResourceFile(state + ".r", folder, *pEntries);
+
+		pStatus->uiTotal += (unsigned int)pEntries->size();
+
+		// Each file is decoded by its own job, errors are reported by LoadResourceFile() when the state is set
+		for(size_t i = 0; i < pEntries->size(); ++i)
+		{
+			pJobs->Run([pStatus, pRM, pEntries, i]
+			{
+				PrefetchResource((*pEntries)[i], *pRM);
+				pStatus->uiDone++;
+			}, &pStatus->counter);
+		}
+
+		pStatus->uiDone++;
+	}, &pStatus->counter);
+}
+
+bool GameStateMachine::IsPreloading(const std::string& state) const
+{
+	return (m_pPreload != nullptr) && (m_pPreload->state == state) && !m_pPreload->counter.IsDone();
+}
+
+float GameStateMachine::GetPreloadProgress() const
+{
+	if((m_pPreload == nullptr) || m_pPreload->counter.IsDone())
+		return 1.0f;
+
+	return (float)m_pPreload->uiDone / (float)m_pPreload->uiTotal;
+}
+
+void GameStateMachine::FinishPreload(Game& game)
+{
+	if(m_pPreload != nullptr)
+	{
+		game.GetJobs().Wait(m_pPreload->counter);
+		m_pPreload.reset();
 	}
 }
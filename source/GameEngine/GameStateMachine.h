@@ -4,6 +4,11 @@
 #define _GAMESTATEMACHINE_
 
 #include "IGameState.h"
+#include "JobSystem.h"
+#include <atomic>
+#include <list>
+#include <memory>
+#include <string>
 
 // Manages setting and removing the current state
 class GameStateMachine
@@ -13,12 +18,31 @@ public:
 	GameStateMachine();
 
 	// Removes current state if there is one
-	// And then initializes the new state
+	// And then resumes the state if it is resident, or initializes it
 	void SetState(const std::string& state, class Game&);
 
-	// Unloads the old state
+	// Unloads the current state and the resident states
 	void RemoveState(class Game&);
 
+	// Keeps up to uiMaxStates states resident after switching away from them, along with their resources
+	// Switching back to a resident state resumes it instead of loading it again
+	// The least recently used states are destroyed once there are more than uiMaxStates, or once their textures use more than uiMaxBytes
+	// uiMaxStates = 0 destroys a state as soon as the game switches to another one, the limits are enforced during the next state change
+	void SetResidentLimit(unsigned int uiMaxStates, unsigned int uiMaxBytes);
+
+	// Returns true if the state is suspended and resident
+	bool IsResident(const std::string& state) const;
+
+	// Loads the library of the state and reads its resource files with the job system, while the current state keeps running
+	// SetState() then only has to create the state and the GPU objects of its resources
+	void Preload(const std::string& state, class Game&);
+
+	// Returns true while the state is being preloaded
+	bool IsPreloading(const std::string& state) const;
+
+	// Returns the progress of the preload in [0, 1], 1 if nothing is being preloaded
+	float GetPreloadProgress() const;
+
 	bool HasState() const { return m_pCurrentState != nullptr; }
 
 	IGameState& GetState() { return *m_pCurrentState; }
@@ -27,6 +51,41 @@ public:
 private:
 
 	IGameState* m_pCurrentState;
+	std::string m_currentName; // name given to SetState()
+
+	struct ResidentState
+	{
+		std::string name;
+		std::shared_ptr<struct PluginInfo> plugin; // keeps the plugin loaded
+		IGameState* pState;
+	};
+
+	// Suspended states, most recently used first
+	std::list<ResidentState> m_resident;
+	unsigned int m_uiMaxResident;
+	unsigned int m_uiMaxResidentBytes;
+
+	struct PreloadStatus
+	{
+		std::string state;
+		JobCounter counter;
+		std::atomic<unsigned int> uiDone; // steps completed
+		std::atomic<unsigned int> uiTotal; // grows once the resource file has been read
+	};
+
+	std::unique_ptr<PreloadStatus> m_pPreload;
+
+	// Waits for the preload to complete
+	void FinishPreload(class Game&);
+
+	// Keeps the current state resident, or destroys it if no state can be resident
+	void SuspendState(class Game&);
+
+	// Destroys the current state
+	void DestroyState(class Game&);
+
+	// Destroys the least recently used resident states until the limits are respected
+	void EnforceResidentLimit(class Game&);
 
 };
 
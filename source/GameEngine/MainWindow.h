@@ -0,0 +1,19 @@
+#ifndef _MAINWINDOW_
+#define _MAINWINDOW_
+
+#include <GLFW/glfw3.h>
+
+// Returns the window of the game, null when running headless
+// The context of the window is current on the main thread unless the renderer presents on its own thread,
+// the main thread then uses a hidden context whose user pointer is the window
+inline GLFWwindow* GetMainWindow()
+{
+	GLFWwindow* pContext = glfwGetCurrentContext();
+	if (pContext == nullptr)
+		return nullptr;
+
+	GLFWwindow* pWindow = static_cast<GLFWwindow*>(glfwGetWindowUserPointer(pContext));
+	return (pWindow != nullptr) ? pWindow : pContext;
+}
+
+#endif // _MAINWINDOW_
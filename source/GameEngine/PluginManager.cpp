@@ -61,6 +61,11 @@ PluginManager::PluginManager()
 {
 }
 
+PluginManager::~PluginManager()
+{
+	ReleasePrefetched();
+}
+
 const IPlugin* PluginManager::GetPlugin(DLLType type) const
 {
 	plugin_type::const_iterator iter = m_plugins.find(type);
@@ -92,21 +97,11 @@ IPlugin* PluginManager::LoadPlugin(std::string file)
 	Log::Instance().Write("Loading " + StripFile(file));
 	file += ".plug";
 
-#if defined(_WIN32)
-	dll->mod = LoadLibrary(file.c_str());
-#else
-	dll->mod = dlopen(file.c_str(),RTLD_NOW);
-#endif
+	dll->mod = LoadLibraryFile(file);
 
 	if(dll->mod == nullptr)
 	{
-		std::string error;
-#ifdef _WIN32
-		error = GetLastErrorAsString();
-#else
-		error = dlerror();
-#endif
-		throw error;
+		throw GetLibraryError();
 	}
 
 	CREATEPLUGIN pFunct = nullptr;
@@ -155,6 +150,86 @@ void PluginManager::FreeAllPlugins()
 	m_plugins.clear();
 }
 
+std::shared_ptr<PluginInfo> PluginManager::DetachPlugin(DLLType type)
+{
+	std::shared_ptr<PluginInfo> plugin;
+
+	auto iter = m_plugins.find(type);
+	if(iter != m_plugins.end())
+	{
+		plugin = iter->second;
+		m_plugins.erase(iter);
+	}
+
+	return plugin;
+}
+
+IPlugin* PluginManager::AttachPlugin(const std::shared_ptr<PluginInfo>& plugin)
+{
+	m_plugins[plugin->pPlugin->GetPluginType()] = plugin;
+
+	return plugin->pPlugin;
+}
+
+bool PluginManager::Prefetch(std::string file, std::string& error)
+{
+	file += ".plug";
+
+	void* mod = LoadLibraryFile(file);
+
+	if(mod == nullptr)
+	{
+		error = GetLibraryError();
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_prefetchMutex);
+	m_prefetched.push_back(mod);
+
+	return true;
+}
+
+void PluginManager::ReleasePrefetched()
+{
+	std::lock_guard<std::mutex> lock(m_prefetchMutex);
+
+	// Libraries are reference counted, so the libraries of the plugins that were loaded since stay loaded
+	for(void* mod : m_prefetched)
+	{
+		FreeLibraryFile(mod);
+	}
+
+	m_prefetched.clear();
+}
+
+void* PluginManager::LoadLibraryFile(const std::string& file)
+{
+#if defined(_WIN32)
+	return LoadLibrary(file.c_str());
+#else
+	return dlopen(file.c_str(),RTLD_NOW);
+#endif
+}
+
+std::string PluginManager::GetLibraryError()
+{
+#ifdef _WIN32
+	return GetLastErrorAsString();
+#else
+	const char* error = dlerror();
+	return (error != nullptr) ? error : "Unknown error";
+#endif
+}
+
+void PluginManager::FreeLibraryFile(void* mod)
+{
+#ifdef _WIN32
+	FreeLibrary((HMODULE)mod);
+#else
+	dlclose(mod);
+#endif
+}
+
 std::string PluginManager::StripFile(std::string file) const
 {
 	std::string strippedFileName;
@@ -16,6 +16,8 @@
 #include "IPlugin.h"
 #include <map>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 /*
    The PluginManager manages all plugins. It will load and unload them when needed.
@@ -25,6 +27,7 @@ class PluginManager
 public:
 
 	PluginManager();
+	~PluginManager();
 	PluginManager(const PluginManager&) = delete;
 	PluginManager& operator=(const PluginManager&) = delete;
 
@@ -46,11 +49,38 @@ public:
 	// removes all plugins loaded
 	void FreeAllPlugins();
 
+	// Removes the plugin of the type from the manager without unloading it, the handle keeps the plugin and its library alive
+	// Returns a null handle if there is no plugin of the type
+	std::shared_ptr<struct PluginInfo> DetachPlugin(DLLType type);
+
+	// Gives a plugin detached by DetachPlugin() back to the manager, the plugin of the same type is freed
+	// Returns the plugin interface
+	IPlugin* AttachPlugin(const std::shared_ptr<struct PluginInfo>& plugin);
+
+	// Loads the shared library of a plugin without creating the plugin, can be called from any thread
+	// The next LoadPlugin() of the file then finds the library already loaded, file has no extension like in LoadPlugin()
+	// Returns false on error, in which case error is set to the error message
+	bool Prefetch(std::string file, std::string& error);
+
+	// Unloads the libraries loaded by Prefetch(), the libraries of loaded plugins stay loaded
+	void ReleasePrefetched();
+
 private:
 
 	typedef std::map<DLLType,std::shared_ptr<struct PluginInfo>> plugin_type;
 	plugin_type m_plugins; // the list of all plugins
 
+	std::mutex m_prefetchMutex;
+	std::vector<void*> m_prefetched; // libraries loaded by Prefetch()
+
+	// Loads a shared library, returns nullptr on error
+	static void* LoadLibraryFile(const std::string& file);
+
+	// Returns the last error of LoadLibraryFile()
+	static std::string GetLibraryError();
+
+	static void FreeLibraryFile(void* mod);
+
 	// Returns the filename without the path to the file
 	std::string StripFile(std::string file) const;
 };
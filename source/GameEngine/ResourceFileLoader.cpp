@@ -8,73 +8,118 @@ void LoadResourceFile(const std::string& file, Game& game, const std::string& fo
 {
 	IResourceManager& gfxResourceManager = game.GetRenderer().GetResourceManager();
 
-	std::ifstream stream;
-	stream.open((folder + '/' + file).c_str());
+	std::vector<ResourceFileEntry> entries;
 
 	// If the resource file does not exist, quit silently
-	if (!stream.is_open())
+	if (!ReadResourceFile(file, folder, entries))
 	{
 		Log::Instance().Write("No resource file found");
 		return;
 	}
 
+	for(const ResourceFileEntry& entry : entries)
+	{
+		const std::string& type = entry.type;
+		const std::string& id = entry.id;
+		const std::string& fileName = entry.file;
+
+		bool bSuccess = true;
+		if(type == "cursor")
+		{
+			bSuccess = gfxResourceManager.LoadCursor(id, fileName);
+		}
+		else if(type == "texture")
+		{
+			bSuccess = gfxResourceManager.LoadTexture(id,fileName);
+		}
+		else if(type == "animation")
+		{
+			bSuccess = gfxResourceManager.LoadAnimation(id,fileName);
+		}
+		else if(type == "font")
+		{
+			bSuccess = gfxResourceManager.LoadFont(id,fileName);
+		}
+		else if(type == "shader")
+		{
+			bSuccess = gfxResourceManager.LoadShader(id,fileName,entry.frag,entry.features);
+		}
+		else if(type == "mesh")
+		{
+			bSuccess = gfxResourceManager.LoadMesh(id,fileName);
+		}
+		else if (type == "sound")
+		{
+
+		}
+
+		if(bSuccess == false)
+		{
+			throw std::string("Error loading resource: " + fileName);
+		}
+	}
+}
+
+bool ReadResourceFile(const std::string& file, const std::string& folder, std::vector<ResourceFileEntry>& out)
+{
+	std::ifstream stream;
+	stream.open((folder + '/' + file).c_str());
+
+	if (!stream.is_open())
+		return false;
+
 	std::string line;
 	while(std::getline(stream,line))
 	{
 		std::stringstream stream(line);
 
-		std::string type;
-		stream >> type;
+		ResourceFileEntry entry;
+		stream >> entry.type;
 
 		// Check if this line is commented out by a single #
-		if(!type.empty() && (type.front() != '#'))
+		if(!entry.type.empty() && (entry.type.front() != '#'))
 		{
-			std::string id;
-			stream >> id;
+			stream >> entry.id;
+			stream >> entry.file;
 
-			std::string fileName;
-			stream >> fileName;
-
-			if(!fileName.empty())
+			if(!entry.file.empty())
 			{
-				fileName = folder + '/' + fileName;
+				entry.file = folder + '/' + entry.file;
 
-				bool bSuccess = true;
-				if(type == "cursor")
-				{
-					bSuccess = gfxResourceManager.LoadCursor(id, fileName);
-				}
-				else if(type == "texture")
+				if(entry.type == "shader")
 				{
-					bSuccess = gfxResourceManager.LoadTexture(id,fileName);
-				}
-				else if(type == "animation")
-				{
-					bSuccess = gfxResourceManager.LoadAnimation(id,fileName);
-				}
-				else if(type == "font")
-				{
-					bSuccess = gfxResourceManager.LoadFont(id,fileName);
-				}
-				else if(type == "shader")
-				{
-					std::string frag;
-					stream >> frag;
-
-					frag = folder + '/' + frag;
+					stream >> entry.frag;
 
-					bSuccess = gfxResourceManager.LoadShader(id,fileName,frag);
-				}
-				else if (type == "sound")
-				{
+					entry.frag = folder + '/' + entry.frag;
 
+					// The rest of the line lists the features of the shader
+					std::string feature;
+					while(stream >> feature)
+					{
+						entry.features.push_back(feature);
+					}
 				}
 
-				if(bSuccess == false)
-				{
-					throw std::string("Error loading resource: " + fileName);
-				}
+				out.push_back(std::move(entry));
 			}
 		}
 	}
+
+	return true;
+}
+
+bool PrefetchResource(const ResourceFileEntry& entry, IResourceManager& rm)
+{
+	const std::string& type = entry.type;
+
+	if((type == "cursor") || (type == "texture") || (type == "animation") || (type == "font"))
+	{
+		return rm.PrefetchImage(entry.file);
+	}
+	else if(type == "mesh")
+	{
+		return rm.PrefetchMesh(entry.file);
+	}
+
+	return true;
 }
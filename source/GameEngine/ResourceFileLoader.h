@@ -2,12 +2,34 @@
 #define _RESOURCEFILELOADER_
 
 #include <string>
+#include <vector>
+
+class IResourceManager;
 
 /** Loads a resource file
 	 * resource file structure:
 	 * texture UniqueStringID PathToImage/img.png
-	 * shader UniqueStringID3 PathToShader/VertexShader.vert PathToShader/FragmentShader.frag
+	 * shader UniqueStringID3 PathToShader/VertexShader.vert PathToShader/FragmentShader.frag [features...]
 	 **/
 void LoadResourceFile(const std::string& file, class Game& ,const std::string& folder = ".");
 
+// A line of a resource file, the paths include the folder of the resource file
+struct ResourceFileEntry
+{
+	std::string type;
+	std::string id;
+	std::string file;
+	std::string frag; // fragment shader, only used by shaders
+	std::vector<std::string> features; // only used by shaders
+};
+
+// Reads the entries of a resource file without loading them, can be called from any thread
+// Returns false if the file does not exist
+bool ReadResourceFile(const std::string& file, const std::string& folder, std::vector<ResourceFileEntry>& out);
+
+// Reads and decodes the file of an entry ahead of time, see IResourceManager::PrefetchImage(), can be called from any thread
+// Entries that only create GPU objects, such as shaders, are skipped
+// Returns false on error
+bool PrefetchResource(const ResourceFileEntry& entry, IResourceManager& rm);
+
 #endif // _RESOURCEFILELOADER_
@@ -14,12 +14,25 @@ public:
 	// Called only once when the plugin is destroyed
 	virtual void Destroy(class Game& game) = 0;
 
+	// Called when the game switches to another state while this state is kept resident, see Game::SetResidentStates()
+	// The state keeps its members and resources. If the state gets evicted later, Destroy() is called during a state change,
+	// before the next state is initialized or resumed
+	virtual void Suspend(class Game& game) {}
+
+	// Called instead of Init() when the game switches back to a resident state
+	virtual void Resume(class Game& game) {}
+
 	// Called every frame to update the state of the game
 	virtual void Update(class Game& game) = 0;
 
 	// Called every frame to render the game
 	virtual void Draw(class Game& game) = 0;
 
+	// Called before Draw() when the game runs at a fixed timestep, see Game::SetFixedTimestep()
+	// fAlpha in [0, 1) is how far the frame is between the last update and the next one,
+	// states that move objects should draw them blended between their previous and current positions
+	virtual void Interpolate(class Game& game, double fAlpha) {}
+
 protected:
 
 	virtual ~IGameState() {}
@@ -237,6 +237,29 @@ public:
 
 	// Returns true if the button is released, else false
 	virtual bool JoystickButtonRelease(int button, bool once = true) const = 0;
+
+	// ----- Recording -----
+
+	// Records the input of every frame to a binary file, along with the time step of each frame and uiSeed
+	// Returns false if the file cannot be created
+	virtual bool BeginRecording(const std::string& file, unsigned int uiSeed) = 0;
+
+	// Replays a recording, the input of each frame comes from the recording instead of the window
+	// The seed of the recording is returned via uiSeed, returns false if the file is not a recording
+	virtual bool BeginReplay(const std::string& file, unsigned int& uiSeed) = 0;
+
+	// Stops recording or replaying
+	virtual void EndRecording() = 0;
+
+	virtual bool IsRecording() const = 0;
+
+	// Returns true while replaying, false once every frame of the recording has been replayed
+	virtual bool IsReplaying() const = 0;
+
+	// Must be called once per frame after the input has been processed, dt is the time step of the frame
+	// While recording, the input of the frame is written with dt
+	// While replaying, the input of the frame is replaced by the recorded input and dt by the recorded time step
+	virtual void EndFrame(double& dt) = 0;
 	
 protected:
 
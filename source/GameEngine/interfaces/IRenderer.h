@@ -7,6 +7,7 @@
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 #include <glm/mat4x4.hpp>
+#include <glm/common.hpp>
 
 enum class FontAlignment
 {
@@ -21,6 +22,60 @@ enum RenderSpace
 	Screen
 };
 
+// Render data of a single particle streamed to the renderer by DrawParticles()
+struct ParticleVertex
+{
+	glm::vec3 pos; // center of the particle
+	float size; // width and height of the particle
+	unsigned int color; // packed RGBA8 color, red is stored in the lowest byte
+};
+
+// Render data of a single sprite submitted to the renderer by DrawSprites()
+struct SpriteInstance
+{
+	glm::mat4 transformation; // transformation applied to the sprite
+	glm::vec4 color; // color that gets blended together with the sprite
+	glm::vec2 tiling; // the amount of tiling, 1.0 means the texture will be stretched across the whole polygon
+	unsigned int cellId; // cellId if multiple frames are stored together in the same sprite image
+};
+
+// Compact render data of a single 2D sprite submitted to the renderer by DrawSprites()
+// The transformation is built in the vertex shader, so each sprite only takes up 32 bytes
+struct Sprite2D
+{
+	glm::vec2 pos; // center of the sprite
+	glm::vec2 scale; // width and height of the sprite
+	float rotation; // rotation in radians around the center
+	float layer; // z value of the sprite
+	unsigned int color; // packed RGBA8 color, see PackRGBA8()
+	unsigned int cellId; // cellId if multiple frames are stored together in the same sprite image
+};
+
+static_assert(sizeof(Sprite2D) == 32, "Sprite2D should stay tightly packed");
+
+// Packs a color into RGBA8, red is stored in the lowest byte
+inline unsigned int PackRGBA8(const glm::vec4& color)
+{
+	glm::vec4 c = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+	return ((unsigned int)c.r) | ((unsigned int)c.g << 8) | ((unsigned int)c.b << 16) | ((unsigned int)c.a << 24);
+}
+
+// Statistics of a single frame rendered by Present()
+struct RenderStats
+{
+	unsigned int drawCalls;
+	unsigned int instances; // objects drawn, every sprite, particle, glyph or mesh counts as one
+	unsigned int vertices; // vertices processed by all draw calls
+	unsigned int stateChanges; // shader program changes
+	unsigned int textureBinds;
+	unsigned int bytesUploaded; // bytes copied into GPU buffers
+	unsigned int culled; // objects skipped because they were not visible
+	double presentTime; // seconds spent in Present()
+	double worldGpuTime; // seconds the GPU spent on the world space pass, only measured with dynamic resolution
+	float resolutionScale; // fraction of the window resolution the world space pass was rendered at
+	float redrawn; // fraction of the window redrawn, 0 if the frame was identical to the last one and was not presented
+};
+
 // Renderer plugin interface
 class IRenderer : public IPlugin
 {
@@ -69,6 +124,54 @@ public:
 							const std::string& tech = "sprite"
 							) = 0;
 
+	// DrawSprites() caches an array of sprites to be drawn by Present() with a single draw call
+	// The sprites are copied as a block, so prefer this over DrawSprite() when drawing many sprites with the same texture
+	// Note: if pArray is NULL, then DrawSprites() terminates
+	virtual void DrawSprites(const std::string& texture, // texture used to draw each sprite
+							 const SpriteInstance* pArray, // array of sprites to draw
+							 unsigned int length, // number of sprites
+							 const std::string& tech = "spriteBatch"
+							 ) = 0;
+
+	// DrawSprites() caches an array of compact 2D sprites to be drawn by Present() with a single draw call
+	// Note: if pArray is NULL, then DrawSprites() terminates
+	virtual void DrawSprites(const std::string& texture, // texture used to draw each sprite
+							 const Sprite2D* pArray, // array of sprites to draw
+							 unsigned int length, // number of sprites
+							 const std::string& tech = "sprite2D"
+							 ) = 0;
+
+	// DrawParticles() caches a stream of particles to be drawn by Present() with a single draw call
+	// Note: if pArray is NULL, then DrawParticles() terminates
+	virtual void DrawParticles(const std::string& texture, // texture used to draw each particle
+							   const ParticleVertex* pArray, // array of particles to draw
+							   unsigned int length, // number of particles
+							   const std::string& tech = "particle"
+							   ) = 0;
+
+	// DrawMesh() caches a static mesh to be drawn by Present()
+	virtual void DrawMesh(const std::string& mesh, // mesh resource to draw
+						  const std::string& texture, // texture applied to the mesh
+						  const glm::mat4& transformation, // transformation applied to the mesh
+						  const glm::vec4& color = glm::vec4(1.0f), // color that gets blended together with the mesh
+						  const std::string& tech = "sprite"
+						  ) = 0;
+
+	// Static sprite batches stay on the GPU between frames, they are only uploaded again when they are updated
+	// Meant for sprites that rarely change, such as the tiles of a grid
+	// CreateSpriteBatch() returns 0 if the batch could not be created
+	virtual int CreateSpriteBatch() = 0;
+	virtual void DestroySpriteBatch(int batch) = 0;
+
+	// Replaces the sprites of a static batch
+	virtual void UpdateSpriteBatch(int batch, const SpriteInstance* pArray, unsigned int length) = 0;
+
+	// DrawSpriteBatch() caches a static batch to be drawn by Present() with a single draw call, the sprites are not copied
+	virtual void DrawSpriteBatch(int batch, // batch created by CreateSpriteBatch()
+								 const std::string& texture, // texture used to draw each sprite
+								 const std::string& tech = "spriteBatch"
+								 ) = 0;
+
 	// Manage cursor creation
 	virtual int CreateCursor(const std::string& texture, int xhot, int yhot) = 0;
 	virtual void DestroyCursor(int cursor) = 0;
@@ -77,6 +180,23 @@ public:
 	// Returns the resource manager
 	virtual IResourceManager& GetResourceManager() = 0;
 
+	// Returns the statistics of a previously rendered frame, 0 being the last frame presented
+	// frame must be less than GetStatsHistorySize()
+	virtual const RenderStats& GetStats(unsigned int frame = 0) const = 0;
+
+	// Returns the number of frames kept in the statistics history
+	virtual unsigned int GetStatsHistorySize() const = 0;
+
+	// Adds objects culled by the caller to the statistics of the current frame
+	virtual void AddCulled(unsigned int count) = 0;
+
+	// Records every command submitted during the next frames into a render capture, see RenderCapture.h
+	// The capture can be replayed by the RenderReplay benchmark, returns false if the file cannot be created
+	virtual bool BeginCapture(const std::string& file, unsigned int frames) = 0;
+
+	// Returns true while a render capture is being recorded
+	virtual bool IsCapturing() const = 0;
+
 	// todo: add the ability to specify which component is being read
 	// Returns depth value in the buffer at a single point in screen space
 	virtual float ReadPixels(const glm::ivec2& pos) const = 0;
@@ -109,8 +229,15 @@ public:
 	virtual void EnableColorClearing(bool bEnable) = 0;
 
 	// Sets the display mode
+	// The window and its context are kept, so loaded resources stay valid
 	virtual void SetDisplayMode(int mode) = 0;
 
+	// Switches between fullscreen and windowed mode on the current monitor
+	virtual void SetFullscreen(bool bFullscreen) = 0;
+
+	// Returns true if the window is fullscreen
+	virtual bool IsFullscreen() const = 0;
+
 	// Sets the coordinate system to render all objects in(screen space or world space)
 	virtual void SetRenderSpace(RenderSpace) = 0; 
 
@@ -125,6 +252,29 @@ public:
 	// Returns true if the window is iconified
 	virtual bool IsIconified() const = 0;
 
+	// Renders the world space pass at a reduced resolution when its GPU time goes over fBudget seconds, the result is upscaled to the window
+	// The screen space pass is always rendered at the window resolution. 0 disables dynamic resolution, which is the default
+	virtual void SetResolutionBudget(double fBudget) = 0;
+
+	// Renders and presents each frame on a separate thread while the next frame is being recorded, disabled by default
+	// A frame recorded before the thread took the previous one replaces it. Dynamic resolution is not applied while the render thread is enabled
+	// While enabled, ReadPixels() returns the depth read from a frame rendered after an earlier call
+	virtual void EnableRenderThread(bool bEnable) = 0;
+
+	// Compares the commands of each frame with the last frame presented. Identical frames are not presented at all,
+	// and when only a few screen space commands changed, only the area they cover is redrawn. Disabled by default
+	// Meant for mostly static screens, such as menus, that wait for events between frames
+	virtual void EnableFrameElision(bool bEnable) = 0;
+
+	// Sets the maximum number of frames that may be queued on the GPU, 0 disables the limit
+	// Lower values reduce input latency at the cost of less overlap between the CPU and the GPU, the default is 2
+	virtual void SetMaxFramesInFlight(unsigned int frames) = 0;
+	virtual unsigned int GetMaxFramesInFlight() const = 0;
+
+	// Blocks until another frame can be queued without going over the frames in flight limit
+	// The game loop calls this before polling input so that input is sampled as late as possible
+	virtual void WaitForFrames() = 0;
+
 	// Render everything that has been cached so far to the back buffer and then swap the back buffer with the front buffer
 	virtual void Present() = 0;
 
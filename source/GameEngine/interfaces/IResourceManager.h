@@ -2,6 +2,8 @@
 #define _IRESOURCEMANAGER_
 
 #include <string>
+#include <vector>
+#include <utility>
 
 struct TextureInfo
 {
@@ -67,9 +69,18 @@ public:
 	 * id: uniqueID to be used
 	 * vert: vert shader file
 	 * frag: frag shader file
+	 * features: optional features supported by the shader(texture, tiling, animation, alphaTest),
+	 *           the renderer compiles a variant with only the features each batch needs
 	 * return: true if the shader was loaded, false on error
 	 **/
-	virtual bool LoadShader(const std::string& id, const std::string& vert, const std::string& frag) = 0;
+	virtual bool LoadShader(const std::string& id, const std::string& vert, const std::string& frag, const std::vector<std::string>& features = std::vector<std::string>()) = 0;
+
+	/** Loads a static mesh
+	 * id: uniqueID to be used
+	 * file: binary mesh file
+	 * return: true if the mesh is or was loaded, false on error
+	 **/
+	virtual bool LoadMesh(const std::string& id, const std::string& file) = 0;
 
 	// return via parameter texture info for a id
 	// return true if texture is found, false if not
@@ -78,6 +89,83 @@ public:
 	// Removes and deletes all resources loaded
 	virtual void Clear() = 0;
 
+	// Resources that are loaded are referenced by the current scope until the scope is released
+	// The empty scope "" is the scope of base.r and is never released by the engine
+	virtual void SetScope(const std::string& scope) = 0;
+
+	// Releases the references held by the scope, unreferenced resources may then be evicted
+	virtual void ReleaseScope(const std::string& scope) = 0;
+
+	// Adds or removes a reference to a resource, a referenced resource is never evicted
+	virtual void AddRef(const std::string& id) = 0;
+	virtual void Release(const std::string& id) = 0;
+
+	// Sets the maximum number of bytes used by textures before unreferenced textures are evicted, least recently used first
+	// Evicted resources are reloaded from disk the next time they are used
+	virtual void SetTextureBudget(unsigned int uiBytes) = 0;
+
+	// Returns the number of bytes used by the textures that are loaded
+	virtual unsigned int GetTextureMemory() const = 0;
+
+	// Returns the number of bytes used by the loaded textures referenced by a scope
+	virtual unsigned int GetScopeMemory(const std::string& scope) const = 0;
+
+	// Reads and decodes an image or a mesh file ahead of time, these methods can be called from any thread
+	// The next resource loaded from the same file only has to create its GPU objects
+	// return: true if the file was read, false on error
+	virtual bool PrefetchImage(const std::string& file) = 0;
+	virtual bool PrefetchMesh(const std::string& file) = 0;
+
+	// Frees the prefetched files that were not used by a load
+	virtual void ClearPrefetched() = 0;
+
+	// Sets the maximum number of GPU objects deleted per frame, 0 means no limit which is the default
+	// Unloaded resources are deleted a few frames later once the GPU is done with them, the budget spreads large unloads over several frames
+	virtual void SetDeletionBudget(unsigned int uiObjects) = 0;
+
+};
+
+// Holds a reference to a resource while it exists
+class ResourceHandle
+{
+public:
+
+	ResourceHandle() : m_pRM(nullptr) {}
+	ResourceHandle(IResourceManager& rm, const std::string& id) : m_pRM(&rm), m_id(id)
+	{
+		m_pRM->AddRef(m_id);
+	}
+
+	ResourceHandle(const ResourceHandle& other) : m_pRM(other.m_pRM), m_id(other.m_id)
+	{
+		if(m_pRM != nullptr)
+		{
+			m_pRM->AddRef(m_id);
+		}
+	}
+
+	ResourceHandle& operator =(const ResourceHandle& other)
+	{
+		ResourceHandle copy(other);
+		std::swap(m_pRM, copy.m_pRM);
+		std::swap(m_id, copy.m_id);
+		return *this;
+	}
+
+	~ResourceHandle()
+	{
+		if(m_pRM != nullptr)
+		{
+			m_pRM->Release(m_id);
+		}
+	}
+
+	const std::string& GetId() const { return m_id; }
+
+private:
+
+	IResourceManager* m_pRM;
+	std::string m_id;
 };
 
 
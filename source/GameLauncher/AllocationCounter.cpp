@@ -0,0 +1,54 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<unsigned long long> s_allocations(0);
+	std::atomic<unsigned long long> s_bytes(0);
+
+	void* Allocate(std::size_t bytes)
+	{
+		s_allocations.fetch_add(1, std::memory_order_relaxed);
+		s_bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+		void* p = std::malloc((bytes > 0) ? bytes : 1);
+
+		if (p == nullptr)
+			throw std::bad_alloc();
+
+		return p;
+	}
+}
+
+unsigned long long GetAllocationCount()
+{
+	return s_allocations.load(std::memory_order_relaxed);
+}
+
+unsigned long long GetAllocatedBytes()
+{
+	return s_bytes.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t bytes)
+{
+	return Allocate(bytes);
+}
+
+void* operator new[](std::size_t bytes)
+{
+	return Allocate(bytes);
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	std::free(p);
+}
@@ -0,0 +1,14 @@
+#ifndef _ALLOCATIONCOUNTER_
+#define _ALLOCATIONCOUNTER_
+
+// The launcher replaces the global operator new to count the allocations
+// On Windows each module has its own operator new, so only the allocations of the launcher and of the code it inlines are counted,
+// elsewhere the allocations of the engine and of the plugins are counted as well
+
+// Returns the number of allocations made with operator new since the program started
+unsigned long long GetAllocationCount();
+
+// Returns the number of bytes requested from operator new since the program started
+unsigned long long GetAllocatedBytes();
+
+#endif // _ALLOCATIONCOUNTER_
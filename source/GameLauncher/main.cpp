@@ -1,22 +1,220 @@
 #include "Game.h"
 #include "Log.h"
+#include "Profiler.h"
+#include "Timer.h"
+#include "AllocationCounter.h"
 
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
 #include <string>
+#include <vector>
+
+// Usage: GameLauncher [state] [options]
+// --state <name>      state to start, PluginLoader by default
+// --frames <n>        quit after n frames
+// --seconds <t>       quit after t seconds
+// --headless          draw nothing and open no window, same as --renderer nullrenderer --input nullinput
+// --renderer <plugin> renderer plug-in file, without the extension
+// --input <plugin>    input plug-in file, without the extension
+// --record <file>     record the input to file
+// --replay <file>     replay the input recorded in file, quits when the recording ends
+// --fixed-step <s>    update every s seconds instead of once per frame
+// --report <file>     write the timings of the run to a JSON file when the game quits
+struct LaunchOptions
+{
+	std::string state;
+	std::string renderer;
+	std::string input;
+	std::string record;
+	std::string replay;
+	std::string report;
+	unsigned int uiFrames;
+	double fSeconds;
+	double fFixedStep;
+};
+
+// Returns false if the command line is not valid
+bool ParseOptions(int size, char** cmd, LaunchOptions& options)
+{
+	options.state = "PluginLoader";
+	options.renderer = "renderer";
+	options.input = "input";
+	options.uiFrames = 0;
+	options.fSeconds = 0.0;
+	options.fFixedStep = 0.0;
+
+	for (int i = 1; i < size; ++i)
+	{
+		std::string arg = cmd[i];
+
+		if (arg == "--headless")
+		{
+			options.renderer = "nullrenderer";
+			options.input = "nullinput";
+			continue;
+		}
+
+		// Kept for compatibility, the state used to be the only argument
+		if (arg.compare(0, 2, "--") != 0)
+		{
+			options.state = arg;
+			continue;
+		}
+
+		// Every other option takes a value
+		if ((i + 1) >= size)
+			return false;
+
+		const char* pValue = cmd[++i];
+
+		if (arg == "--state") options.state = pValue;
+		else if (arg == "--frames") options.uiFrames = (unsigned int)std::strtoul(pValue, nullptr, 10);
+		else if (arg == "--seconds") options.fSeconds = std::atof(pValue);
+		else if (arg == "--renderer") options.renderer = pValue;
+		else if (arg == "--input") options.input = pValue;
+		else if (arg == "--record") options.record = pValue;
+		else if (arg == "--replay") options.replay = pValue;
+		else if (arg == "--fixed-step") options.fFixedStep = std::atof(pValue);
+		else if (arg == "--report") options.report = pValue;
+		else return false;
+	}
+
+	return options.record.empty() || options.replay.empty();
+}
+
+// Writes the time of a frame or of a scope in milliseconds
+void WriteMs(std::ofstream& stream, const char* name, double fTime, bool bLast = false)
+{
+	stream << "\"" << name << "\": " << fTime * 1000.0 << (bLast ? "" : ", ");
+}
+
+std::string EscapeJson(const std::string& str)
+{
+	std::string out;
+
+	for (char c : str)
+	{
+		if ((c == '"') || (c == '\\'))
+		{
+			out += '\\';
+		}
+
+		out += c;
+	}
+
+	return out;
+}
+
+// Writes the frame times, the profiled scopes and the allocations of the run
+bool WriteReport(Game& game, const LaunchOptions& options, double fRunTime, unsigned long long allocations, unsigned long long bytes)
+{
+	std::ofstream stream(options.report);
+
+	if (!stream)
+		return false;
+
+	FrameTimeSummary summary = game.GetFrameStats().GetSessionSummary();
+
+	std::vector<ProfileSample> samples;
+	Profiler::Instance().GetSamples(samples);
+
+	stream << "{" << std::endl;
+	stream << "\t\"state\": \"" << EscapeJson(options.state) << "\"," << std::endl;
+	stream << "\t\"renderer\": \"" << EscapeJson(options.renderer) << "\"," << std::endl;
+	stream << "\t\"replay\": \"" << EscapeJson(options.replay) << "\"," << std::endl;
+	stream << "\t\"seconds\": " << fRunTime << "," << std::endl;
+
+	stream << "\t\"frameTimeMs\": { \"frames\": " << summary.frames << ", ";
+	WriteMs(stream, "min", summary.min);
+	WriteMs(stream, "avg", summary.avg);
+	WriteMs(stream, "p50", summary.p50);
+	WriteMs(stream, "p95", summary.p95);
+	WriteMs(stream, "p99", summary.p99);
+	WriteMs(stream, "max", summary.max);
+	stream << "\"hitches\": " << summary.hitches << " }," << std::endl;
+
+	stream << "\t\"scopes\": [" << std::endl;
+	for (unsigned int i = 0; i < samples.size(); ++i)
+	{
+		const ProfileSample& sample = samples[i];
+
+		stream << "\t\t{ \"name\": \"" << EscapeJson(sample.name) << "\", \"calls\": " << sample.calls << ", ";
+		WriteMs(stream, "totalMs", sample.total);
+		WriteMs(stream, "avgMs", sample.total / sample.calls);
+		WriteMs(stream, "maxMs", sample.max, true);
+		stream << " }" << ((i + 1) < samples.size() ? "," : "") << std::endl;
+	}
+	stream << "\t]," << std::endl;
+
+	double fFrames = (summary.frames > 0) ? summary.frames : 1.0;
+
+	stream << "\t\"allocations\": { \"count\": " << allocations << ", \"bytes\": " << bytes
+		   << ", \"perFrame\": " << allocations / fFrames << ", \"bytesPerFrame\": " << bytes / fFrames << " }" << std::endl;
+	stream << "}" << std::endl;
+
+	return stream.good();
+}
 
 int main(int size, char** cmd)
 {
-	const char* pState = "PluginLoader";
+	LaunchOptions options;
 
-	if (size >= 2)
+	if (!ParseOptions(size, cmd, options))
 	{
-		pState = cmd[1];
+		std::cout << "Usage: GameLauncher [state] [--state name] [--frames n] [--seconds t] [--headless] [--renderer plugin] [--input plugin]"
+				  << " [--record file | --replay file] [--fixed-step s] [--report file]" << std::endl;
+		return 1;
 	}
 
 	try
 	{
-		Game myGame;
-		myGame.SetNextState(pState);
-		return myGame.Run();
+		Game myGame(options.renderer, options.input);
+
+		if (options.fFixedStep > 0.0)
+		{
+			myGame.SetFixedTimestep(options.fFixedStep);
+		}
+
+		if (!options.record.empty() && !myGame.RecordInput(options.record))
+			return 1;
+
+		if (!options.replay.empty() && !myGame.ReplayInput(options.replay))
+			return 1;
+
+		if ((options.uiFrames > 0) || (options.fSeconds > 0.0))
+		{
+			myGame.SetRunLimit(options.uiFrames, options.fSeconds);
+		}
+
+		myGame.SetNextState(options.state);
+
+		// Only the frames of the run are reported, not the loading before it
+		Profiler::Instance().Reset();
+		unsigned long long allocations = GetAllocationCount();
+		unsigned long long bytes = GetAllocatedBytes();
+
+		Timer runTimer;
+		runTimer.Start();
+
+		int result = myGame.Run();
+
+		double fRunTime = runTimer.GetTime();
+
+		if (!options.report.empty())
+		{
+			if (WriteReport(myGame, options, fRunTime, GetAllocationCount() - allocations, GetAllocatedBytes() - bytes))
+			{
+				Log::Instance().Write("Timing report written to " + options.report);
+			}
+			else
+			{
+				Log::Instance().Write("Failed to write the timing report to " + options.report);
+			}
+		}
+
+		return result;
 	}
 	catch(std::exception& error)
 	{
@@ -1,12 +1,12 @@
 
 #include "Input.h"
+#include "MainWindow.h"
 
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
-#include <glm/geometric.hpp>
-#include <glm/gtc/constants.hpp>
+#include <cstring>
 
 using namespace std;
 
@@ -65,7 +65,10 @@ void Input::CursorEnterCallback(GLFWwindow*, int entered)
 	s_pThis->m_bEntered = entered == GL_TRUE;
 }
 
-Input::Input() : m_bEntered(true), m_iNumJoystickAxes(0), m_pJoystickAxes(nullptr)
+static_assert(GLFW_MOUSE_BUTTON_LAST + 1 == INPUT_MOUSE_BUTTONS, "The recordings store a different number of mouse buttons");
+static_assert((GLFW_PRESS == INPUT_PRESS) && (GLFW_RELEASE == INPUT_RELEASE), "The recordings store different actions");
+
+Input::Input() : m_bEntered(true), m_iNumJoystickAxes(0), m_pJoystickAxes(nullptr), m_bReplaying(false), m_uiHeldMouseButtons(0)
 {
 	s_pThis = this;
 
@@ -77,18 +80,18 @@ Input::Input() : m_bEntered(true), m_iNumJoystickAxes(0), m_pJoystickAxes(nullpt
 	Reset();
 
 	// Configure Keyboard and Mouse callbacks
-	GLFWwindow* currentContext = glfwGetCurrentContext();
-	glfwSetCharCallback(currentContext, CharCallback);
-	glfwSetKeyCallback(currentContext, KeyCallback);
-	glfwSetCursorPosCallback(currentContext, MouseCallback);
-	glfwSetMouseButtonCallback(currentContext, MouseButtonCallback);
-	glfwSetScrollCallback(currentContext, MouseScrollCallback);
-	glfwSetCursorEnterCallback(currentContext, CursorEnterCallback);
+	GLFWwindow* pWindow = GetMainWindow();
+	glfwSetCharCallback(pWindow, CharCallback);
+	glfwSetKeyCallback(pWindow, KeyCallback);
+	glfwSetCursorPosCallback(pWindow, MouseCallback);
+	glfwSetMouseButtonCallback(pWindow, MouseButtonCallback);
+	glfwSetScrollCallback(pWindow, MouseScrollCallback);
+	glfwSetCursorEnterCallback(pWindow, CursorEnterCallback);
 
 	// Move the mouse to the center of the screen
 	int width, height;
-	glfwGetWindowSize(currentContext, &width, &height);
-	glfwSetCursorPos(currentContext, width / 2, height / 2);
+	glfwGetWindowSize(pWindow, &width, &height);
+	glfwSetCursorPos(pWindow, width / 2, height / 2);
 
 	m_cursorPos.x = width / 2;
 	m_cursorPos.y = height / 2;
@@ -99,13 +102,13 @@ Input::Input() : m_bEntered(true), m_iNumJoystickAxes(0), m_pJoystickAxes(nullpt
 
 Input::~Input()
 {
-	GLFWwindow* currentContext = glfwGetCurrentContext();
-	glfwSetCharCallback(currentContext, nullptr);
-	glfwSetKeyCallback(currentContext, nullptr);
-	glfwSetCursorPosCallback(currentContext, nullptr);
-	glfwSetMouseButtonCallback(currentContext, nullptr);
-	glfwSetScrollCallback(currentContext, nullptr);
-	glfwSetCursorEnterCallback(currentContext, nullptr);
+	GLFWwindow* pWindow = GetMainWindow();
+	glfwSetCharCallback(pWindow, nullptr);
+	glfwSetKeyCallback(pWindow, nullptr);
+	glfwSetCursorPosCallback(pWindow, nullptr);
+	glfwSetMouseButtonCallback(pWindow, nullptr);
+	glfwSetScrollCallback(pWindow, nullptr);
+	glfwSetCursorEnterCallback(pWindow, nullptr);
 }
 
 DLLType Input::GetPluginType() const
@@ -195,14 +198,20 @@ bool Input::MouseClick(int button, bool once) const
 	if (button > GLFW_MOUSE_BUTTON_LAST || button < 0)
 		return false;
 
-	return (once ? (m_MouseClickOnce[button] == GLFW_PRESS) : glfwGetMouseButton(glfwGetCurrentContext(), button) == GLFW_PRESS);
+	if (!once && m_bReplaying)
+		return (m_uiHeldMouseButtons & (1 << button)) != 0;
+
+	return (once ? (m_MouseClickOnce[button] == GLFW_PRESS) : glfwGetMouseButton(GetMainWindow(), button) == GLFW_PRESS);
 }
 bool Input::MouseRelease(int button, bool once) const
 {
 	if (button > GLFW_MOUSE_BUTTON_LAST || button < 0)
 		return false;
 
-	return (once ? (m_MouseClickOnce[button] == GLFW_RELEASE) : glfwGetMouseButton(glfwGetCurrentContext(), button) == GLFW_RELEASE);
+	if (!once && m_bReplaying)
+		return (m_uiHeldMouseButtons & (1 << button)) == 0;
+
+	return (once ? (m_MouseClickOnce[button] == GLFW_RELEASE) : glfwGetMouseButton(GetMainWindow(), button) == GLFW_RELEASE);
 }
 
 const glm::ivec2& Input::GetCursorPos() const
@@ -212,14 +221,14 @@ const glm::ivec2& Input::GetCursorPos() const
 
 void Input::SetCursorPos(glm::ivec2 pos)
 {
-	glfwSetCursorPos(glfwGetCurrentContext(), pos.x, pos.y);
+	glfwSetCursorPos(GetMainWindow(), pos.x, pos.y);
 	m_fOldMousePosX = pos.x;
 	m_fOldMousePosY = pos.y;
 }
 
 bool Input::IsCursorShown() const
 {
-	return (glfwGetInputMode(glfwGetCurrentContext(), GLFW_CURSOR) == GLFW_CURSOR_NORMAL);
+	return (glfwGetInputMode(GetMainWindow(), GLFW_CURSOR) == GLFW_CURSOR_NORMAL);
 }
 
 bool Input::IsCursorEntered() const
@@ -229,7 +238,7 @@ bool Input::IsCursorEntered() const
 
 void Input::ShowCursor(bool bShow)
 {
-	glfwSetInputMode(glfwGetCurrentContext(), GLFW_CURSOR, bShow ? GLFW_CURSOR_NORMAL : GLFW_CURSOR_DISABLED);
+	glfwSetInputMode(GetMainWindow(), GLFW_CURSOR, bShow ? GLFW_CURSOR_NORMAL : GLFW_CURSOR_DISABLED);
 }
 
 glm::ivec2 Input::CursorAcceleration() const
@@ -272,115 +281,176 @@ void Input::SetJoystickAxesDeadZone(JoystickAxes i, float deadZone)
 
 bool Input::GetMovingJoystickAxes(int& outAxes, int& outDir) const
 {
-	bool success = false;
-
-	for (unsigned int i = 0; i < 2 && !success; ++i)
+	for (unsigned int i = 0; i < 2; ++i)
 	{
-		glm::vec2 axes = GetJoystickAxes((JoystickAxes)i);
-
-		// If the axes is being pushed
-		if (axes.x > 0.0f || axes.x < 0.0f || axes.y > 0.0f || axes.y < 0.0f)
+		if (GetJoystickDirection(GetJoystickAxes((JoystickAxes)i), outDir))
 		{
-			// Get the angle of the direction in degrees
-			float angle = atan2(-axes.y, axes.x) * 180.0f / glm::pi<float>();
-
-			if (angle < 135.0f && angle > 45.0f)
-			{
-				outDir = 0; // Up
-			}
-			else if (angle > -135.0f && angle < -45.0f)
-			{
-				outDir = 1; // Down
-			}
-			else if (angle > 135.0f || angle < -135.0f)
-			{
-				outDir = 2; // Left
-			}
-			else
-			{
-				outDir = 3; // Right
-			}
-
 			outAxes = i;
-			
-			success = true;
+			return true;
 		}
 	}
 
-	return success;
+	return false;
 }
 
 glm::vec2 Input::GetJoystickAxes(JoystickAxes i) const
 {
-	glm::vec2 axes;
+	if (!IsValidJoystickConnected())
+		return glm::vec2();
 
-	if (IsValidJoystickConnected())
-	{
-		if (i == JoystickAxes::LS || i == JoystickAxes::RS)
-		{
-			if (i == JoystickAxes::LS)
-			{
-				axes = glm::vec2(m_pJoystickAxes[0], m_pJoystickAxes[1]);
-			}
-			else if (m_iNumJoystickAxes >= 5)
-			{
-				axes = glm::vec2(m_pJoystickAxes[4], m_pJoystickAxes[3]);
-			}
+	// Only the sticks have a dead zone
+	float deadZone = ((unsigned int)i < m_fJoyDeadZone.size()) ? m_fJoyDeadZone[(int)i] : 0.0f;
 
-			float deadZone = m_fJoyDeadZone[(int)i];
+	return ::GetJoystickAxes(m_pJoystickAxes, m_iNumJoystickAxes, i, deadZone);
+}
 
-			// Determine how far the controller is pushed
-			float magnitude = glm::length(axes);
+int Input::GetNumJoystickButtons() const
+{
+	return m_joystickButtons.size();
+}
 
-			// Check if the controller is outside a circular dead zone
-			if (magnitude > deadZone)
-			{
-				// Clip the magnitude at its expected maximum value
-				if (magnitude > 1.0f)
-				{
-					magnitude = 1.0f;
-				}
+bool Input::JoystickButtonPress(int button, bool once) const
+{
+	return (button < GetNumJoystickButtons() && button >= 0) && (m_joystickButtons[button] == 1 || (!once && m_joystickButtons[button] == 2));
+}
 
-				// Determine the direction the controller is pushed
-				axes /= magnitude;
+bool Input::JoystickButtonRelease(int button, bool once) const
+{
+	return (button < GetNumJoystickButtons() && button >= 0) && ((!once && m_joystickButtons[button] == 0) || (once && m_joystickButtons[button] == 3));
+}
 
-				// Adjust magnitude relative to the end of the dead zone
-				magnitude -= deadZone;
+bool Input::BeginRecording(const std::string& file, unsigned int uiSeed)
+{
+	EndRecording();
 
-				// Normalize the magnitude with respect to its expected range
-				// giving a magnitude value of 0.0 to 1.0
-				axes *= (magnitude / (1.0f - deadZone));
-			}
-			else
-			{
-				axes = glm::vec2();
-			}
-		}
-		else
-		{
-			axes = glm::vec2(0.0f, m_pJoystickAxes[2]);
+	return m_recording.Open(file, uiSeed);
+}
 
-			// Clip the magnitude at its expected maximum value
-			axes.y = glm::clamp(axes.y, -1.0f, 1.0f);
-		}
+bool Input::BeginReplay(const std::string& file, unsigned int& uiSeed)
+{
+	EndRecording();
+
+	if (!m_replay.Open(file, uiSeed))
+		return false;
+
+	m_bReplaying = true;
+
+	return true;
+}
+
+void Input::EndRecording()
+{
+	m_recording.Close();
+	m_replay.Close();
+
+	if (m_bReplaying)
+	{
+		m_bReplaying = false;
+		m_heldKeys.clear();
+		m_uiHeldMouseButtons = 0;
+
+		UpdateJoystick();
 	}
+}
 
-	return axes;
+bool Input::IsRecording() const
+{
+	return m_recording.IsOpen();
 }
 
-int Input::GetNumJoystickButtons() const
+bool Input::IsReplaying() const
 {
-	return m_joystickButtons.size();
+	return m_bReplaying;
 }
 
-bool Input::JoystickButtonPress(int button, bool once) const
+void Input::EndFrame(double& dt)
 {
-	return (button < GetNumJoystickButtons() && button >= 0) && (m_joystickButtons[button] == 1 || (!once && m_joystickButtons[button] == 2));
+	if (m_recording.IsOpen())
+	{
+		RecordFrame(dt);
+	}
+	else if (m_bReplaying && !ReplayFrame(dt))
+	{
+		EndRecording();
+	}
 }
 
-bool Input::JoystickButtonRelease(int button, bool once) const
+void Input::RecordFrame(double dt)
 {
-	return (button < GetNumJoystickButtons() && button >= 0) && ((!once && m_joystickButtons[button] == 0) || (once && m_joystickButtons[button] == 3));
+	GLFWwindow* pWindow = GetMainWindow();
+
+	m_frame.dt = dt;
+	m_frame.key = m_iKeyDown;
+	m_frame.keyAction = m_iKeyAction;
+	m_frame.charKey = m_iCharKeyDown;
+	m_frame.heldMouseButtons = 0;
+
+	for (unsigned int i = 0; i < m_MouseClickOnce.size(); ++i)
+	{
+		m_frame.mouseButtons[i] = m_MouseClickOnce[i];
+
+		if (glfwGetMouseButton(pWindow, i) == GLFW_PRESS)
+		{
+			m_frame.heldMouseButtons |= (1 << i);
+		}
+	}
+
+	m_frame.acceleration = glm::ivec2(m_iMouseAccelerationX, m_iMouseAccelerationY);
+	m_frame.cursorPos = m_cursorPos;
+	m_frame.selectedPos = m_selectedPos;
+	m_frame.scroll = m_fYScrollOffset;
+	m_frame.entered = m_bEntered;
+
+	// Only the keys that are held are stored
+	m_frame.heldKeys.clear();
+	for (int key = KEY_SPACE; key <= KEY_LAST; ++key)
+	{
+		if (glfwGetKey(pWindow, key) == GLFW_PRESS)
+		{
+			m_frame.heldKeys.push_back((uint16_t)key);
+		}
+	}
+
+	unsigned int uiAxes = (m_pJoystickAxes != nullptr) ? m_iNumJoystickAxes : 0;
+	m_frame.joystickAxes.assign(m_pJoystickAxes, m_pJoystickAxes + uiAxes);
+	m_frame.joystickButtons = m_joystickButtons;
+
+	m_recording.Write(m_frame);
+}
+
+bool Input::ReplayFrame(double& dt)
+{
+	// A truncated frame is not replayed
+	if (!m_replay.Read(m_frame))
+		return false;
+
+	dt = m_frame.dt;
+	m_iKeyDown = m_frame.key;
+	m_iKeyAction = m_frame.keyAction;
+	m_iCharKeyDown = m_frame.charKey;
+
+	for (unsigned int i = 0; i < m_MouseClickOnce.size(); ++i)
+	{
+		m_MouseClickOnce[i] = m_frame.mouseButtons[i];
+	}
+
+	m_iMouseAccelerationX = m_frame.acceleration.x;
+	m_iMouseAccelerationY = m_frame.acceleration.y;
+	m_cursorPos = m_frame.cursorPos;
+	m_selectedPos = m_frame.selectedPos;
+	m_fYScrollOffset = m_frame.scroll;
+	m_bEntered = m_frame.entered;
+	m_uiHeldMouseButtons = m_frame.heldMouseButtons;
+
+	// Swapped rather than copied, so that replaying does not allocate once the vectors have grown
+	m_heldKeys.swap(m_frame.heldKeys);
+	m_replayAxes.swap(m_frame.joystickAxes);
+	m_joystickButtons.swap(m_frame.joystickButtons);
+
+	m_iNumJoystickAxes = (int)m_replayAxes.size();
+	m_pJoystickAxes = m_replayAxes.empty() ? nullptr : m_replayAxes.data();
+
+	return true;
 }
 
 void Input::Reset()
@@ -410,9 +480,14 @@ bool Input::CheckKey(int key, bool once, int flag) const
 	{
 		bSuccess = (key == m_iKeyDown) && (m_iKeyAction == flag);
 	}
+	else if (m_bReplaying)
+	{
+		bool bHeld = std::find(m_heldKeys.begin(), m_heldKeys.end(), (uint16_t)key) != m_heldKeys.end();
+		bSuccess = (bHeld == (flag == GLFW_PRESS));
+	}
 	else
 	{
-		bSuccess = (glfwGetKey(glfwGetCurrentContext(), key) == flag);
+		bSuccess = (glfwGetKey(GetMainWindow(), key) == flag);
 	}
 	
 	return bSuccess;
@@ -429,7 +504,7 @@ void Input::UpdateMouse(double x, double y)
 	if (IsCursorShown())
 	{
 		int height;
-		glfwGetWindowSize(glfwGetCurrentContext(), nullptr, &height);
+		glfwGetWindowSize(GetMainWindow(), nullptr, &height);
 
 		m_cursorPos.x = static_cast<int>(x);
 		m_cursorPos.y = height - static_cast<int>(y);
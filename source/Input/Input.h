@@ -7,7 +7,10 @@
 
 #include "IInput.h"
 #include "PluginManager.h"
+#include "InputRecording.h"
+#include "JoystickAxes.h"
 #include <array>
+#include <cstdint>
 #include <unordered_map>
 #include <vector>
 #include <GLFW/glfw3.h>
@@ -131,6 +134,23 @@ public:
 	// Returns true if the button is pressed, else false
 	bool JoystickButtonRelease(int button, bool once = true) const override;
 
+	// ----- Recording -----
+
+	// Records the input of every frame to a binary file, along with the time step of each frame and uiSeed
+	bool BeginRecording(const std::string& file, unsigned int uiSeed) override;
+
+	// Replays a recording, the input of each frame comes from the recording instead of the window
+	bool BeginReplay(const std::string& file, unsigned int& uiSeed) override;
+
+	// Stops recording or replaying
+	void EndRecording() override;
+
+	bool IsRecording() const override;
+	bool IsReplaying() const override;
+
+	// Records or replays the input of the frame
+	void EndFrame(double& dt) override;
+
 private:
 
 	static Input* s_pThis;
@@ -167,11 +187,27 @@ private:
 
 	std::vector<unsigned char> m_joystickButtons;
 
+	// Recording, see BeginRecording()
+	InputRecordingWriter m_recording;
+	InputRecordingReader m_replay;
+	InputFrame m_frame; // frame being recorded or replayed
+	bool m_bReplaying;
+
+	// State of the replayed frame that is otherwise read from GLFW
+	std::vector<uint16_t> m_heldKeys;
+	uint8_t m_uiHeldMouseButtons;
+	std::vector<float> m_replayAxes;
+
 	// helper methods
 	void Reset();
 	bool CheckKey(int key, bool once, int flag) const;
 	void UpdateMouse(double x, double y);
 	void UpdateJoystick();
+
+	void RecordFrame(double dt);
+
+	// Returns false if there are no frames left
+	bool ReplayFrame(double& dt);
 };
 
 #endif
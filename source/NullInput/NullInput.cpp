@@ -0,0 +1,310 @@
+#include "NullInput.h"
+#include "JoystickAxes.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+extern "C" PLUGINDECL IPlugin* CreatePlugin()
+{
+	return new NullInput();
+}
+
+NullInput::NullInput() : m_bReplaying(false), m_bCursorShown(true)
+{
+	m_fJoyDeadZone.fill(0.2f);
+
+	m_frame.dt = 0.0;
+	m_frame.cursorPos = glm::ivec2(0);
+	m_frame.selectedPos = glm::ivec2(0);
+	m_frame.entered = true;
+	m_frame.heldMouseButtons = 0;
+
+	Reset();
+}
+
+DLLType NullInput::GetPluginType() const
+{
+	return DLLType::Input;
+}
+
+const char* NullInput::GetName() const
+{
+	return "NullInput";
+}
+
+int NullInput::GetVersion() const
+{
+	return 0;
+}
+
+void NullInput::Poll()
+{
+	Reset();
+}
+
+bool NullInput::LoadKeyBindFile(const std::string& file)
+{
+	std::ifstream inFile(file);
+	if (!inFile.is_open())
+		return false;
+
+	// Same format as the GLFW input plug-in, so that replays see the same keys
+	std::string line;
+	while (std::getline(inFile, line))
+	{
+		std::istringstream stream(line);
+
+		std::string command;
+		stream >> command;
+
+		if (command == "bind")
+		{
+			std::string from;
+			std::string to;
+
+			stream >> from >> to;
+
+			if (!from.empty() && !to.empty())
+			{
+				RemapKey(from[0], to[0]);
+			}
+		}
+	}
+
+	return true;
+}
+
+bool NullInput::KeyPress(int key, bool once) const
+{
+	return CheckKey(key, once, INPUT_PRESS);
+}
+
+bool NullInput::KeyRelease(int key, bool once) const
+{
+	return CheckKey(key, once, INPUT_RELEASE);
+}
+
+bool NullInput::CharKeyDown(char& out) const
+{
+	if (m_frame.charKey == (unsigned int)-1)
+		return false;
+
+	out = m_frame.charKey;
+
+	return true;
+}
+
+void NullInput::RemapKey(int key, int newKey)
+{
+	m_keyboardMapping[newKey] = key;
+}
+
+bool NullInput::MouseClick(int button, bool once) const
+{
+	if (button < 0 || button >= (int)INPUT_MOUSE_BUTTONS)
+		return false;
+
+	return once ? (m_frame.mouseButtons[button] == INPUT_PRESS) : ((m_frame.heldMouseButtons & (1 << button)) != 0);
+}
+
+bool NullInput::MouseRelease(int button, bool once) const
+{
+	if (button < 0 || button >= (int)INPUT_MOUSE_BUTTONS)
+		return false;
+
+	return once ? (m_frame.mouseButtons[button] == INPUT_RELEASE) : ((m_frame.heldMouseButtons & (1 << button)) == 0);
+}
+
+const glm::ivec2& NullInput::GetCursorPos() const
+{
+	return m_frame.cursorPos;
+}
+
+void NullInput::SetCursorPos(glm::ivec2 pos)
+{
+	m_frame.cursorPos = pos;
+}
+
+bool NullInput::IsCursorShown() const
+{
+	return m_bCursorShown;
+}
+
+bool NullInput::IsCursorEntered() const
+{
+	return m_frame.entered;
+}
+
+void NullInput::ShowCursor(bool bShow)
+{
+	m_bCursorShown = bShow;
+}
+
+glm::ivec2 NullInput::CursorAcceleration() const
+{
+	return m_frame.acceleration;
+}
+
+double NullInput::MouseZ() const
+{
+	return m_frame.scroll;
+}
+
+bool NullInput::GetSelectedRect(glm::ivec2& min, glm::ivec2& max)
+{
+	if (!MouseClick(0, false))
+		return false;
+
+	min = glm::min(m_frame.selectedPos, m_frame.cursorPos);
+	max = glm::max(m_frame.selectedPos, m_frame.cursorPos);
+
+	return true;
+}
+
+bool NullInput::IsValidJoystickConnected() const
+{
+	return m_frame.joystickAxes.size() >= 2;
+}
+
+std::string NullInput::GetJoystickName() const
+{
+	return std::string();
+}
+
+void NullInput::SetJoystickAxesDeadZone(JoystickAxes i, float deadZone)
+{
+	if ((unsigned int)i < m_fJoyDeadZone.size())
+	{
+		m_fJoyDeadZone[(int)i] = deadZone;
+	}
+}
+
+bool NullInput::GetMovingJoystickAxes(int& outAxes, int& outDir) const
+{
+	for (unsigned int i = 0; i < 2; ++i)
+	{
+		if (GetJoystickDirection(GetJoystickAxes((JoystickAxes)i), outDir))
+		{
+			outAxes = i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+glm::vec2 NullInput::GetJoystickAxes(JoystickAxes i) const
+{
+	if (!IsValidJoystickConnected())
+		return glm::vec2();
+
+	float deadZone = ((unsigned int)i < m_fJoyDeadZone.size()) ? m_fJoyDeadZone[(int)i] : 0.0f;
+
+	return ::GetJoystickAxes(m_frame.joystickAxes.data(), (int)m_frame.joystickAxes.size(), i, deadZone);
+}
+
+int NullInput::GetNumJoystickButtons() const
+{
+	return (int)m_frame.joystickButtons.size();
+}
+
+bool NullInput::JoystickButtonPress(int button, bool once) const
+{
+	return (button < GetNumJoystickButtons() && button >= 0) && (m_frame.joystickButtons[button] == 1 || (!once && m_frame.joystickButtons[button] == 2));
+}
+
+bool NullInput::JoystickButtonRelease(int button, bool once) const
+{
+	return (button < GetNumJoystickButtons() && button >= 0) && ((!once && m_frame.joystickButtons[button] == 0) || (once && m_frame.joystickButtons[button] == 3));
+}
+
+bool NullInput::BeginRecording(const std::string&, unsigned int)
+{
+	return false;
+}
+
+bool NullInput::BeginReplay(const std::string& file, unsigned int& uiSeed)
+{
+	EndRecording();
+
+	if (!m_replay.Open(file, uiSeed))
+		return false;
+
+	m_bReplaying = true;
+
+	return true;
+}
+
+void NullInput::EndRecording()
+{
+	m_replay.Close();
+
+	if (m_bReplaying)
+	{
+		m_bReplaying = false;
+
+		// Nothing stays held once the recording ends
+		m_frame.heldMouseButtons = 0;
+		m_frame.heldKeys.clear();
+		m_frame.joystickAxes.clear();
+		m_frame.joystickButtons.clear();
+	}
+}
+
+bool NullInput::IsRecording() const
+{
+	return false;
+}
+
+bool NullInput::IsReplaying() const
+{
+	return m_bReplaying;
+}
+
+void NullInput::EndFrame(double& dt)
+{
+	if (!m_bReplaying)
+		return;
+
+	// A truncated frame is not replayed
+	if (m_replay.Read(m_frame))
+	{
+		dt = m_frame.dt;
+	}
+	else
+	{
+		Reset();
+		EndRecording();
+	}
+}
+
+void NullInput::Reset()
+{
+	m_frame.key = -1;
+	m_frame.keyAction = -1;
+	m_frame.charKey = (unsigned int)-1;
+	m_frame.acceleration = glm::ivec2(0);
+	m_frame.scroll = 0.0;
+
+	for (int& action : m_frame.mouseButtons)
+	{
+		action = -1;
+	}
+}
+
+bool NullInput::CheckKey(int key, bool once, int flag) const
+{
+	auto iter = m_keyboardMapping.find(key);
+	if (iter != m_keyboardMapping.end())
+	{
+		key = iter->second;
+	}
+
+	if (once)
+		return (key == m_frame.key) && (m_frame.keyAction == flag);
+
+	bool bHeld = std::find(m_frame.heldKeys.begin(), m_frame.heldKeys.end(), (uint16_t)key) != m_frame.heldKeys.end();
+
+	return bHeld == (flag == INPUT_PRESS);
+}
@@ -0,0 +1,83 @@
+#ifndef _NULLINPUT_
+#define _NULLINPUT_
+
+#include "IInput.h"
+#include "PluginManager.h"
+#include "InputRecording.h"
+#include <array>
+#include <unordered_map>
+
+// Input plug-in without a window, used with the NullRenderer to run the engine headless
+// There is no input, except for the frames of a replayed recording, see BeginReplay()
+// Recording is not supported, there is nothing to record
+class NullInput final : public IInput
+{
+public:
+
+	NullInput();
+
+	// IPlugin
+	DLLType GetPluginType() const override;
+	const char* GetName() const override;
+	int GetVersion() const override;
+
+	// IInput
+	void Poll() override;
+
+	bool LoadKeyBindFile(const std::string& file) override;
+	bool KeyPress(int key, bool once = true) const override;
+	bool KeyRelease(int key, bool once = true) const override;
+	bool CharKeyDown(char& out) const override;
+	void RemapKey(int key, int newKey) override;
+
+	bool MouseClick(int button, bool once = true) const override;
+	bool MouseRelease(int button, bool once = true) const override;
+	const glm::ivec2& GetCursorPos() const override;
+	void SetCursorPos(glm::ivec2 pos) override;
+	bool IsCursorShown() const override;
+	bool IsCursorEntered() const override;
+	void ShowCursor(bool bShow) override;
+	glm::ivec2 CursorAcceleration() const override;
+	double MouseZ() const override;
+	bool GetSelectedRect(glm::ivec2& min, glm::ivec2& max) override;
+
+	bool IsValidJoystickConnected() const override;
+	std::string GetJoystickName() const override;
+	void SetJoystickAxesDeadZone(JoystickAxes i, float deadZone) override;
+	bool GetMovingJoystickAxes(int& axes, int& dir) const override;
+	glm::vec2 GetJoystickAxes(JoystickAxes i) const override;
+	int GetNumJoystickButtons() const override;
+	bool JoystickButtonPress(int button, bool once = true) const override;
+	bool JoystickButtonRelease(int button, bool once = true) const override;
+
+	// Always returns false
+	bool BeginRecording(const std::string& file, unsigned int uiSeed) override;
+
+	bool BeginReplay(const std::string& file, unsigned int& uiSeed) override;
+	void EndRecording() override;
+	bool IsRecording() const override;
+	bool IsReplaying() const override;
+
+	// Replaces the input of the frame by the next frame of the recording
+	void EndFrame(double& dt) override;
+
+private:
+
+	InputRecordingReader m_replay;
+	bool m_bReplaying;
+	bool m_bCursorShown;
+
+	std::unordered_map<int, int> m_keyboardMapping;
+
+	// Input of the frame, cleared by Poll() and by the end of the replay
+	InputFrame m_frame;
+
+	std::array<float, 2> m_fJoyDeadZone;
+
+	void Reset();
+
+	// Returns the action of the key during the frame if once is true, else whether the key is held
+	bool CheckKey(int key, bool once, int flag) const;
+};
+
+#endif // _NULLINPUT_
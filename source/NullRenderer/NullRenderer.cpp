@@ -0,0 +1,316 @@
+#include "NullRenderer.h"
+
+#include <cstring>
+
+extern "C" PLUGINDECL IPlugin* CreatePlugin()
+{
+	return new NullRenderer();
+}
+
+namespace
+{
+	// Size of the only display mode
+	const int WIDTH = 1280;
+	const int HEIGHT = 720;
+}
+
+NullRenderer::NullRenderer() : m_stats(), m_lastStats(), m_uiMaxFramesInFlight(2), m_iNextSpriteBatch(1)
+{
+	m_stats.resolutionScale = m_lastStats.resolutionScale = 1.0f;
+	m_stats.redrawn = m_lastStats.redrawn = 1.0f;
+}
+
+DLLType NullRenderer::GetPluginType() const
+{
+	return DLLType::Rendering;
+}
+
+const char* NullRenderer::GetName() const
+{
+	return "NullRenderer";
+}
+
+int NullRenderer::GetVersion() const
+{
+	return 0;
+}
+
+void NullRenderer::DrawLine(const glm::vec3* pArray, unsigned int length, float, const glm::vec4&, const glm::mat4&)
+{
+	if (pArray != nullptr)
+	{
+		AddDrawCall(1);
+	}
+}
+
+void NullRenderer::DrawCircle(const glm::vec3&, float, float, unsigned int, const glm::vec4&)
+{
+	AddDrawCall(1);
+}
+
+void NullRenderer::DrawString(const char* str, const glm::vec3&, const glm::vec4&, float, const char*, FontAlignment)
+{
+	if (str != nullptr)
+	{
+		AddDrawCall((unsigned int)std::strlen(str));
+	}
+}
+
+void NullRenderer::DrawSprite(const std::string&, const glm::mat4&, const glm::vec4&, const glm::vec2&, unsigned int, const std::string&)
+{
+	AddDrawCall(1);
+}
+
+void NullRenderer::DrawSprite(const glm::mat4&, const glm::vec4&, const glm::vec2&, unsigned int, const std::string&)
+{
+	AddDrawCall(1);
+}
+
+void NullRenderer::DrawSprites(const std::string&, const SpriteInstance* pArray, unsigned int length, const std::string&)
+{
+	if (pArray != nullptr)
+	{
+		AddDrawCall(length);
+	}
+}
+
+void NullRenderer::DrawSprites(const std::string&, const Sprite2D* pArray, unsigned int length, const std::string&)
+{
+	if (pArray != nullptr)
+	{
+		AddDrawCall(length);
+	}
+}
+
+void NullRenderer::DrawParticles(const std::string&, const ParticleVertex* pArray, unsigned int length, const std::string&)
+{
+	if (pArray != nullptr)
+	{
+		AddDrawCall(length);
+	}
+}
+
+void NullRenderer::DrawMesh(const std::string&, const std::string&, const glm::mat4&, const glm::vec4&, const std::string&)
+{
+	AddDrawCall(1);
+}
+
+int NullRenderer::CreateSpriteBatch()
+{
+	int index = m_iNextSpriteBatch++;
+	m_spriteBatches.emplace(index, 0);
+
+	return index;
+}
+
+void NullRenderer::DestroySpriteBatch(int batch)
+{
+	m_spriteBatches.erase(batch);
+}
+
+void NullRenderer::UpdateSpriteBatch(int batch, const SpriteInstance* pArray, unsigned int length)
+{
+	auto iter = m_spriteBatches.find(batch);
+	if (iter != m_spriteBatches.end())
+	{
+		iter->second = (pArray != nullptr) ? length : 0;
+	}
+}
+
+void NullRenderer::DrawSpriteBatch(int batch, const std::string&, const std::string&)
+{
+	auto iter = m_spriteBatches.find(batch);
+	if ((iter != m_spriteBatches.end()) && (iter->second > 0))
+	{
+		AddDrawCall(iter->second);
+	}
+}
+
+int NullRenderer::CreateCursor(const std::string&, int, int)
+{
+	return -1;
+}
+
+void NullRenderer::DestroyCursor(int)
+{
+}
+
+void NullRenderer::SetCursor(int)
+{
+}
+
+IResourceManager& NullRenderer::GetResourceManager()
+{
+	return m_rm;
+}
+
+const RenderStats& NullRenderer::GetStats(unsigned int) const
+{
+	return m_lastStats;
+}
+
+unsigned int NullRenderer::GetStatsHistorySize() const
+{
+	return 1;
+}
+
+void NullRenderer::AddCulled(unsigned int count)
+{
+	m_stats.culled += count;
+}
+
+bool NullRenderer::BeginCapture(const std::string&, unsigned int)
+{
+	return false;
+}
+
+bool NullRenderer::IsCapturing() const
+{
+	return false;
+}
+
+float NullRenderer::ReadPixels(const glm::ivec2&) const
+{
+	return 0.0f;
+}
+
+bool NullRenderer::GetDisplayMode(int monitor, int mode, int* width, int* height) const
+{
+	if ((monitor != 0) || (mode != 0))
+		return false;
+
+	return GetDisplayMode(width, height);
+}
+
+bool NullRenderer::GetDisplayMode(int* width, int* height, bool* vsync) const
+{
+	if (width != nullptr)
+	{
+		*width = WIDTH;
+	}
+
+	if (height != nullptr)
+	{
+		*height = HEIGHT;
+	}
+
+	if (vsync != nullptr)
+	{
+		*vsync = false;
+	}
+
+	return true;
+}
+
+int NullRenderer::GetNumMonitors() const
+{
+	return 1;
+}
+
+int NullRenderer::GetNumDisplayModes(int monitor) const
+{
+	return (monitor == 0) ? 1 : 0;
+}
+
+void NullRenderer::GetStringRect(const char* str, float scale, FontAlignment alignment, Math::FRECT& out) const
+{
+	float fWidth = (str != nullptr) ? std::strlen(str) * scale * 0.5f : 0.0f;
+
+	if (alignment == FontAlignment::Center)
+	{
+		out.topLeft.x -= fWidth * 0.5f;
+	}
+	else if (alignment == FontAlignment::Right)
+	{
+		out.topLeft.x -= fWidth;
+	}
+
+	out.bottomRight = glm::vec2(out.topLeft.x + fWidth, out.topLeft.y - scale);
+}
+
+void NullRenderer::SetCamera(PerspectiveCamera*)
+{
+}
+
+void NullRenderer::SetClearColor(const glm::vec3&)
+{
+}
+
+void NullRenderer::EnableColorClearing(bool)
+{
+}
+
+void NullRenderer::SetDisplayMode(int)
+{
+}
+
+void NullRenderer::SetFullscreen(bool)
+{
+}
+
+bool NullRenderer::IsFullscreen() const
+{
+	return false;
+}
+
+void NullRenderer::SetRenderSpace(RenderSpace)
+{
+}
+
+void NullRenderer::SetShaderValue(const std::string&, const std::string&, float)
+{
+}
+
+void NullRenderer::SetShaderValue(const std::string&, const std::string&, const glm::vec2&)
+{
+}
+
+void NullRenderer::EnableVSync(bool)
+{
+}
+
+bool NullRenderer::IsIconified() const
+{
+	return false;
+}
+
+void NullRenderer::SetResolutionBudget(double)
+{
+}
+
+void NullRenderer::EnableRenderThread(bool)
+{
+}
+
+void NullRenderer::EnableFrameElision(bool)
+{
+}
+
+void NullRenderer::SetMaxFramesInFlight(unsigned int frames)
+{
+	m_uiMaxFramesInFlight = frames;
+}
+
+unsigned int NullRenderer::GetMaxFramesInFlight() const
+{
+	return m_uiMaxFramesInFlight;
+}
+
+void NullRenderer::WaitForFrames()
+{
+}
+
+void NullRenderer::Present()
+{
+	m_lastStats = m_stats;
+
+	m_stats = RenderStats();
+	m_stats.resolutionScale = 1.0f;
+	m_stats.redrawn = 1.0f;
+}
+
+void NullRenderer::AddDrawCall(unsigned int instances)
+{
+	++m_stats.drawCalls;
+	m_stats.instances += instances;
+}
@@ -0,0 +1,103 @@
+#ifndef _NULLRENDERER_
+#define _NULLRENDERER_
+
+#include "IRenderer.h"
+#include "PluginManager.h"
+#include "NullResourceManager.h"
+
+#include <map>
+
+// Renderer plug-in that draws nothing, used to benchmark the engine without the cost of rendering
+// No window or context is created, so it runs without a display, along with the NullInput plug-in
+// Draw calls are only counted, see GetStats()
+class NullRenderer final : public IRenderer
+{
+public:
+
+	NullRenderer();
+
+	// IPlugin
+	DLLType GetPluginType() const override;
+	const char* GetName() const override;
+	int GetVersion() const override;
+
+	// IRenderer
+	void DrawLine(const glm::vec3* pArray, unsigned int length, float fWidth = 3.0f, const glm::vec4& color = glm::vec4(1.0f), const glm::mat4& t = glm::mat4(1.0f)) override;
+	void DrawCircle(const glm::vec3& center, float radius, float thickness, unsigned int segments, const glm::vec4& color) override;
+	void DrawString(const char* str, const glm::vec3& pos, const glm::vec4& color = glm::vec4(1.0f), float scale = 50.0f, const char* font = nullptr, FontAlignment alignment = FontAlignment::Left) override;
+	void DrawSprite(const std::string& texture, const glm::mat4& transformation, const glm::vec4& color = glm::vec4(1.0f), const glm::vec2& tiling = glm::vec2(1.0f), unsigned int iCellId = 0, const std::string& tech = "sprite") override;
+	void DrawSprite(const glm::mat4& transformation, const glm::vec4& color = glm::vec4(1.0f), const glm::vec2& tiling = glm::vec2(1.0f), unsigned int iCellId = 0, const std::string& tech = "sprite") override;
+	void DrawSprites(const std::string& texture, const SpriteInstance* pArray, unsigned int length, const std::string& tech = "spriteBatch") override;
+	void DrawSprites(const std::string& texture, const Sprite2D* pArray, unsigned int length, const std::string& tech = "sprite2D") override;
+	void DrawParticles(const std::string& texture, const ParticleVertex* pArray, unsigned int length, const std::string& tech = "particle") override;
+	void DrawMesh(const std::string& mesh, const std::string& texture, const glm::mat4& transformation, const glm::vec4& color = glm::vec4(1.0f), const std::string& tech = "sprite") override;
+
+	// Only the number of sprites of each batch is kept
+	int CreateSpriteBatch() override;
+	void DestroySpriteBatch(int batch) override;
+	void UpdateSpriteBatch(int batch, const SpriteInstance* pArray, unsigned int length) override;
+	void DrawSpriteBatch(int batch, const std::string& texture, const std::string& tech = "spriteBatch") override;
+
+	int CreateCursor(const std::string& texture, int xhot, int yhot) override;
+	void DestroyCursor(int cursor) override;
+	void SetCursor(int cursor) override;
+
+	IResourceManager& GetResourceManager() override;
+
+	// Only the draw calls and the instances are counted
+	const RenderStats& GetStats(unsigned int frame = 0) const override;
+	unsigned int GetStatsHistorySize() const override;
+	void AddCulled(unsigned int count) override;
+
+	// Nothing gets captured
+	bool BeginCapture(const std::string& file, unsigned int frames) override;
+	bool IsCapturing() const override;
+
+	float ReadPixels(const glm::ivec2& pos) const override;
+
+	bool GetDisplayMode(int monitor, int mode, int* width, int* height) const override;
+	bool GetDisplayMode(int* width, int* height, bool* vsync = nullptr) const override;
+	int GetNumMonitors() const override;
+	int GetNumDisplayModes(int monitor) const override;
+
+	// Estimates the rect with glyphs half as wide as they are high
+	void GetStringRect(const char* str, float scale, FontAlignment alignment, Math::FRECT& out) const override;
+
+	void SetCamera(class PerspectiveCamera*) override;
+	void SetClearColor(const glm::vec3& color) override;
+	void EnableColorClearing(bool bEnable) override;
+	void SetDisplayMode(int mode) override;
+	void SetFullscreen(bool bFullscreen) override;
+	bool IsFullscreen() const override;
+	void SetRenderSpace(RenderSpace) override;
+	void SetShaderValue(const std::string& shader, const std::string& location, float value) override;
+	void SetShaderValue(const std::string& shader, const std::string& location, const glm::vec2& value) override;
+	void EnableVSync(bool) override;
+	bool IsIconified() const override;
+	void SetResolutionBudget(double fBudget) override;
+	void EnableRenderThread(bool bEnable) override;
+	void EnableFrameElision(bool bEnable) override;
+	void SetMaxFramesInFlight(unsigned int frames) override;
+	unsigned int GetMaxFramesInFlight() const override;
+	void WaitForFrames() override;
+
+	// Ends the frame, no buffers are swapped
+	void Present() override;
+
+private:
+
+	NullResourceManager m_rm;
+
+	RenderStats m_stats; // stats of the frame being drawn
+	RenderStats m_lastStats; // stats of the last frame presented
+
+	unsigned int m_uiMaxFramesInFlight;
+
+	// batch -> number of sprites
+	std::map<int, unsigned int> m_spriteBatches;
+	int m_iNextSpriteBatch;
+
+	void AddDrawCall(unsigned int instances);
+};
+
+#endif // _NULLRENDERER_
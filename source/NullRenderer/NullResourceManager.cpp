@@ -0,0 +1,88 @@
+#include "NullResourceManager.h"
+
+bool NullResourceManager::LoadCursor(const std::string&, const std::string&)
+{
+	return true;
+}
+
+bool NullResourceManager::LoadTexture(const std::string&, const std::string&)
+{
+	return true;
+}
+
+bool NullResourceManager::LoadAnimation(const std::string&, const std::string&)
+{
+	return true;
+}
+
+bool NullResourceManager::LoadFont(const std::string&, const std::string&)
+{
+	return true;
+}
+
+bool NullResourceManager::LoadShader(const std::string&, const std::string&, const std::string&, const std::vector<std::string>&)
+{
+	return true;
+}
+
+bool NullResourceManager::LoadMesh(const std::string&, const std::string&)
+{
+	return true;
+}
+
+bool NullResourceManager::GetTextureInfo(const std::string&, TextureInfo&) const
+{
+	return false;
+}
+
+void NullResourceManager::Clear()
+{
+}
+
+void NullResourceManager::SetScope(const std::string&)
+{
+}
+
+void NullResourceManager::ReleaseScope(const std::string&)
+{
+}
+
+void NullResourceManager::AddRef(const std::string&)
+{
+}
+
+void NullResourceManager::Release(const std::string&)
+{
+}
+
+void NullResourceManager::SetTextureBudget(unsigned int)
+{
+}
+
+unsigned int NullResourceManager::GetTextureMemory() const
+{
+	return 0;
+}
+
+unsigned int NullResourceManager::GetScopeMemory(const std::string&) const
+{
+	return 0;
+}
+
+bool NullResourceManager::PrefetchImage(const std::string&)
+{
+	return true;
+}
+
+bool NullResourceManager::PrefetchMesh(const std::string&)
+{
+	return true;
+}
+
+void NullResourceManager::ClearPrefetched()
+{
+}
+
+void NullResourceManager::SetDeletionBudget(unsigned int)
+{
+}
@@ -0,0 +1,39 @@
+#ifndef _NULLRESOURCEMANAGER_
+#define _NULLRESOURCEMANAGER_
+
+#include "IResourceManager.h"
+
+// Resource manager of the null renderer, loading always succeeds without reading any file
+class NullResourceManager final : public IResourceManager
+{
+public:
+
+	bool LoadCursor(const std::string& id, const std::string& file) override;
+	bool LoadTexture(const std::string& id, const std::string& file) override;
+	bool LoadAnimation(const std::string& id, const std::string& file) override;
+	bool LoadFont(const std::string& id, const std::string& file) override;
+	bool LoadShader(const std::string& id, const std::string& vert, const std::string& frag, const std::vector<std::string>& features = std::vector<std::string>()) override;
+	bool LoadMesh(const std::string& id, const std::string& file) override;
+
+	// Always false, the images are never read
+	bool GetTextureInfo(const std::string& id, TextureInfo& out) const override;
+
+	void Clear() override;
+
+	void SetScope(const std::string& scope) override;
+	void ReleaseScope(const std::string& scope) override;
+	void AddRef(const std::string& id) override;
+	void Release(const std::string& id) override;
+
+	void SetTextureBudget(unsigned int uiBytes) override;
+	unsigned int GetTextureMemory() const override;
+	unsigned int GetScopeMemory(const std::string& scope) const override;
+
+	bool PrefetchImage(const std::string& file) override;
+	bool PrefetchMesh(const std::string& file) override;
+	void ClearPrefetched() override;
+
+	void SetDeletionBudget(unsigned int uiObjects) override;
+};
+
+#endif // _NULLRESOURCEMANAGER_
@@ -1,15 +1,18 @@
 #include "AbstractRenderer.h"
 #include "SpriteRenderer.h"
+#include "SpriteBatchRenderer.h"
 #include "FontRenderer.h"
 #include "LineRenderer.h"
+#include "ParticleRenderer.h"
+#include "MeshRenderer.h"
 #include "VertexStructures.h"
 #include "ApplyShader.h"
 
 #include <cassert>
 #include <algorithm>
 
-AbstractRenderer::AbstractRenderer(ResourceManager *pRm, std::shared_ptr<Mesh> pMesh, Camera *pCam) :
-	m_pRM(pRm), m_pMesh(pMesh), m_pCamera(pCam)
+AbstractRenderer::AbstractRenderer(ResourceManager *pRm, std::shared_ptr<Mesh> pMesh, std::shared_ptr<ParticleBuffer> pParticleBuffer, std::shared_ptr<SpriteBuffer> pSpriteBuffer, std::shared_ptr<Sprite2DBuffer> pSprite2DBuffer, Camera *pCam) :
+	m_pRM(pRm), m_pMesh(pMesh), m_pParticleBuffer(pParticleBuffer), m_pSpriteBuffer(pSpriteBuffer), m_pSprite2DBuffer(pSprite2DBuffer), m_pCamera(pCam), m_bResolved(false)
 {
 }
 
@@ -22,7 +25,7 @@ void AbstractRenderer::DrawSprite(const std::string& tech,
 							  )
 {
 	int iZorder = { (int)floor(transformation[3].z) };
-	m_spriteLayers[iZorder][tech][texture].emplace_back(new SpriteRenderable{transformation, color, tiling, iCellId});
+	GetBatch(iZorder, tech, texture).renderables.emplace_back(new SpriteRenderable{transformation, color, tiling, iCellId});
 }
 
 void AbstractRenderer::DrawString(const char* str,
@@ -41,7 +44,7 @@ void AbstractRenderer::DrawString(const char* str,
 		}
 
 		int iZorder = {(int)floor(pos.z)};
-		m_spriteLayers[iZorder]["textShader"][font].emplace_back(new FontRenderable{ str, pos, scale, color, alignment });
+		GetBatch(iZorder, "textShader", font).renderables.emplace_back(new FontRenderable{ str, pos, scale, color, alignment });
 	}
 }
 
@@ -52,16 +55,119 @@ void AbstractRenderer::DrawLine(const glm::vec3* pArray, unsigned int length, fl
 		if (length > 0)
 		{
 			int iZorder = { (int)pArray[0].z };
-			m_spriteLayers[iZorder]["lineShader"][""].emplace_back(new LineRenderer{ pArray, length, fWidth, color, T });
+			GetBatch(iZorder, "lineShader", "").renderables.emplace_back(new LineRenderer{ pArray, length, fWidth, color, T });
 		}
 	}
 }
 
+void AbstractRenderer::DrawSprites(const std::string& tech, const std::string& texture, const SpriteInstance* pArray, unsigned int length)
+{
+	if ((pArray != nullptr) && (length > 0))
+	{
+		unsigned int uiOffset = (unsigned int)m_spriteInstances.size();
+		m_spriteInstances.insert(m_spriteInstances.end(), pArray, pArray + length);
+
+		int iZorder = { (int)floor(pArray[0].transformation[3].z) };
+		GetBatch(iZorder, tech, texture).renderables.emplace_back(new SpriteBatchRenderable<SpriteBuffer>{ m_pSpriteBuffer.get(), &m_spriteInstances, uiOffset, length });
+	}
+}
+
+void AbstractRenderer::DrawSprites(const std::string& tech, const std::string& texture, const Sprite2D* pArray, unsigned int length)
+{
+	if ((pArray != nullptr) && (length > 0))
+	{
+		unsigned int uiOffset = (unsigned int)m_sprite2DInstances.size();
+		m_sprite2DInstances.insert(m_sprite2DInstances.end(), pArray, pArray + length);
+
+		int iZorder = { (int)floor(pArray[0].layer) };
+		GetBatch(iZorder, tech, texture).renderables.emplace_back(new SpriteBatchRenderable<Sprite2DBuffer>{ m_pSprite2DBuffer.get(), &m_sprite2DInstances, uiOffset, length });
+	}
+}
+
+void AbstractRenderer::DrawSpriteBatch(const std::string& tech, const std::string& texture, const std::shared_ptr<StaticSpriteBatch>& pBatch)
+{
+	if (pBatch != nullptr)
+	{
+		GetBatch(pBatch->GetLayer(), tech, texture).renderables.emplace_back(new StaticSpriteBatchRenderable{ m_pSpriteBuffer.get(), pBatch });
+	}
+}
+
+void AbstractRenderer::DrawParticles(const std::string& tech, const std::string& texture, const ParticleVertex* pArray, unsigned int length)
+{
+	if ((pArray != nullptr) && (length > 0))
+	{
+		unsigned int uiOffset = (unsigned int)m_particleInstances.size();
+		m_particleInstances.insert(m_particleInstances.end(), pArray, pArray + length);
+
+		int iZorder = { (int)floor(pArray[0].pos.z) };
+		GetBatch(iZorder, tech, texture).renderables.emplace_back(new ParticleRenderable{ m_pParticleBuffer.get(), &m_particleInstances, uiOffset, length });
+	}
+}
+
+void AbstractRenderer::DrawMesh(const std::string& tech, const std::string& texture, const std::string& mesh, const glm::mat4& transformation, const glm::vec4& color)
+{
+	const StaticMesh* pMesh = static_cast<const StaticMesh*>(m_pRM->GetResource(mesh, ResourceType::Mesh));
+	if (pMesh != nullptr)
+	{
+		int iZorder = { (int)floor(transformation[3].z) };
+		GetBatch(iZorder, tech, texture).renderables.emplace_back(new MeshRenderable{ &m_pRM->GetMeshPool(), pMesh->GetRange(), transformation, color });
+	}
+}
+
+unsigned int AbstractRenderer::GetTextureFeatures(const std::string& texture, IResource* pResource) const
+{
+	// Sprites without a texture are drawn with the blank texture, which only needs the color
+	if ((pResource == nullptr) || (texture == "blank"))
+		return 0;
+
+	unsigned int features = SHADER_TEXTURE | SHADER_ALPHA_TEST;
+
+	const Texture* pTexture = static_cast<const Texture*>(pResource->QueryInterface(ResourceType::Texture));
+	if ((pTexture != nullptr) && ((pTexture->GetCellsWidth() > 1) || (pTexture->GetCellsHeight() > 1)))
+	{
+		features |= SHADER_ANIMATION;
+	}
+
+	return features;
+}
+
+AbstractRenderer::Batch& AbstractRenderer::GetBatch(int iZorder, const std::string& tech, const std::string& texture)
+{
+	m_bResolved = false;
+	return m_spriteLayers[iZorder][tech][texture];
+}
+
 void AbstractRenderer::SetCamera(Camera* pCam)
 {
 	m_pCamera = pCam;
 }
 
+void AbstractRenderer::Resolve()
+{
+	for(auto& layerIter : m_spriteLayers)
+	{
+		for(auto& techIter : layerIter.second)
+		{
+			for (auto& texIter : techIter.second)
+			{
+				Batch& batch = texIter.second;
+				batch.pResource = m_pRM->GetResource(texIter.first);
+
+				// Select the cheapest variant of the tech that can render the whole batch
+				unsigned int features = GetTextureFeatures(texIter.first, batch.pResource);
+				for (auto& spriteIter : batch.renderables)
+				{
+					features |= spriteIter->GetShaderFeatures();
+				}
+
+				batch.pShader = m_pRM->GetShader(techIter.first, features);
+			}
+		}
+	}
+
+	m_bResolved = true;
+}
+
 void AbstractRenderer::Render()
 {
 	// if there is nothing to draw, do nothing
@@ -70,6 +176,11 @@ void AbstractRenderer::Render()
 
 	assert(m_pCamera != nullptr);
 
+	if (!m_bResolved)
+	{
+		Resolve();
+	}
+
 	m_pMesh->Bind();
 
 	glEnable(GL_BLEND);
@@ -81,24 +192,34 @@ void AbstractRenderer::Render()
 		// Loop over all sprites with the same tech
 		for(auto& techIter : layerIter.second)
 		{
-			// Apply the shader tech
-			IResource* pShader = m_pRM->GetResource(techIter.first, ResourceType::Shader);
-			if (pShader != nullptr)
+			// The shader stays bound until a batch needs a different variant
+			Shader* pBound = nullptr;
+			std::unique_ptr<ApplyShader> pCurrentShader;
+
+			// Loop over all sprites with the same texture
+			for (auto& texIter : techIter.second)
 			{
-				ApplyShader currentShader = static_cast<Shader*>(pShader);
-				currentShader->SetMVP(m_pCamera->ViewProj());
+				const Batch& batch = texIter.second;
 
-				// Loop over all sprites with the same texture
-				for (auto& texIter : techIter.second)
+				Shader* pShader = batch.pShader;
+				if (pShader == nullptr)
+					break;
+
+				if (pShader != pBound)
+				{
+					pCurrentShader.reset();
+					pCurrentShader.reset(new ApplyShader(pShader));
+					(*pCurrentShader)->SetMVP(m_pCamera->ViewProj());
+					pBound = pShader;
+				}
+
+				ApplyShader& currentShader = *pCurrentShader;
+				currentShader->ApplyResource(batch.pResource);
+
+				// Render
+				for (auto& spriteIter : batch.renderables)
 				{
-					IResource* pResource = m_pRM->GetResource(texIter.first);
-					currentShader->ApplyResource(pResource);
-
-					// Render
-					for (auto& spriteIter : texIter.second)
-					{
-						spriteIter->Render(*m_pMesh, currentShader, pResource);
-					}
+					spriteIter->Render(*m_pMesh, currentShader, batch.pResource);
 				}
 			}
 		}
@@ -106,7 +227,16 @@ void AbstractRenderer::Render()
 
 	glDisable(GL_BLEND);
 
+	Clear();
+}
+
+void AbstractRenderer::Clear()
+{
 	m_spriteLayers.clear();
+	m_spriteInstances.clear();
+	m_bResolved = false;
+	m_sprite2DInstances.clear();
+	m_particleInstances.clear();
 }
 
 
@@ -6,6 +6,8 @@
 #include "ResourceManager.h"
 #include "Camera.h"
 #include "Mesh.h"
+#include "InstanceBuffer.h"
+#include "StaticSpriteBatch.h"
 #include <map>
 #include <string>
 #include <vector>
@@ -20,7 +22,7 @@ class AbstractRenderer
 {
 public:
 
-	AbstractRenderer(ResourceManager* pRm, std::shared_ptr<Mesh> pMesh, Camera* pCam = nullptr);
+	AbstractRenderer(ResourceManager* pRm, std::shared_ptr<Mesh> pMesh, std::shared_ptr<ParticleBuffer> pParticleBuffer, std::shared_ptr<SpriteBuffer> pSpriteBuffer, std::shared_ptr<Sprite2DBuffer> pSprite2DBuffer, Camera* pCam = nullptr);
 
 	void DrawSprite(const std::string& tech,
 					const std::string& texture,
@@ -43,20 +45,81 @@ public:
 				  const glm::vec4& color, // color of the line
 				  const glm::mat4& t); // transformation to apply to the line
 
+	void DrawSprites(const std::string& tech,
+					 const std::string& texture,
+					 const SpriteInstance* pArray, // array of sprites to draw
+					 unsigned int length); // number of sprites
+
+	void DrawSprites(const std::string& tech,
+					 const std::string& texture,
+					 const Sprite2D* pArray, // array of sprites to draw
+					 unsigned int length); // number of sprites
+
+	// The batch is not copied, it stays alive until the cached sprites are rendered or cleared
+	void DrawSpriteBatch(const std::string& tech,
+						 const std::string& texture,
+						 const std::shared_ptr<StaticSpriteBatch>& pBatch);
+
+	void DrawParticles(const std::string& tech,
+					   const std::string& texture,
+					   const ParticleVertex* pArray, // array of particles to draw
+					   unsigned int length); // number of particles
+
+	void DrawMesh(const std::string& tech,
+				  const std::string& texture,
+				  const std::string& mesh,
+				  const glm::mat4& transformation,
+				  const glm::vec4& color);
+
 	void SetCamera(Camera* pCam);
 
+	// Looks up the texture and the shader variant of each batch, so that Render() does not touch the resource manager
+	// Must be called by the thread that owns the resource manager, Render() calls it if the batches have not been resolved
+	void Resolve();
+
 	// Renders all of the cached sprites
 	void Render();
 
+	// Discards all of the cached sprites without rendering them
+	void Clear();
+
 private:
 
 	ResourceManager* m_pRM;
 	std::shared_ptr<Mesh> m_pMesh;
+	std::shared_ptr<ParticleBuffer> m_pParticleBuffer;
+	std::shared_ptr<SpriteBuffer> m_pSpriteBuffer;
+	std::shared_ptr<Sprite2DBuffer> m_pSprite2DBuffer;
+
+	// Sprites and particles submitted in bulk this frame, each batch references a range of the stream
+	// The streams keep their capacity between frames, so submitting does not allocate once they have grown
+	std::vector<SpriteInstance> m_spriteInstances;
+	std::vector<Sprite2D> m_sprite2DInstances;
+	std::vector<ParticleVertex> m_particleInstances;
 
 	Camera* m_pCamera;
 
-	// z level -> map of techniques -> map of textures -> vector of sprites
-	std::map<int,std::map<std::string,std::map<std::string, std::vector<std::unique_ptr<IRenderable>>>>> m_spriteLayers; // std::vector<std::unique_ptr<IRenderable>>
+	// Sprites drawn with the same tech and texture
+	struct Batch
+	{
+		std::vector<std::unique_ptr<IRenderable>> renderables;
+		IResource* pResource; // texture, set by Resolve()
+		Shader* pShader; // cheapest variant of the tech that can render the whole batch, set by Resolve()
+
+		Batch() : pResource(nullptr), pShader(nullptr) {}
+	};
+
+	// true once Resolve() has been called for every batch
+	bool m_bResolved;
+
+	// Returns the shader features needed to draw with the texture, see ShaderFeature
+	unsigned int GetTextureFeatures(const std::string& texture, IResource* pResource) const;
+
+	// Returns the batch the sprite gets added to
+	Batch& GetBatch(int iZorder, const std::string& tech, const std::string& texture);
+
+	// z level -> map of techniques -> map of textures -> batch of sprites
+	std::map<int,std::map<std::string,std::map<std::string, Batch>>> m_spriteLayers;
 };
 
 #endif
@@ -0,0 +1,138 @@
+#include "DeletionQueue.h"
+
+std::atomic<unsigned int> DeletionQueue::s_uiBudget(0);
+
+DeletionQueue::DeletionQueue()
+{
+}
+
+DeletionQueue& DeletionQueue::Instance()
+{
+	static thread_local DeletionQueue instance;
+	return instance;
+}
+
+void DeletionQueue::DeleteTexture(GLuint id)
+{
+	Queue(ObjectType::Texture, id);
+}
+
+void DeletionQueue::DeleteProgram(GLuint id)
+{
+	Queue(ObjectType::Program, id);
+}
+
+void DeletionQueue::DeleteBuffer(GLuint id)
+{
+	Queue(ObjectType::Buffer, id);
+}
+
+void DeletionQueue::DeleteVertexArray(GLuint id)
+{
+	Queue(ObjectType::VertexArray, id);
+}
+
+void DeletionQueue::DeleteFramebuffer(GLuint id)
+{
+	Queue(ObjectType::Framebuffer, id);
+}
+
+void DeletionQueue::DeleteRenderbuffer(GLuint id)
+{
+	Queue(ObjectType::Renderbuffer, id);
+}
+
+void DeletionQueue::SetBudget(unsigned int uiObjects)
+{
+	s_uiBudget = uiObjects;
+}
+
+void DeletionQueue::EndFrame()
+{
+	if (!m_current.empty())
+	{
+		Frame frame;
+		frame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		frame.objects.swap(m_current);
+
+		m_pending.push_back(std::move(frame));
+	}
+
+	// Frames complete in order, so stop at the first fence that has not been signaled
+	while (!m_pending.empty())
+	{
+		Frame& frame = m_pending.front();
+
+		GLenum result = glClientWaitSync(frame.fence, 0, 0);
+		if ((result != GL_ALREADY_SIGNALED) && (result != GL_CONDITION_SATISFIED))
+			break;
+
+		glDeleteSync(frame.fence);
+		m_retired.insert(m_retired.end(), frame.objects.begin(), frame.objects.end());
+		m_pending.pop_front();
+	}
+
+	const unsigned int uiBudget = s_uiBudget;
+	unsigned int uiDeleted = 0;
+	while (!m_retired.empty() && ((uiBudget == 0) || (uiDeleted < uiBudget)))
+	{
+		Delete(m_retired.front());
+		m_retired.pop_front();
+		++uiDeleted;
+	}
+}
+
+void DeletionQueue::Flush()
+{
+	for (auto& frame : m_pending)
+	{
+		glDeleteSync(frame.fence);
+		m_retired.insert(m_retired.end(), frame.objects.begin(), frame.objects.end());
+	}
+
+	m_retired.insert(m_retired.end(), m_current.begin(), m_current.end());
+
+	for (auto& object : m_retired)
+	{
+		Delete(object);
+	}
+
+	m_current.clear();
+	m_pending.clear();
+	m_retired.clear();
+}
+
+void DeletionQueue::Queue(ObjectType type, GLuint id)
+{
+	// Deleting 0 is silently ignored by OpenGL
+	if (id != 0)
+	{
+		Object object = { type, id };
+		m_current.push_back(object);
+	}
+}
+
+void DeletionQueue::Delete(const Object& object)
+{
+	switch (object.type)
+	{
+	case ObjectType::Texture:
+		glDeleteTextures(1, &object.id);
+		break;
+	case ObjectType::Program:
+		glDeleteProgram(object.id);
+		break;
+	case ObjectType::Buffer:
+		glDeleteBuffers(1, &object.id);
+		break;
+	case ObjectType::VertexArray:
+		glDeleteVertexArrays(1, &object.id);
+		break;
+	case ObjectType::Framebuffer:
+		glDeleteFramebuffers(1, &object.id);
+		break;
+	case ObjectType::Renderbuffer:
+		glDeleteRenderbuffers(1, &object.id);
+		break;
+	}
+}
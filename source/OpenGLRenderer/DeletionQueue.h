@@ -0,0 +1,80 @@
+#ifndef _DELETIONQUEUE_
+#define _DELETIONQUEUE_
+
+#include <GL/glew.h>
+#include <atomic>
+#include <deque>
+#include <vector>
+
+// Delays the deletion of OpenGL objects until the GPU has finished the frames that may still use them
+// Objects released during a frame are retired behind a fence inserted at the end of that frame,
+// so unloading many resources at once does not stall the frame that released them
+class DeletionQueue
+{
+public:
+
+	// Each thread has its own queue, so that objects get deleted by the context that was current when they were released
+	static DeletionQueue& Instance();
+
+	// Queue an object to be deleted once the current frame has completed on the GPU
+	void DeleteTexture(GLuint id);
+	void DeleteProgram(GLuint id);
+	void DeleteBuffer(GLuint id);
+	void DeleteVertexArray(GLuint id);
+	void DeleteFramebuffer(GLuint id);
+	void DeleteRenderbuffer(GLuint id);
+
+	// Maximum number of objects deleted per frame by each queue, 0 means no limit
+	// The budget is shared by the queues of every thread, so it also applies to the render thread
+	// Objects over the budget are deleted during the following frames
+	static void SetBudget(unsigned int uiObjects);
+
+	// Called once per frame after the frame has been submitted
+	// Fences the objects released during the frame and deletes the objects of completed frames
+	void EndFrame();
+
+	// Deletes every queued object immediately, must be called before the context is destroyed
+	void Flush();
+
+private:
+
+	enum class ObjectType
+	{
+		Texture,
+		Program,
+		Buffer,
+		VertexArray,
+		Framebuffer,
+		Renderbuffer
+	};
+
+	struct Object
+	{
+		ObjectType type;
+		GLuint id;
+	};
+
+	struct Frame
+	{
+		GLsync fence;
+		std::vector<Object> objects;
+	};
+
+	DeletionQueue();
+
+	void Queue(ObjectType type, GLuint id);
+	void Delete(const Object& object);
+
+	// Objects released during the current frame
+	std::vector<Object> m_current;
+
+	// Frames waiting for their fence, oldest first
+	std::deque<Frame> m_pending;
+
+	// Objects of completed frames waiting for the budget
+	std::deque<Object> m_retired;
+
+	static std::atomic<unsigned int> s_uiBudget;
+};
+
+#endif // _DELETIONQUEUE_
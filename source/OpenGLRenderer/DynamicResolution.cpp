@@ -0,0 +1,202 @@
+#include "DynamicResolution.h"
+#include "DeletionQueue.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// Lowest fraction of the window resolution the pass can be rendered at
+	const float MIN_SCALE = 0.5f;
+
+	// The scale only grows back once the GPU time is below this fraction of the budget, to avoid oscillating around the budget
+	const double GROW_THRESHOLD = 0.85;
+	const float GROW_STEP = 0.02f;
+
+	// The scaled size is rounded to a multiple of this many pixels so that small changes in GPU time do not resize the pass every frame
+	const int SIZE_GRANULARITY = 8;
+}
+
+DynamicResolution::DynamicResolution() : m_framebuffer(0), m_colorTexture(0), m_depthBuffer(0), m_iWidth(0), m_iHeight(0),
+m_iScaledWidth(0), m_iScaledHeight(0), m_fScale(1.0f), m_fBudget(0.0), m_fGPUTime(0.0), m_uiQuery(0)
+{
+	m_queries.fill(0);
+	m_bIssued.fill(false);
+}
+
+void DynamicResolution::SetBudget(double fBudget)
+{
+	m_fBudget = fBudget;
+
+	if (fBudget <= 0.0)
+	{
+		Release();
+	}
+}
+
+bool DynamicResolution::IsEnabled() const
+{
+	return m_fBudget > 0.0;
+}
+
+void DynamicResolution::Begin(int width, int height, GLbitfield clearBits)
+{
+	if ((width != m_iWidth) || (height != m_iHeight) || (m_framebuffer == 0))
+	{
+		Resize(width, height);
+	}
+
+	// Read the oldest query before reusing it
+	if (m_bIssued[m_uiQuery])
+	{
+		GLuint available = GL_FALSE;
+		glGetQueryObjectuiv(m_queries[m_uiQuery], GL_QUERY_RESULT_AVAILABLE, &available);
+
+		if (available == GL_TRUE)
+		{
+			GLuint64 elapsed = 0;
+			glGetQueryObjectui64v(m_queries[m_uiQuery], GL_QUERY_RESULT, &elapsed);
+
+			m_fGPUTime = elapsed * 1e-9;
+			UpdateScale(m_fGPUTime);
+		}
+	}
+
+	m_iScaledWidth = std::max(SIZE_GRANULARITY, ((int)(m_iWidth * m_fScale) / SIZE_GRANULARITY) * SIZE_GRANULARITY);
+	m_iScaledHeight = std::max(SIZE_GRANULARITY, ((int)(m_iHeight * m_fScale) / SIZE_GRANULARITY) * SIZE_GRANULARITY);
+	m_iScaledWidth = std::min(m_iScaledWidth, m_iWidth);
+	m_iScaledHeight = std::min(m_iScaledHeight, m_iHeight);
+
+	glBeginQuery(GL_TIME_ELAPSED, m_queries[m_uiQuery]);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glViewport(0, 0, m_iScaledWidth, m_iScaledHeight);
+
+	// Only clear the area that is used
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(0, 0, m_iScaledWidth, m_iScaledHeight);
+	glClear(clearBits);
+	glDisable(GL_SCISSOR_TEST);
+}
+
+void DynamicResolution::End()
+{
+	glEndQuery(GL_TIME_ELAPSED);
+	m_bIssued[m_uiQuery] = true;
+	m_uiQuery = (m_uiQuery + 1) % m_queries.size();
+
+	GLenum filter = ((m_iScaledWidth == m_iWidth) && (m_iScaledHeight == m_iHeight)) ? GL_NEAREST : GL_LINEAR;
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	glBlitFramebuffer(0, 0, m_iScaledWidth, m_iScaledHeight, 0, 0, m_iWidth, m_iHeight, GL_COLOR_BUFFER_BIT, filter);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glViewport(0, 0, m_iWidth, m_iHeight);
+}
+
+float DynamicResolution::GetScale() const
+{
+	if ((m_iWidth == 0) || (m_iHeight == 0))
+		return 1.0f;
+
+	return (float)m_iScaledWidth / m_iWidth;
+}
+
+double DynamicResolution::GetGPUTime() const
+{
+	return m_fGPUTime;
+}
+
+float DynamicResolution::ReadDepth(const glm::ivec2& pos) const
+{
+	float depth = 1.0f;
+
+	if (m_framebuffer != 0)
+	{
+		// Map the window position into the area rendered last frame
+		int x = (int)(pos.x * (float)m_iScaledWidth / m_iWidth);
+		int y = (int)(pos.y * (float)m_iScaledHeight / m_iHeight);
+
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+		glReadPixels(x, y, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &depth);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	}
+
+	return depth;
+}
+
+void DynamicResolution::Release()
+{
+	DeletionQueue& queue = DeletionQueue::Instance();
+	queue.DeleteFramebuffer(m_framebuffer);
+	queue.DeleteTexture(m_colorTexture);
+	queue.DeleteRenderbuffer(m_depthBuffer);
+
+	if (m_queries[0] != 0)
+	{
+		glDeleteQueries((GLsizei)m_queries.size(), m_queries.data());
+	}
+
+	m_framebuffer = m_colorTexture = m_depthBuffer = 0;
+	m_iWidth = m_iHeight = 0;
+	m_fScale = 1.0f;
+	m_queries.fill(0);
+	m_bIssued.fill(false);
+}
+
+void DynamicResolution::Resize(int width, int height)
+{
+	DeletionQueue& queue = DeletionQueue::Instance();
+	queue.DeleteFramebuffer(m_framebuffer);
+	queue.DeleteTexture(m_colorTexture);
+	queue.DeleteRenderbuffer(m_depthBuffer);
+
+	if (m_queries[0] == 0)
+	{
+		glGenQueries((GLsizei)m_queries.size(), m_queries.data());
+	}
+
+	m_iWidth = width;
+	m_iHeight = height;
+
+	glGenTextures(1, &m_colorTexture);
+	glBindTexture(GL_TEXTURE_2D, m_colorTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glGenRenderbuffers(1, &m_depthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &m_framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_colorTexture, 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		Log::Instance().Write("Dynamic resolution framebuffer is incomplete");
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void DynamicResolution::UpdateScale(double fGPUTime)
+{
+	if (fGPUTime > m_fBudget)
+	{
+		// The cost of a fill bound pass is proportional to the area, so scale both sides by the square root
+		m_fScale *= (float)std::sqrt(m_fBudget / fGPUTime);
+	}
+	else if (fGPUTime < (m_fBudget * GROW_THRESHOLD))
+	{
+		m_fScale += GROW_STEP;
+	}
+
+	m_fScale = std::min(1.0f, std::max(MIN_SCALE, m_fScale));
+}
@@ -0,0 +1,71 @@
+#ifndef _DYNAMICRESOLUTION_
+#define _DYNAMICRESOLUTION_
+
+#include <GL/glew.h>
+#include <glm/vec2.hpp>
+#include <array>
+
+// Renders a pass into an offscreen framebuffer at a fraction of the window resolution, the result is upscaled into the window
+// The fraction is adjusted from timer queries so that the GPU time of the pass stays under a budget
+class DynamicResolution
+{
+public:
+
+	DynamicResolution();
+
+	// Sets the GPU time in seconds allowed for the pass, 0 disables dynamic resolution
+	void SetBudget(double fBudget);
+
+	// Returns true if the pass is rendered offscreen
+	bool IsEnabled() const;
+
+	// Binds and clears the offscreen framebuffer and starts timing the pass
+	// width, height: size of the window
+	void Begin(int width, int height, GLbitfield clearBits);
+
+	// Stops timing the pass, upscales it into the window and restores the viewport
+	void End();
+
+	// Returns the fraction of the window resolution the pass is rendered at
+	float GetScale() const;
+
+	// Returns the last GPU time of the pass measured, in seconds
+	double GetGPUTime() const;
+
+	// Returns the depth of the last frame at a position in window coordinates
+	float ReadDepth(const glm::ivec2& pos) const;
+
+	// Releases the GPU objects, must be called before the context is destroyed
+	void Release();
+
+private:
+
+	GLuint m_framebuffer;
+	GLuint m_colorTexture;
+	GLuint m_depthBuffer;
+
+	// Size of the window, the framebuffer is allocated at this size and only a corner of it is used
+	int m_iWidth;
+	int m_iHeight;
+
+	// Size of the area rendered this frame
+	int m_iScaledWidth;
+	int m_iScaledHeight;
+
+	float m_fScale;
+	double m_fBudget;
+	double m_fGPUTime;
+
+	// Timer queries are read a few frames after being issued so that the CPU never waits for the GPU
+	std::array<GLuint, 4> m_queries;
+	std::array<bool, 4> m_bIssued;
+	unsigned int m_uiQuery;
+
+	// Allocates the framebuffer at the size of the window
+	void Resize(int width, int height);
+
+	// Adjusts the scale from the GPU time of a previous frame
+	void UpdateScale(double fGPUTime);
+};
+
+#endif // _DYNAMICRESOLUTION_
@@ -0,0 +1,266 @@
+#include "FrameElision.h"
+#include "DeletionQueue.h"
+#include "Log.h"
+
+#include <glm/vec4.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// Above this fraction of the window, redrawing everything costs about the same as redrawing the region
+	const float MAX_REGION_AREA = 0.5f;
+}
+
+FrameElision::FrameElision() : m_bEnabled(false), m_bInvalid(true), m_bCached(false), m_state(HASH_SEED), m_lastState(HASH_SEED),
+m_framebuffer(0), m_colorBuffer(0), m_depthBuffer(0), m_iCacheWidth(0), m_iCacheHeight(0), m_iWidth(0), m_iHeight(0)
+{
+}
+
+void FrameElision::Enable(bool bEnable)
+{
+	m_bEnabled = bEnable;
+
+	m_commands.clear();
+	m_lastCommands.clear();
+	m_state = HASH_SEED;
+	m_bInvalid = true;
+
+	if (!bEnable)
+	{
+		Release();
+	}
+}
+
+bool FrameElision::IsEnabled() const
+{
+	return m_bEnabled;
+}
+
+void FrameElision::AddCommand(uint64_t hash, const Region* pBounds)
+{
+	Command command = { hash, { 0, 0, 0, 0 }, pBounds != nullptr };
+	if (pBounds != nullptr)
+	{
+		command.bounds = *pBounds;
+	}
+
+	m_commands.push_back(command);
+}
+
+void FrameElision::AddState(uint64_t hash)
+{
+	Hash(m_state, hash);
+}
+
+FrameElision::Redraw FrameElision::EndFrame(int width, int height, Region& region)
+{
+	region.x0 = 0;
+	region.y0 = 0;
+	region.x1 = width;
+	region.y1 = height;
+
+	Redraw redraw = Redraw::All;
+
+	if (!m_bInvalid && (width == m_iWidth) && (height == m_iHeight) && (m_state == m_lastState) && (m_commands.size() == m_lastCommands.size()))
+	{
+		Region dirty = { width, height, 0, 0 };
+		bool bChanged = false;
+		bool bUnbounded = false;
+
+		for (size_t i = 0; (i < m_commands.size()) && !bUnbounded; ++i)
+		{
+			const Command& command = m_commands[i];
+			const Command& last = m_lastCommands[i];
+
+			if (command.hash != last.hash)
+			{
+				bChanged = true;
+				bUnbounded = !command.bBounded || !last.bBounded;
+
+				// Both the area the command used to cover and the one it covers now need to be redrawn
+				dirty.x0 = std::min(dirty.x0, std::min(command.bounds.x0, last.bounds.x0));
+				dirty.y0 = std::min(dirty.y0, std::min(command.bounds.y0, last.bounds.y0));
+				dirty.x1 = std::max(dirty.x1, std::max(command.bounds.x1, last.bounds.x1));
+				dirty.y1 = std::max(dirty.y1, std::max(command.bounds.y1, last.bounds.y1));
+			}
+		}
+
+		if (!bChanged)
+		{
+			redraw = Redraw::None;
+		}
+		else if (!bUnbounded && m_bCached)
+		{
+			dirty.x0 = std::max(dirty.x0, 0);
+			dirty.y0 = std::max(dirty.y0, 0);
+			dirty.x1 = std::min(dirty.x1, width);
+			dirty.y1 = std::min(dirty.y1, height);
+
+			float area = (float)std::max(0, dirty.x1 - dirty.x0) * (float)std::max(0, dirty.y1 - dirty.y0);
+			if (area <= (MAX_REGION_AREA * width * height))
+			{
+				region = dirty;
+				redraw = Redraw::Region;
+			}
+		}
+	}
+
+	m_lastCommands.swap(m_commands);
+	m_commands.clear();
+
+	m_lastState = m_state;
+	m_state = HASH_SEED;
+
+	m_bInvalid = false;
+
+	// The cache is only valid again once the frame is rendered into it
+	if (redraw != Redraw::None)
+	{
+		m_bCached = false;
+	}
+
+	m_iWidth = width;
+	m_iHeight = height;
+
+	return redraw;
+}
+
+void FrameElision::Invalidate()
+{
+	m_bInvalid = true;
+}
+
+void FrameElision::BeginCached(int width, int height, GLbitfield clearBits, const Region& region)
+{
+	if ((m_framebuffer == 0) || (width != m_iCacheWidth) || (height != m_iCacheHeight))
+	{
+		Resize(width, height);
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(region.x0, region.y0, region.x1 - region.x0, region.y1 - region.y0);
+	glClear(clearBits);
+}
+
+void FrameElision::EndCached()
+{
+	glDisable(GL_SCISSOR_TEST);
+
+	// The back buffer is undefined after a swap, so the whole frame is copied every time
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	glBlitFramebuffer(0, 0, m_iCacheWidth, m_iCacheHeight, 0, 0, m_iCacheWidth, m_iCacheHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	m_bCached = true;
+}
+
+float FrameElision::ReadDepth(const glm::ivec2& pos) const
+{
+	float depth = 1.0f;
+
+	if (m_framebuffer != 0)
+	{
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+		glReadPixels(pos.x, pos.y, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &depth);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	}
+
+	return depth;
+}
+
+bool FrameElision::IsCached() const
+{
+	return m_bCached;
+}
+
+void FrameElision::Release()
+{
+	DeletionQueue& queue = DeletionQueue::Instance();
+	queue.DeleteFramebuffer(m_framebuffer);
+	queue.DeleteRenderbuffer(m_colorBuffer);
+	queue.DeleteRenderbuffer(m_depthBuffer);
+
+	m_framebuffer = m_colorBuffer = m_depthBuffer = 0;
+	m_iCacheWidth = m_iCacheHeight = 0;
+	m_bCached = false;
+	m_bInvalid = true;
+}
+
+void FrameElision::Hash(uint64_t& hash, const void* pData, size_t bytes)
+{
+	// FNV-1a
+	const unsigned char* pBytes = static_cast<const unsigned char*>(pData);
+	for (size_t i = 0; i < bytes; ++i)
+	{
+		hash ^= pBytes[i];
+		hash *= 1099511628211ull;
+	}
+}
+
+bool FrameElision::Project(const glm::vec3* pPoints, unsigned int count, const glm::mat4& T, const glm::mat4& viewProj, int width, int height, float padding, Region& out)
+{
+	glm::mat4 M = viewProj * T;
+
+	float x0 = (float)width, y0 = (float)height;
+	float x1 = 0.0f, y1 = 0.0f;
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		glm::vec4 clip = M * glm::vec4(pPoints[i], 1.0f);
+		if (clip.w <= 0.0f)
+			return false;
+
+		float x = (clip.x / clip.w * 0.5f + 0.5f) * width;
+		float y = (clip.y / clip.w * 0.5f + 0.5f) * height;
+
+		x0 = std::min(x0, x);
+		y0 = std::min(y0, y);
+		x1 = std::max(x1, x);
+		y1 = std::max(y1, y);
+	}
+
+	// Pad for antialiasing and for rounding to whole pixels
+	out.x0 = (int)std::floor(x0 - padding) - 1;
+	out.y0 = (int)std::floor(y0 - padding) - 1;
+	out.x1 = (int)std::ceil(x1 + padding) + 1;
+	out.y1 = (int)std::ceil(y1 + padding) + 1;
+
+	return true;
+}
+
+void FrameElision::Resize(int width, int height)
+{
+	DeletionQueue& queue = DeletionQueue::Instance();
+	queue.DeleteFramebuffer(m_framebuffer);
+	queue.DeleteRenderbuffer(m_colorBuffer);
+	queue.DeleteRenderbuffer(m_depthBuffer);
+
+	m_iCacheWidth = width;
+	m_iCacheHeight = height;
+
+	glGenRenderbuffers(1, &m_colorBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_colorBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+	glGenRenderbuffers(1, &m_depthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &m_framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorBuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		Log::Instance().Write("Frame cache framebuffer is incomplete");
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
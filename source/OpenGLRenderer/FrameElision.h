@@ -0,0 +1,116 @@
+#ifndef _FRAMEELISION_
+#define _FRAMEELISION_
+
+#include <GL/glew.h>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <cstdint>
+#include <vector>
+
+// Compares the commands submitted each frame with the ones of the last frame presented
+// Identical frames are not presented at all, and when only a few commands changed, only the area they cover is redrawn
+// Partial redraws are done on top of a cached copy of the last frame, since the back buffer is undefined after a swap
+class FrameElision
+{
+public:
+
+	// Area of the window in pixels, the origin is the bottom left corner
+	struct Region
+	{
+		int x0, y0;
+		int x1, y1;
+	};
+
+	enum class Redraw
+	{
+		None, // the frame is identical to the last one
+		Region, // only the region returned by EndFrame() changed
+		All
+	};
+
+	FrameElision();
+
+	void Enable(bool bEnable);
+	bool IsEnabled() const;
+
+	// Records a command submitted this frame
+	// hash: hash of every parameter of the command, see Hash()
+	// pBounds: area of the window covered by the command, null if unknown, in which case a change of the command redraws the whole window
+	void AddCommand(uint64_t hash, const Region* pBounds);
+
+	// Records state that applies to the whole frame, ex: the camera. A change of state redraws the whole window
+	void AddState(uint64_t hash);
+
+	// Compares the commands recorded this frame with the last frame, region is set to the area that needs to be redrawn
+	Redraw EndFrame(int width, int height, Region& region);
+
+	// Forces the next frame to be redrawn entirely, ex: after the window was exposed
+	void Invalidate();
+
+	// Binds the cached frame and clears the region that is about to be redrawn, drawing is restricted to the region
+	void BeginCached(int width, int height, GLbitfield clearBits, const Region& region);
+
+	// Copies the cached frame to the window
+	void EndCached();
+
+	// Returns the depth of the cached frame at a position in window coordinates
+	float ReadDepth(const glm::ivec2& pos) const;
+
+	// Returns true if the last frame was rendered into the cache
+	bool IsCached() const;
+
+	// Releases the GPU objects, must be called before the context is destroyed
+	void Release();
+
+	// Adds a block of memory to a hash
+	static void Hash(uint64_t& hash, const void* pData, size_t bytes);
+
+	template< class T >
+	static void Hash(uint64_t& hash, const T& value)
+	{
+		Hash(hash, &value, sizeof(T));
+	}
+
+	// Initial value of a hash
+	static const uint64_t HASH_SEED = 14695981039346656037ull;
+
+	// Computes the area of the window covered by points transformed by T and then projected by viewProj
+	// Returns false if a point is behind the camera
+	static bool Project(const glm::vec3* pPoints, unsigned int count, const glm::mat4& T, const glm::mat4& viewProj, int width, int height, float padding, Region& out);
+
+private:
+
+	struct Command
+	{
+		uint64_t hash;
+		Region bounds;
+		bool bBounded;
+	};
+
+	bool m_bEnabled;
+	bool m_bInvalid;
+	bool m_bCached;
+
+	// Commands of the frame being recorded and of the last frame presented
+	std::vector<Command> m_commands;
+	std::vector<Command> m_lastCommands;
+
+	uint64_t m_state;
+	uint64_t m_lastState;
+
+	GLuint m_framebuffer;
+	GLuint m_colorBuffer;
+	GLuint m_depthBuffer;
+	int m_iCacheWidth;
+	int m_iCacheHeight;
+
+	// Size of the window during the last frame
+	int m_iWidth;
+	int m_iHeight;
+
+	// Allocates the cached frame at the size of the window
+	void Resize(int width, int height);
+};
+
+#endif // _FRAMEELISION_
@@ -7,6 +7,10 @@ public:
 
 	virtual ~IRenderable() {}
 	virtual void Render(const class Mesh& mesh, class ApplyShader& shader, const class IResource* resource) = 0;
+
+	// Returns the shader features needed to render this object, see ShaderFeature
+	// Features needed by the texture are added by the renderer
+	virtual unsigned int GetShaderFeatures() const { return ~0u; }
 };
 
 #endif // _IRENDERABLE_
@@ -0,0 +1,92 @@
+#ifndef _INSTANCEBUFFER_
+#define _INSTANCEBUFFER_
+
+#include "IRenderer.h"
+#include "VertexBuffer.h"
+#include "RenderCounters.h"
+#include <memory>
+
+// Defines the buffers needed to draw a stream of instances as quads with a single draw call
+// The quad is stored in a static buffer while the instances are streamed into a separate instance buffer every frame
+template< class InstanceFormat >
+class InstanceBuffer
+{
+public:
+
+	typedef typename InstanceFormat::VertexType InstanceType;
+
+	InstanceBuffer()
+	{
+		unsigned short indexBuffer[6] = { 0, 2, 1,	2, 3, 1 };
+		VertexPT verticies[] =
+		{
+			{glm::vec3(-0.5f, 0.5f, 0.0f), glm::vec2(0)},
+			{glm::vec3(-0.5f, -0.5f, 0.0), glm::vec2(0,1)},
+			{glm::vec3(0.5f, 0.5f, 0.0), glm::vec2(1,0)},
+			{glm::vec3(0.5f, -0.5f, 0.0), glm::vec2(1)}
+		};
+
+		m_buffer.reset(new VertexBuffer<VertexFormatPT, InstanceFormat>(verticies, 4, GL_STATIC_DRAW, indexBuffer, sizeof(unsigned short), 6));
+	}
+
+	// Copies the instances into the instance buffer
+	void Upload(const InstanceType* pArray, unsigned int length)
+	{
+		m_buffer->UploadInstances(pArray, length);
+	}
+
+	// Reads the instances from a buffer that is not streamed, 0 restores the instance buffer
+	// The vertex array object must be bound
+	void SetInstanceBuffer(GLuint buffer)
+	{
+		m_buffer->SetInstanceBuffer(buffer);
+	}
+
+	// Binds the vertex array object
+	void Bind() const
+	{
+		m_buffer->BindVAO();
+	}
+
+	// Draws the first length instances that were uploaded
+	void Draw(unsigned int length) const
+	{
+		RenderCounters::Instance().Draw(6, length);
+		glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, 0, length);
+	}
+
+private:
+
+	std::unique_ptr<VertexBuffer<VertexFormatPT, InstanceFormat>> m_buffer;
+};
+
+// Per particle attributes, advanced once per instance
+typedef VertexFormat<ParticleVertex,
+	INSTANCE_ATTRIBUTE(2, ParticleVertex, pos),
+	INSTANCE_ATTRIBUTE(3, ParticleVertex, size),
+	INSTANCE_ATTRIBUTE_AS(4, ParticleVertex, color, NormalizedUByte4)> ParticleFormat;
+
+// Per sprite attributes, the transformation takes up the four locations 2 to 5, one per column
+typedef VertexFormat<SpriteInstance,
+	VertexAttribute<2, glm::vec4, offsetof(SpriteInstance, transformation), 1>,
+	VertexAttribute<3, glm::vec4, offsetof(SpriteInstance, transformation) + sizeof(glm::vec4), 1>,
+	VertexAttribute<4, glm::vec4, offsetof(SpriteInstance, transformation) + sizeof(glm::vec4) * 2, 1>,
+	VertexAttribute<5, glm::vec4, offsetof(SpriteInstance, transformation) + sizeof(glm::vec4) * 3, 1>,
+	INSTANCE_ATTRIBUTE(6, SpriteInstance, color),
+	INSTANCE_ATTRIBUTE(7, SpriteInstance, tiling),
+	INSTANCE_ATTRIBUTE(8, SpriteInstance, cellId)> SpriteFormat;
+
+// Per sprite attributes of the compact 2D sprite, the transformation is built in the vertex shader
+typedef VertexFormat<Sprite2D,
+	INSTANCE_ATTRIBUTE(2, Sprite2D, pos),
+	INSTANCE_ATTRIBUTE(3, Sprite2D, scale),
+	INSTANCE_ATTRIBUTE(4, Sprite2D, rotation),
+	INSTANCE_ATTRIBUTE(5, Sprite2D, layer),
+	INSTANCE_ATTRIBUTE_AS(6, Sprite2D, color, NormalizedUByte4),
+	INSTANCE_ATTRIBUTE(7, Sprite2D, cellId)> Sprite2DFormat;
+
+typedef InstanceBuffer<ParticleFormat> ParticleBuffer;
+typedef InstanceBuffer<SpriteFormat> SpriteBuffer;
+typedef InstanceBuffer<Sprite2DFormat> Sprite2DBuffer;
+
+#endif // _INSTANCEBUFFER_
@@ -1,4 +1,5 @@
 #include "Mesh.h"
+#include "RenderCounters.h"
 
 Mesh::Mesh() : m_mode(GL_TRIANGLES), m_count(6), m_type(GL_UNSIGNED_SHORT)
 {
@@ -11,15 +12,16 @@ Mesh::Mesh() : m_mode(GL_TRIANGLES), m_count(6), m_type(GL_UNSIGNED_SHORT)
 		{glm::vec3(0.5f, -0.5f, 0.0), glm::vec2(1)}
 	};
 
-	m_buffer.reset(new VertexBuffer(verticies, sizeof(VertexPT), 4, GL_STATIC_DRAW, indexBuffer, sizeof(unsigned short), 6));
+	m_buffer.reset(new VertexBuffer<VertexFormatPT>(verticies, 4, GL_STATIC_DRAW, indexBuffer, sizeof(unsigned short), 6));
 }
 
-void Mesh::Bind()
+void Mesh::Bind() const
 {
 	m_buffer->BindVAO();
 }
 
 void Mesh::Draw() const
 {
+	RenderCounters::Instance().Draw(m_count);
 	glDrawElements(m_mode, m_count, m_type, 0);
 }
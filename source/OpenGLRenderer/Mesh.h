@@ -10,11 +10,11 @@ public:
 
 	Mesh();
 
-	void Bind();
+	void Bind() const;
 	void Draw() const;
 
 private:
-	std::unique_ptr<VertexBuffer> m_buffer;
+	std::unique_ptr<VertexBuffer<VertexFormatPT>> m_buffer;
 	GLenum m_mode;
 	GLint m_count;
 	GLenum m_type;
@@ -0,0 +1,256 @@
+#include "MeshOptimizer.h"
+
+#include <unordered_map>
+#include <cstring>
+#include <cmath>
+#include <cassert>
+
+namespace
+{
+	// Hashes the raw bytes of a vertex
+	struct VertexHash
+	{
+		size_t operator()(const VertexPT& v) const
+		{
+			// FNV-1a
+			const unsigned char* pBytes = reinterpret_cast<const unsigned char*>(&v);
+			size_t hash = 2166136261u;
+			for(unsigned int i = 0; i < sizeof(VertexPT); ++i)
+			{
+				hash = (hash ^ pBytes[i]) * 16777619u;
+			}
+
+			return hash;
+		}
+	};
+
+	struct VertexEqual
+	{
+		bool operator()(const VertexPT& a, const VertexPT& b) const
+		{
+			return memcmp(&a, &b, sizeof(VertexPT)) == 0;
+		}
+	};
+
+	// Size of the simulated vertex cache
+	const int CACHE_SIZE = 32;
+
+	// Returns the score of a vertex based on its position in the cache and the number of triangles that still use it
+	float VertexScore(int iCachePos, unsigned int uiRemaining)
+	{
+		if(uiRemaining == 0)
+			return -1.0f;
+
+		float fScore = 0.0f;
+
+		if(iCachePos >= 0)
+		{
+			if(iCachePos < 3)
+			{
+				// The vertices of the last triangle are given a fixed score so that the next triangle does not reuse the same edge
+				fScore = 0.75f;
+			}
+			else
+			{
+				fScore = pow(1.0f - (iCachePos - 3) / (float)(CACHE_SIZE - 3), 1.5f);
+			}
+		}
+
+		// Boost vertices with few triangles left so that they are not left hanging around
+		fScore += 2.0f * pow((float)uiRemaining, -0.5f);
+
+		return fScore;
+	}
+}
+
+void DeduplicateVertices(std::vector<VertexPT>& vertices, std::vector<unsigned int>& indices)
+{
+	std::unordered_map<VertexPT, unsigned int, VertexHash, VertexEqual> unique;
+	unique.reserve(vertices.size());
+
+	std::vector<VertexPT> out;
+	out.reserve(vertices.size());
+
+	std::vector<unsigned int> remap(vertices.size());
+
+	for(unsigned int i = 0; i < vertices.size(); ++i)
+	{
+		auto iter = unique.emplace(vertices[i], (unsigned int)out.size());
+		if(iter.second)
+		{
+			out.push_back(vertices[i]);
+		}
+
+		remap[i] = iter.first->second;
+	}
+
+	for(auto& index : indices)
+	{
+		assert(index < remap.size());
+		index = remap[index];
+	}
+
+	vertices.swap(out);
+}
+
+void OptimizeVertexCache(std::vector<unsigned int>& indices, unsigned int vertexCount)
+{
+	const unsigned int uiTriCount = (unsigned int)indices.size() / 3;
+
+	// Build the list of triangles using each vertex
+	std::vector<unsigned int> remaining(vertexCount, 0);
+	for(auto index : indices)
+	{
+		remaining[index]++;
+	}
+
+	std::vector<unsigned int> offsets(vertexCount + 1, 0);
+	for(unsigned int v = 0; v < vertexCount; ++v)
+	{
+		offsets[v + 1] = offsets[v] + remaining[v];
+	}
+
+	std::vector<unsigned int> triangles(indices.size());
+	{
+		std::vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+		for(unsigned int t = 0; t < uiTriCount; ++t)
+		{
+			for(unsigned int k = 0; k < 3; ++k)
+			{
+				triangles[cursor[indices[t * 3 + k]]++] = t;
+			}
+		}
+	}
+
+	std::vector<int> cachePos(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	for(unsigned int v = 0; v < vertexCount; ++v)
+	{
+		vertexScore[v] = VertexScore(-1, remaining[v]);
+	}
+
+	std::vector<float> triScore(uiTriCount);
+	std::vector<bool> emitted(uiTriCount, false);
+	for(unsigned int t = 0; t < uiTriCount; ++t)
+	{
+		triScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+	}
+
+	std::vector<unsigned int> out;
+	out.reserve(indices.size());
+
+	std::vector<unsigned int> cache;
+	std::vector<unsigned int> newCache;
+	cache.reserve(CACHE_SIZE + 3);
+	newCache.reserve(CACHE_SIZE + 3);
+
+	int iBest = -1;
+	unsigned int uiScan = 0;
+
+	while(out.size() < indices.size())
+	{
+		// If none of the triangles touching the cache are left, continue with the next triangle in order
+		if(iBest < 0)
+		{
+			while(emitted[uiScan])
+			{
+				++uiScan;
+			}
+
+			iBest = uiScan;
+		}
+
+		const unsigned int* pTri = &indices[iBest * 3];
+		emitted[iBest] = true;
+
+		newCache.clear();
+
+		for(unsigned int k = 0; k < 3; ++k)
+		{
+			unsigned int v = pTri[k];
+			out.push_back(v);
+			newCache.push_back(v);
+
+			// Remove the triangle from the list of the vertex
+			unsigned int* pBegin = &triangles[offsets[v]];
+			unsigned int* pEnd = pBegin + remaining[v];
+			for(unsigned int* pIter = pBegin; pIter != pEnd; ++pIter)
+			{
+				if(*pIter == (unsigned int)iBest)
+				{
+					*pIter = *(pEnd - 1);
+					break;
+				}
+			}
+
+			remaining[v]--;
+		}
+
+		for(auto v : cache)
+		{
+			if((v != pTri[0]) && (v != pTri[1]) && (v != pTri[2]))
+			{
+				newCache.push_back(v);
+			}
+		}
+
+		// Update the scores of every vertex that was in the cache, vertices pushed out of the cache lose their position
+		for(unsigned int i = 0; i < newCache.size(); ++i)
+		{
+			unsigned int v = newCache[i];
+			cachePos[v] = (i < (unsigned int)CACHE_SIZE) ? (int)i : -1;
+			vertexScore[v] = VertexScore(cachePos[v], remaining[v]);
+		}
+
+		if(newCache.size() > (unsigned int)CACHE_SIZE)
+		{
+			newCache.resize(CACHE_SIZE);
+		}
+
+		cache.swap(newCache);
+
+		// Rescore the triangles touching the cache and pick the best one
+		iBest = -1;
+		float fBestScore = -1.0f;
+
+		for(auto v : cache)
+		{
+			for(unsigned int i = offsets[v]; i < (offsets[v] + remaining[v]); ++i)
+			{
+				unsigned int t = triangles[i];
+				triScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+				if(triScore[t] > fBestScore)
+				{
+					fBestScore = triScore[t];
+					iBest = (int)t;
+				}
+			}
+		}
+	}
+
+	indices.swap(out);
+}
+
+void OptimizeVertexFetch(std::vector<VertexPT>& vertices, std::vector<unsigned int>& indices)
+{
+	const unsigned int uiUnused = ~0u;
+
+	std::vector<unsigned int> remap(vertices.size(), uiUnused);
+
+	std::vector<VertexPT> out;
+	out.reserve(vertices.size());
+
+	for(auto& index : indices)
+	{
+		if(remap[index] == uiUnused)
+		{
+			remap[index] = (unsigned int)out.size();
+			out.push_back(vertices[index]);
+		}
+
+		index = remap[index];
+	}
+
+	vertices.swap(out);
+}
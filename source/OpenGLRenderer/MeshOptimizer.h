@@ -0,0 +1,18 @@
+#ifndef _MESHOPTIMIZER_
+#define _MESHOPTIMIZER_
+
+#include "VertexStructures.h"
+#include <vector>
+
+// Removes duplicate vertices and remaps the index buffer to the remaining vertices
+void DeduplicateVertices(std::vector<VertexPT>& vertices, std::vector<unsigned int>& indices);
+
+// Reorders the triangles of an indexed triangle list to improve post-transform vertex cache hits
+// Based on Tom Forsyth's linear-speed vertex cache optimization
+void OptimizeVertexCache(std::vector<unsigned int>& indices, unsigned int vertexCount);
+
+// Reorders the vertices in the order they are first referenced by the index buffer to improve pre-transform cache hits
+// Vertices that are not referenced are removed
+void OptimizeVertexFetch(std::vector<VertexPT>& vertices, std::vector<unsigned int>& indices);
+
+#endif // _MESHOPTIMIZER_
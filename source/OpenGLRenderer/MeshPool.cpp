@@ -0,0 +1,159 @@
+#include "MeshPool.h"
+#include "RenderCounters.h"
+
+#include <algorithm>
+#include <cassert>
+
+MeshPool::MeshPool() : m_bDirty(false)
+{
+}
+
+MeshRange MeshPool::Add(const std::vector<VertexPT>& vertices, const std::vector<unsigned int>& indices)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	GLuint uiNumVertices = (GLuint)m_vertices.size();
+	GLuint uiNumIndices = (GLuint)m_indices.size();
+
+	MeshRange range;
+	range.baseVertex = (GLint)Allocate(m_freeVertices, uiNumVertices, (GLuint)vertices.size());
+	range.firstIndex = Allocate(m_freeIndices, uiNumIndices, (GLuint)indices.size());
+	range.indexCount = (GLsizei)indices.size();
+	range.vertexCount = (GLsizei)vertices.size();
+
+	m_vertices.resize(uiNumVertices);
+	m_indices.resize(uiNumIndices);
+
+	std::copy(vertices.begin(), vertices.end(), m_vertices.begin() + range.baseVertex);
+	std::copy(indices.begin(), indices.end(), m_indices.begin() + range.firstIndex);
+
+	m_bDirty = true;
+
+	return range;
+}
+
+void MeshPool::Remove(const MeshRange& range)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	GLuint uiNumVertices = (GLuint)m_vertices.size();
+	GLuint uiNumIndices = (GLuint)m_indices.size();
+
+	Free(m_freeVertices, uiNumVertices, (GLuint)range.baseVertex, (GLuint)range.vertexCount);
+	Free(m_freeIndices, uiNumIndices, range.firstIndex, (GLuint)range.indexCount);
+
+	// The GPU buffers keep the removed mesh until they are rebuilt, nothing draws it anymore
+	m_vertices.resize(uiNumVertices);
+	m_indices.resize(uiNumIndices);
+}
+
+void MeshPool::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_vertices.clear();
+	m_indices.clear();
+	m_freeVertices.clear();
+	m_freeIndices.clear();
+	m_buffer.reset();
+	m_bDirty = false;
+}
+
+void MeshPool::ReleaseBuffer()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_buffer.reset();
+	m_bDirty = !m_indices.empty();
+}
+
+void MeshPool::Bind()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	assert(!m_indices.empty());
+
+	// All meshes loaded since the last frame are uploaded together
+	if(m_bDirty)
+	{
+		m_buffer.reset(new VertexBuffer<VertexFormatPT>(m_vertices.data(), (GLuint)m_vertices.size(), GL_STATIC_DRAW,
+														m_indices.data(), sizeof(unsigned int), (GLuint)m_indices.size()));
+		m_bDirty = false;
+	}
+
+	m_buffer->BindVAO();
+}
+
+void MeshPool::Draw(const MeshRange& range) const
+{
+	RenderCounters::Instance().Draw(range.indexCount);
+	glDrawElementsBaseVertex(GL_TRIANGLES, range.indexCount, GL_UNSIGNED_INT, reinterpret_cast<void*>(range.firstIndex * sizeof(unsigned int)), range.baseVertex);
+}
+
+GLuint MeshPool::Allocate(std::vector<FreeRange>& freeRanges, GLuint& size, GLuint count)
+{
+	if(count == 0)
+		return 0;
+
+	for(auto iter = freeRanges.begin(); iter != freeRanges.end(); ++iter)
+	{
+		if(iter->count >= count)
+		{
+			GLuint first = iter->first;
+
+			iter->first += count;
+			iter->count -= count;
+
+			if(iter->count == 0)
+			{
+				freeRanges.erase(iter);
+			}
+
+			return first;
+		}
+	}
+
+	GLuint first = size;
+	size += count;
+
+	return first;
+}
+
+void MeshPool::Free(std::vector<FreeRange>& freeRanges, GLuint& size, GLuint first, GLuint count)
+{
+	if(count == 0)
+		return;
+
+	assert(first + count <= size);
+
+	auto iter = std::lower_bound(freeRanges.begin(), freeRanges.end(), first, [](const FreeRange& range, GLuint first)
+	{
+		return range.first < first;
+	});
+
+	// Merges the range with the free ranges before and after it
+	if((iter != freeRanges.begin()) && ((iter - 1)->first + (iter - 1)->count == first))
+	{
+		--iter;
+		iter->count += count;
+	}
+	else
+	{
+		FreeRange range = { first, count };
+		iter = freeRanges.insert(iter, range);
+	}
+
+	auto next = iter + 1;
+	if((next != freeRanges.end()) && (iter->first + iter->count == next->first))
+	{
+		iter->count += next->count;
+		freeRanges.erase(next);
+	}
+
+	// Free space at the end of the buffer is given back
+	if(freeRanges.back().first + freeRanges.back().count == size)
+	{
+		size = freeRanges.back().first;
+		freeRanges.pop_back();
+	}
+}
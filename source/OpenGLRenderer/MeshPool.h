@@ -0,0 +1,73 @@
+#ifndef _MESHPOOL_
+#define _MESHPOOL_
+
+#include "VertexBuffer.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+
+// Location of a mesh within the shared buffers of a MeshPool
+struct MeshRange
+{
+	GLint baseVertex; // offset added to every index of the mesh
+	GLuint firstIndex;
+	GLsizei indexCount;
+	GLsizei vertexCount;
+};
+
+// Merges static meshes into a single vertex and index buffer so that switching between meshes does not require rebinding buffers
+// Meshes may be added by the main thread while the render thread binds the pool, the pool is locked while it changes
+class MeshPool
+{
+public:
+
+	MeshPool();
+
+	// Adds a mesh to the pool, the GPU buffers are rebuilt the next time the pool is bound
+	// Space left by removed meshes is reused before the buffers grow
+	MeshRange Add(const std::vector<VertexPT>& vertices, const std::vector<unsigned int>& indices);
+
+	// Removes a mesh from the pool, the range must not be drawn anymore
+	void Remove(const MeshRange& range);
+
+	// Removes all meshes from the pool
+	void Clear();
+
+	// Releases the GPU buffers, they are rebuilt the next time the pool is bound, possibly by another context
+	void ReleaseBuffer();
+
+	// Binds the shared buffers
+	void Bind();
+
+	// Draws a single mesh, the pool must be bound
+	void Draw(const MeshRange& range) const;
+
+private:
+
+	// Unused elements of one of the buffers
+	struct FreeRange
+	{
+		GLuint first;
+		GLuint count;
+	};
+
+	std::vector<VertexPT> m_vertices;
+	std::vector<unsigned int> m_indices;
+
+	// Ranges left by removed meshes, sorted by offset, neighbouring ranges are merged
+	std::vector<FreeRange> m_freeVertices;
+	std::vector<FreeRange> m_freeIndices;
+
+	std::unique_ptr<VertexBuffer<VertexFormatPT>> m_buffer;
+	bool m_bDirty;
+
+	std::mutex m_mutex;
+
+	// Returns the offset of count elements, the first free range that is large enough is used, else size grows
+	static GLuint Allocate(std::vector<FreeRange>& freeRanges, GLuint& size, GLuint count);
+
+	// Returns count elements at first to the free ranges, size shrinks if they were at the end of the buffer
+	static void Free(std::vector<FreeRange>& freeRanges, GLuint& size, GLuint first, GLuint count);
+};
+
+#endif // _MESHPOOL_
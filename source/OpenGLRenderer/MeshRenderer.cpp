@@ -0,0 +1,28 @@
+#include "MeshRenderer.h"
+#include "ApplyShader.h"
+#include "ResourceManager.h"
+#include "Mesh.h"
+
+MeshRenderable::MeshRenderable(MeshPool* pPool, const MeshRange& range, const glm::mat4& T, const glm::vec4& color) :
+	m_pPool(pPool), m_range(range), T(T), color(color)
+{
+}
+
+void MeshRenderable::Render(const Mesh& mesh, ApplyShader& shader, const IResource*)
+{
+	shader->SetColor(color);
+	shader->SetValue("transformation",T);
+	shader->SetValue("tiling",glm::vec2(1.0f));
+	shader->SetValue("tileIndex",0);
+
+	m_pPool->Bind();
+	m_pPool->Draw(m_range);
+
+	// Restore the quad for the rest of the renderables
+	mesh.Bind();
+}
+
+unsigned int MeshRenderable::GetShaderFeatures() const
+{
+	return (color.a <= 0.0f) ? SHADER_ALPHA_TEST : 0;
+}
@@ -0,0 +1,34 @@
+#ifndef _MESH_RENDERER_
+#define _MESH_RENDERER_
+
+#include "IRenderable.h"
+#include "MeshPool.h"
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+// Defines how a static mesh should be rendered
+class MeshRenderable : public IRenderable
+{
+public:
+
+	MeshRenderable(MeshPool* pPool, const MeshRange& range, const glm::mat4& T, const glm::vec4& color);
+
+	void Render(const class Mesh& mesh, class ApplyShader& shader, const class IResource* resource) override;
+
+	// Meshes are never tiled
+	unsigned int GetShaderFeatures() const override;
+
+private:
+
+	// Shared buffers the mesh is stored in
+	MeshPool* m_pPool;
+	MeshRange m_range;
+
+	// Transformation applied to the mesh
+	glm::mat4 T;
+
+	// Color blended with the mesh
+	glm::vec4 color;
+};
+
+#endif // _MESH_RENDERER_
@@ -0,0 +1,25 @@
+#include "ParticleRenderer.h"
+#include "ApplyShader.h"
+#include "ResourceManager.h"
+#include "Mesh.h"
+
+ParticleRenderable::ParticleRenderable(ParticleBuffer* pBuffer, const std::vector<ParticleVertex>* pStream, unsigned int offset, unsigned int length) :
+	m_pBuffer(pBuffer), m_pStream(pStream), m_uiOffset(offset), m_uiLength(length)
+{
+}
+
+void ParticleRenderable::Render(const Mesh& mesh, ApplyShader& shader, const IResource*)
+{
+	shader->SetColor(glm::vec4(1.0f));
+
+	m_pBuffer->Upload(m_pStream->data() + m_uiOffset, m_uiLength);
+	m_pBuffer->Bind();
+
+	// Particles are blended on top of each other, so they should not occlude each other
+	glDepthMask(GL_FALSE);
+	m_pBuffer->Draw(m_uiLength);
+	glDepthMask(GL_TRUE);
+
+	// Restore the quad for the rest of the renderables
+	mesh.Bind();
+}
@@ -0,0 +1,28 @@
+#ifndef _PARTICLE_RENDERER_
+#define _PARTICLE_RENDERER_
+
+#include "IRenderable.h"
+#include "InstanceBuffer.h"
+#include <vector>
+
+// Defines how a stream of particles should be rendered
+class ParticleRenderable : public IRenderable
+{
+public:
+
+	ParticleRenderable(ParticleBuffer* pBuffer, const std::vector<ParticleVertex>* pStream, unsigned int offset, unsigned int length);
+
+	void Render(const class Mesh& mesh, class ApplyShader& shader, const class IResource* resource) override;
+
+private:
+
+	// Buffer the particles get streamed into
+	ParticleBuffer* m_pBuffer;
+
+	// Range of the frame's particle stream that belongs to this renderable
+	const std::vector<ParticleVertex>* m_pStream;
+	unsigned int m_uiOffset;
+	unsigned int m_uiLength;
+};
+
+#endif // _PARTICLE_RENDERER_
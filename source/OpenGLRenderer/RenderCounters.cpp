@@ -0,0 +1,45 @@
+#include "RenderCounters.h"
+
+RenderCounters::RenderCounters() : m_stats()
+{
+}
+
+RenderCounters& RenderCounters::Instance()
+{
+	static thread_local RenderCounters instance;
+	return instance;
+}
+
+void RenderCounters::Draw(unsigned int vertices, unsigned int instances)
+{
+	m_stats.drawCalls++;
+	m_stats.instances += instances;
+	m_stats.vertices += vertices * instances;
+}
+
+void RenderCounters::StateChange()
+{
+	m_stats.stateChanges++;
+}
+
+void RenderCounters::TextureBind()
+{
+	m_stats.textureBinds++;
+}
+
+void RenderCounters::Upload(unsigned int bytes)
+{
+	m_stats.bytesUploaded += bytes;
+}
+
+void RenderCounters::Culled(unsigned int count)
+{
+	m_stats.culled += count;
+}
+
+RenderStats RenderCounters::Flush()
+{
+	RenderStats stats = m_stats;
+	m_stats = RenderStats();
+	return stats;
+}
@@ -0,0 +1,40 @@
+#ifndef _RENDERCOUNTERS_
+#define _RENDERCOUNTERS_
+
+#include "IRenderer.h"
+
+// Counts the work submitted to OpenGL during the current frame
+class RenderCounters
+{
+public:
+
+	// Each thread counts its own work, see RenderThread
+	static RenderCounters& Instance();
+
+	// Called for every draw call
+	// vertices: number of vertices per instance
+	void Draw(unsigned int vertices, unsigned int instances = 1);
+
+	// Called when the active shader program changes
+	void StateChange();
+
+	// Called when a texture is bound
+	void TextureBind();
+
+	// Called when data is copied into a GPU buffer
+	void Upload(unsigned int bytes);
+
+	// Called when objects are skipped because they are not visible
+	void Culled(unsigned int count);
+
+	// Returns the counters of the current frame and resets them
+	RenderStats Flush();
+
+private:
+
+	RenderCounters();
+
+	RenderStats m_stats;
+};
+
+#endif // _RENDERCOUNTERS_
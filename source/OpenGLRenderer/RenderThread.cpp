@@ -0,0 +1,394 @@
+#include "RenderThread.h"
+#include "ApplyShader.h"
+#include "DeletionQueue.h"
+#include "RenderCounters.h"
+
+#include <chrono>
+#include <string>
+
+RenderThread::RenderThread(GLFWwindow* pWindow, ResourceManager* pRm) : m_pWindow(pWindow), m_pContext(nullptr), m_pRM(pRm),
+m_uiRecording(0), m_uiRendering(2), m_uiHandedOver(1), m_uiFramesHandedOver(0), m_uiFramesReplaced(0), m_uiFramesRetired(0),
+m_iSwapInterval(1), m_bSwapInterval(true), m_depthRequest(NO_DEPTH_REQUEST), m_fDepth(1.0f), m_bInitialized(false), m_bQuit(false)
+{
+	// The main thread keeps a hidden context that shares its objects with the window
+	glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+	m_pContext = glfwCreateWindow(1, 1, "", nullptr, pWindow);
+	glfwWindowHint(GLFW_VISIBLE, GL_TRUE);
+
+	if (m_pContext == nullptr)
+	{
+		throw std::string("Failed to create the context of the main thread");
+	}
+
+	glfwSetWindowUserPointer(m_pContext, pWindow);
+
+	for (FramePacket& packet : m_packets)
+	{
+		packet.bWorldCamera = false;
+		packet.clearBits = 0;
+		packet.width = packet.height = 0;
+		packet.uploadedFence = 0;
+		packet.bRendered = false;
+		packet.stats = RenderStats();
+	}
+
+	// Vertex arrays are not shared between contexts, so the mesh pool is rebuilt by the render thread
+	// Objects queued by the main thread are deleted while the context of the window is still current
+	m_pRM->GetMeshPool().ReleaseBuffer();
+	DeletionQueue::Instance().Flush();
+
+	// Frames still use the resources unloaded from now on
+	m_pRM->DeferDeletion(true);
+
+	glfwMakeContextCurrent(m_pContext);
+
+	m_thread = std::thread(&RenderThread::Run, this);
+
+	// The renderers are created by the thread
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_condition.wait(lock, [this] { return m_bInitialized; });
+}
+
+RenderThread::~RenderThread()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bQuit = true;
+	}
+
+	m_condition.notify_all();
+	m_thread.join();
+
+	glfwMakeContextCurrent(m_pWindow);
+
+	// Frames that were not rendered, the frame handed over was recorded before the one being recorded
+	unsigned int uiHandedOver = m_uiHandedOver;
+	if ((uiHandedOver & NEW_FRAME) != 0)
+	{
+		ApplyShaderValues(m_packets[uiHandedOver & ~NEW_FRAME]);
+	}
+
+	ApplyShaderValues(m_packets[m_uiRecording]);
+
+	for (FramePacket& packet : m_packets)
+	{
+		m_pRM->DeleteResources(packet.unloaded);
+
+		if (packet.uploadedFence != 0)
+		{
+			glDeleteSync(packet.uploadedFence);
+		}
+	}
+
+	// Resources unloaded after the last frame was handed over
+	m_pRM->DeferDeletion(false);
+
+	DeletionQueue::Instance().Flush();
+
+	glfwDestroyWindow(m_pContext);
+}
+
+AbstractRenderer& RenderThread::GetWorldRenderer()
+{
+	return *m_packets[m_uiRecording].pWorld;
+}
+
+AbstractRenderer& RenderThread::GetScreenRenderer()
+{
+	return *m_packets[m_uiRecording].pScreen;
+}
+
+void RenderThread::Clear()
+{
+	m_packets[m_uiRecording].pWorld->Clear();
+	m_packets[m_uiRecording].pScreen->Clear();
+}
+
+void RenderThread::SetShaderValue(Shader* pShader, const std::string& location, float value)
+{
+	ShaderValue shaderValue = { pShader, location, glm::vec2(value, 0.0f), false };
+	m_packets[m_uiRecording].shaderValues.push_back(shaderValue);
+}
+
+void RenderThread::SetShaderValue(Shader* pShader, const std::string& location, const glm::vec2& value)
+{
+	ShaderValue shaderValue = { pShader, location, value, true };
+	m_packets[m_uiRecording].shaderValues.push_back(shaderValue);
+}
+
+bool RenderThread::Present(const Camera* pWorldCamera, const Camera& screenCamera, const glm::vec3& clearColor, GLbitfield clearBits, int width, int height, RenderStats& stats)
+{
+	FramePacket& recorded = m_packets[m_uiRecording];
+
+	recorded.bWorldCamera = (pWorldCamera != nullptr);
+	if (pWorldCamera != nullptr)
+	{
+		recorded.worldCamera = *pWorldCamera;
+	}
+
+	recorded.screenCamera = screenCamera;
+	recorded.clearColor = clearColor;
+	recorded.clearBits = clearBits;
+	recorded.width = width;
+	recorded.height = height;
+
+	// The resources of the frame are looked up here, the render thread never touches the resource manager
+	recorded.pWorld->Resolve();
+	recorded.pScreen->Resolve();
+
+	// Evicted resources are deleted after this frame, so the frames handed over before can still use them
+	m_pRM->EnforceBudget();
+	m_pRM->TakeUnloaded(recorded.unloaded);
+
+	// Resources loaded by the main thread must reach the GPU before the render thread uses them
+	recorded.uploadedFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	glFlush();
+
+	unsigned int uiPrevious = m_uiHandedOver.exchange(m_uiRecording | NEW_FRAME);
+	m_uiFramesHandedOver++;
+	Notify();
+
+	m_uiRecording = uiPrevious & ~NEW_FRAME;
+	FramePacket& packet = m_packets[m_uiRecording];
+
+	if ((uiPrevious & NEW_FRAME) != 0)
+	{
+		// The thread did not take the previous frame, it is replaced by the new one
+		// Its shader values and unloaded resources go with the next frame
+		packet.pWorld->Clear();
+		packet.pScreen->Clear();
+
+		glDeleteSync(packet.uploadedFence);
+		packet.uploadedFence = 0;
+
+		m_uiFramesReplaced++;
+		return false;
+	}
+
+	if (!packet.bRendered)
+		return false;
+
+	stats = packet.stats;
+	packet.bRendered = false;
+
+	return true;
+}
+
+void RenderThread::WaitForFrames(unsigned int uiFrames)
+{
+	if (uiFrames == 0)
+		return;
+
+	// A frame that does not retire within 100ms is not waited for, so that a lost fence cannot hang the game
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_condition.wait_for(lock, std::chrono::milliseconds(100), [this, uiFrames]
+	{
+		return (m_uiFramesHandedOver - m_uiFramesReplaced - m_uiFramesRetired) < uiFrames;
+	});
+}
+
+void RenderThread::SetSwapInterval(int interval)
+{
+	m_iSwapInterval = interval;
+	m_bSwapInterval = true;
+}
+
+float RenderThread::ReadDepth(const glm::ivec2& pos)
+{
+	m_depthRequest = ((uint64_t)(uint32_t)pos.x << 32) | (uint32_t)pos.y;
+
+	return m_fDepth;
+}
+
+void RenderThread::Notify()
+{
+	// Locking orders the notification after the check of a thread about to wait
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+	}
+
+	m_condition.notify_all();
+}
+
+void RenderThread::Run()
+{
+	glfwMakeContextCurrent(m_pWindow);
+
+	Init();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bInitialized = true;
+	}
+
+	m_condition.notify_all();
+
+	while (!m_bQuit)
+	{
+		if ((m_uiHandedOver & NEW_FRAME) == 0)
+		{
+			// Nothing to render, the frames on the GPU are retired before sleeping so that WaitForFrames() does not wait for a sleeping thread
+			RetireFrames(true);
+
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this] { return ((m_uiHandedOver & NEW_FRAME) != 0) || m_bQuit; });
+
+			if (m_bQuit)
+				break;
+		}
+
+		m_uiRendering = m_uiHandedOver.exchange(m_uiRendering) & ~NEW_FRAME;
+
+		Render(m_packets[m_uiRendering]);
+		RetireFrames(false);
+	}
+
+	Release();
+
+	glfwMakeContextCurrent(nullptr);
+}
+
+void RenderThread::Init()
+{
+	// Same state as the context of the window, see oglRenderer::ConfigureOpenGL()
+	glEnable(GL_DEPTH_TEST);
+	glDepthFunc(GL_LEQUAL);
+
+	glEnable(GL_CULL_FACE);
+	glCullFace(GL_BACK);
+	glFrontFace(GL_CW);
+
+	m_mesh.reset(new Mesh());
+	m_particleBuffer.reset(new ParticleBuffer());
+	m_spriteBuffer.reset(new SpriteBuffer());
+	m_sprite2DBuffer.reset(new Sprite2DBuffer());
+
+	for (FramePacket& packet : m_packets)
+	{
+		packet.pWorld.reset(new AbstractRenderer(m_pRM, m_mesh, m_particleBuffer, m_spriteBuffer, m_sprite2DBuffer));
+		packet.pScreen.reset(new AbstractRenderer(m_pRM, m_mesh, m_particleBuffer, m_spriteBuffer, m_sprite2DBuffer, &packet.screenCamera));
+	}
+}
+
+void RenderThread::Render(FramePacket& packet)
+{
+	if (packet.uploadedFence != 0)
+	{
+		glWaitSync(packet.uploadedFence, 0, GL_TIMEOUT_IGNORED);
+		glDeleteSync(packet.uploadedFence);
+		packet.uploadedFence = 0;
+	}
+
+	ApplyShaderValues(packet);
+
+	if ((packet.width > 0) && (packet.height > 0))
+	{
+		glViewport(0, 0, packet.width, packet.height);
+
+		glClearColor(packet.clearColor.x, packet.clearColor.y, packet.clearColor.z, 0.0f);
+		glClear(packet.clearBits);
+
+		packet.pWorld->SetCamera(packet.bWorldCamera ? &packet.worldCamera : nullptr);
+		packet.pWorld->Render();
+		packet.pScreen->Render();
+
+		// The back buffer is undefined once swapped, so the depth is read before
+		uint64_t request = m_depthRequest.exchange(NO_DEPTH_REQUEST);
+		if (request != NO_DEPTH_REQUEST)
+		{
+			float depth = 1.0f;
+			glReadPixels((GLint)(int32_t)(request >> 32), (GLint)(int32_t)(request & 0xffffffff), 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &depth);
+			m_fDepth = depth;
+		}
+
+		if (m_bSwapInterval.exchange(false))
+		{
+			glfwSwapInterval(m_iSwapInterval);
+		}
+
+		glfwSwapBuffers(m_pWindow);
+
+		packet.stats = RenderCounters::Instance().Flush();
+		packet.bRendered = true;
+	}
+	else
+	{
+		packet.pWorld->Clear();
+		packet.pScreen->Clear();
+	}
+
+	// Every frame taken is fenced, even if nothing was drawn, so that it retires
+	m_frameFences.push_back(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+	// The frames handed over before this one are rendered, nothing uses the resources unloaded before it was handed over
+	m_pRM->DeleteResources(packet.unloaded);
+
+	// Objects released by the render thread are deleted by its own queue
+	DeletionQueue::Instance().EndFrame();
+}
+
+void RenderThread::ApplyShaderValues(FramePacket& packet)
+{
+	for (const ShaderValue& shaderValue : packet.shaderValues)
+	{
+		ApplyShader pShader(shaderValue.pShader);
+
+		if (shaderValue.bVec2)
+		{
+			pShader->SetValue(shaderValue.location, shaderValue.value);
+		}
+		else
+		{
+			pShader->SetValue(shaderValue.location, shaderValue.value.x);
+		}
+	}
+
+	packet.shaderValues.clear();
+}
+
+void RenderThread::RetireFrames(bool bWait)
+{
+	bool bRetired = false;
+
+	while (!m_frameFences.empty())
+	{
+		GLuint64 timeout = bWait ? 100000000 : 0; // 100ms
+		GLenum result = glClientWaitSync(m_frameFences.front(), GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+
+		if ((result == GL_TIMEOUT_EXPIRED) && !bWait)
+			break;
+
+		// A timeout while blocking is treated as complete so that a lost fence cannot hang the game
+		glDeleteSync(m_frameFences.front());
+		m_frameFences.pop_front();
+
+		m_uiFramesRetired++;
+		bRetired = true;
+	}
+
+	if (bRetired)
+	{
+		Notify();
+	}
+}
+
+void RenderThread::Release()
+{
+	RetireFrames(true);
+
+	for (FramePacket& packet : m_packets)
+	{
+		packet.pWorld.reset();
+		packet.pScreen.reset();
+	}
+
+	m_mesh.reset();
+	m_particleBuffer.reset();
+	m_spriteBuffer.reset();
+	m_sprite2DBuffer.reset();
+
+	// The main thread rebuilds the mesh pool once the thread is gone
+	m_pRM->GetMeshPool().ReleaseBuffer();
+
+	DeletionQueue::Instance().Flush();
+}
@@ -0,0 +1,170 @@
+#ifndef _RENDERTHREAD_
+#define _RENDERTHREAD_
+
+#include "AbstractRenderer.h"
+#include "ResourceManager.h"
+#include "Camera.h"
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Renders and presents frames on a separate thread while the main thread records the next frame
+// The context of the window is current on the render thread. The main thread uses a hidden context that shares textures, buffers and shaders
+// with the window so that it can keep loading resources, the window is the user pointer of that context, see GetMainWindow()
+// Frames are recorded into three packets: one recorded by the main thread, one rendered by the thread and the last one handed over.
+// The packets are exchanged through an atomic index so that neither thread waits for the other, a frame handed over before the thread
+// took the previous one replaces it. The resources of a packet are resolved by the main thread, only the main thread uses the resource manager,
+// and the resources it unloads are deleted by the thread once the frames that may use them are rendered
+class RenderThread
+{
+public:
+
+	// Makes the hidden context current on the calling thread and starts the thread with the context of the window
+	RenderThread(GLFWwindow* pWindow, ResourceManager* pRm);
+
+	// Stops the thread, releases its objects and makes the context of the window current again
+	// The shader values and unloaded resources of the frames that were not rendered are handled by the main thread
+	~RenderThread();
+
+	// Renderers recording the next frame, they only store the commands
+	AbstractRenderer& GetWorldRenderer();
+	AbstractRenderer& GetScreenRenderer();
+
+	// Discards the commands recorded for the next frame
+	void Clear();
+
+	// Sets a value of a shader before the next frame handed over is rendered
+	void SetShaderValue(Shader* pShader, const std::string& location, float value);
+	void SetShaderValue(Shader* pShader, const std::string& location, const glm::vec2& value);
+
+	// Hands the recorded frame over to the render thread, never waits for it
+	// pWorldCamera may be null if there is no world camera, the cameras are copied so they can change while the frame is rendered
+	// stats: counters of a frame rendered since the last call, left untouched if none was
+	// Returns true if a frame was rendered since the last call
+	bool Present(const Camera* pWorldCamera, const Camera& screenCamera, const glm::vec3& clearColor, GLbitfield clearBits, int width, int height, RenderStats& stats);
+
+	// Blocks until fewer than uiFrames frames handed over are waiting to be rendered or queued on the GPU, 0 means no limit
+	// The thread fences each frame after it swaps the buffers, a frame that was replaced before being rendered does not count
+	void WaitForFrames(unsigned int uiFrames);
+
+	// Swap interval applied by the thread before it presents the next frame
+	void SetSwapInterval(int interval);
+
+	// Requests the depth at a position in window coordinates, it is read by the thread from the next frame it renders
+	// Returns the depth read for an earlier request, 1 until a depth is read
+	float ReadDepth(const glm::ivec2& pos);
+
+private:
+
+	// Uniform set by SetShaderValue()
+	struct ShaderValue
+	{
+		Shader* pShader;
+		std::string location;
+		glm::vec2 value;
+		bool bVec2;
+	};
+
+	// Everything needed to render a frame
+	struct FramePacket
+	{
+		std::unique_ptr<AbstractRenderer> pWorld;
+		std::unique_ptr<AbstractRenderer> pScreen;
+
+		Camera worldCamera;
+		Camera screenCamera;
+		bool bWorldCamera;
+
+		glm::vec3 clearColor;
+		GLbitfield clearBits;
+		int width;
+		int height;
+
+		// Applied before the frame is rendered, and deleted after, a frame that is replaced keeps them for the next frame
+		std::vector<ShaderValue> shaderValues;
+		std::vector<IResource*> unloaded;
+
+		GLsync uploadedFence; // signaled once the resources created by the main thread for the frame are uploaded
+
+		bool bRendered;
+		RenderStats stats;
+	};
+
+	// Set in m_uiHandedOver while the thread has not taken the frame
+	static const unsigned int NEW_FRAME = 4;
+
+	// Value of m_depthRequest when no depth is requested
+	static const uint64_t NO_DEPTH_REQUEST = ~(uint64_t)0;
+
+	GLFWwindow* m_pWindow;
+	GLFWwindow* m_pContext; // hidden window owning the context of the main thread
+
+	ResourceManager* m_pRM;
+
+	// Buffers shared by the renderers of every packet, they must be created by the render thread
+	std::shared_ptr<Mesh> m_mesh;
+	std::shared_ptr<ParticleBuffer> m_particleBuffer;
+	std::shared_ptr<SpriteBuffer> m_spriteBuffer;
+	std::shared_ptr<Sprite2DBuffer> m_sprite2DBuffer;
+
+	std::array<FramePacket, 3> m_packets;
+	unsigned int m_uiRecording; // packet recorded by the main thread
+	unsigned int m_uiRendering; // packet rendered by the thread
+	std::atomic<unsigned int> m_uiHandedOver; // last packet handed over, with NEW_FRAME
+
+	// Frames counted by the main thread, and frames whose fence was signaled counted by the thread, see WaitForFrames()
+	unsigned int m_uiFramesHandedOver;
+	unsigned int m_uiFramesReplaced;
+	std::atomic<unsigned int> m_uiFramesRetired;
+
+	// Fences of the frames presented by the thread, oldest first
+	std::deque<GLsync> m_frameFences;
+
+	std::atomic<int> m_iSwapInterval;
+	std::atomic<bool> m_bSwapInterval; // set when the swap interval changes
+
+	std::atomic<uint64_t> m_depthRequest; // position requested by ReadDepth(), x in the high bits
+	std::atomic<float> m_fDepth;
+
+	// The condition only wakes up a thread that has nothing to do: the render thread when no frame is handed over,
+	// or the main thread waiting for frames to retire
+	std::thread m_thread;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	bool m_bInitialized;
+	std::atomic<bool> m_bQuit;
+
+	// Wakes up the threads waiting on the condition
+	void Notify();
+
+	// Main loop of the thread
+	void Run();
+
+	// Called on the render thread
+	void Init();
+	void Render(FramePacket& packet);
+	void Release();
+
+	// Sets the shader values of a packet and clears them
+	static void ApplyShaderValues(FramePacket& packet);
+
+	// Deletes the fences of the frames completed by the GPU, bWait blocks until every frame is completed
+	void RetireFrames(bool bWait);
+
+	RenderThread(const RenderThread&) = delete;
+	RenderThread& operator = (const RenderThread&) = delete;
+};
+
+#endif // _RENDERTHREAD_
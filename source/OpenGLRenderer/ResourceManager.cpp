@@ -1,9 +1,14 @@
 ﻿
 #include "ResourceManager.h"
+#include "MeshOptimizer.h"
+#include "RenderCounters.h"
+#include "DeletionQueue.h"
 #include "Log.h"
 #include <sstream>
 #include <vector>
+#include <algorithm>
 #include <cstring>
+#include <cassert>
 
 #ifdef _MSC_VER
 #pragma warning(disable: 4996)
@@ -11,6 +16,25 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
+namespace
+{
+	// Name of each shader feature in the resource file and the macro defined in the shader
+	struct ShaderFeatureName
+	{
+		ShaderFeature feature;
+		const char* name;
+		const char* define;
+	};
+
+	const ShaderFeatureName SHADER_FEATURE_NAMES[] =
+	{
+		{ SHADER_TEXTURE, "texture", "TEXTURE" },
+		{ SHADER_TILING, "tiling", "TILING" },
+		{ SHADER_ANIMATION, "animation", "ANIMATION" },
+		{ SHADER_ALPHA_TEST, "alphaTest", "ALPHA_TEST" },
+	};
+}
+
 Cursor::Cursor(int width, int height, unsigned char *img) : m_iWidth(width), m_iHeight(height), m_pImg(img)
 {
 }
@@ -56,7 +80,7 @@ m_iHeight(th), m_iCellsWidth(cw), m_iCellsHeight(ch), m_iComp(comp), m_pImg(pImg
 
 Texture::~Texture()
 {
-	glDeleteTextures(1,&m_id);
+	DeletionQueue::Instance().DeleteTexture(m_id);
 	stbi_image_free(m_pImg);
 }
 
@@ -100,13 +124,41 @@ const unsigned char* Texture::GetImgData() const
 	return m_pImg; 
 }
 
+StaticMesh::StaticMesh(const MeshRange& range) : m_range(range)
+{
+}
+
+void* StaticMesh::QueryInterface(ResourceType type) const
+{
+	if (type == ResourceType::Mesh)
+	{
+		return (void*)this;
+	}
+
+	return nullptr;
+}
+
+const MeshRange& StaticMesh::GetRange() const
+{
+	return m_range;
+}
+
 Shader::Shader(GLuint i, GLuint MVP, GLuint color, UnifromMap&& uniforms) : OpenGLResource(i), m_MVP(MVP), m_color(color), m_uniforms(uniforms), m_bUse(false)
 {
 }
 
 Shader::~Shader()
 {
-	glDeleteProgram(m_id);
+	for(auto& iter : m_variants)
+	{
+		// A variant that failed to compile falls back to this shader
+		if(iter.second != this)
+		{
+			delete iter.second;
+		}
+	}
+
+	DeletionQueue::Instance().DeleteProgram(m_id);
 }
 
 void* Shader::QueryInterface(ResourceType type) const
@@ -128,6 +180,7 @@ void Shader::Bind()
 	if(!m_bUse)
 	{
 		glUseProgram(m_id);
+		RenderCounters::Instance().StateChange();
 		m_bUse = true;
 	}
 }
@@ -214,6 +267,23 @@ void Shader::SetValue(const std::string& location, const glm::mat4& v)
 	}
 }
 
+Shader* Shader::GetVariant(unsigned int features) const
+{
+	auto iter = m_variants.find(features);
+	if(iter == m_variants.end())
+	{
+		return nullptr;
+	}
+
+	return iter->second;
+}
+
+void Shader::AddVariant(unsigned int features, Shader* pVariant)
+{
+	assert(m_variants.find(features) == m_variants.end());
+	m_variants.emplace(features, pVariant);
+}
+
 TexturedShader::TexturedShader(GLuint i, GLuint MVP, GLuint color, GLuint texID, UnifromMap&& uniforms) : Shader(i, MVP, color, std::move(uniforms)),
 m_TextureSamplerID(texID)
 {
@@ -248,6 +318,7 @@ void TexturedShader::BindTexture(const OpenGLResource& texture) const
 	if(IsBound())
 	{
 		glBindTexture(GL_TEXTURE_2D, texture.m_id);
+		RenderCounters::Instance().TextureBind();
 		glUniform1i(m_TextureSamplerID, 0);
 	}
 }
@@ -410,13 +481,14 @@ std::istream& operator >>(std::istream& stream, Font& CharsetDesc)
 	return stream;
 }
 
-ResourceManager::ResourceManager()
+ResourceManager::ResourceManager() : m_uiTextureBudget(256 * 1024 * 1024), m_uiTextureMemory(0), m_bDeferDeletion(false)
 {
 }
 
 ResourceManager::~ResourceManager()
 {
 	Clear();
+	ClearPrefetched();
 }
 
 void ResourceManager::GetOpenGLFormat(int comp, GLenum& format, GLint& internalFormat)
@@ -450,6 +522,22 @@ bool ResourceManager::CreateTexture(const std::string& file, int& width, int& he
 	if(pImgData == nullptr)
 		return false;
 
+	{
+		std::lock_guard<std::mutex> lock(m_prefetchMutex);
+
+		auto iter = m_prefetchedImages.find(file);
+		if(iter != m_prefetchedImages.end())
+		{
+			*pImgData = iter->second.pImg;
+			width = iter->second.width;
+			height = iter->second.height;
+			comp = iter->second.comp;
+
+			m_prefetchedImages.erase(iter);
+			return true;
+		}
+	}
+
 	*pImgData = stbi_load(file.c_str(),&width,&height,&comp,0);
 
 	// check if the image can be loaded
@@ -459,6 +547,70 @@ bool ResourceManager::CreateTexture(const std::string& file, int& width, int& he
 	return true;
 }
 
+bool ResourceManager::CreateMesh(const std::string& file, std::vector<VertexPT>& vertices, std::vector<unsigned int>& indices)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_prefetchMutex);
+
+		auto iter = m_prefetchedMeshes.find(file);
+		if(iter != m_prefetchedMeshes.end())
+		{
+			vertices.swap(iter->second.vertices);
+			indices.swap(iter->second.indices);
+
+			m_prefetchedMeshes.erase(iter);
+			return true;
+		}
+	}
+
+	return ReadMesh(file, vertices, indices);
+}
+
+bool ResourceManager::ReadMesh(const std::string& file, std::vector<VertexPT>& vertices, std::vector<unsigned int>& indices)
+{
+	// Binary layout:
+	// char[4] "MESH"
+	// uint32 vertex count
+	// uint32 index count
+	// vertex count * { float x, y, z, u, v }
+	// index count * uint32, every 3 indices form a triangle
+	std::ifstream in(file, std::ios::binary);
+	if(!in.is_open())
+		return false;
+
+	char magic[4];
+	unsigned int uiVertexCount = 0;
+	unsigned int uiIndexCount = 0;
+
+	in.read(magic, sizeof(magic));
+	in.read(reinterpret_cast<char*>(&uiVertexCount), sizeof(uiVertexCount));
+	in.read(reinterpret_cast<char*>(&uiIndexCount), sizeof(uiIndexCount));
+
+	if(!in || (memcmp(magic, "MESH", 4) != 0) || (uiVertexCount == 0) || (uiIndexCount == 0) || ((uiIndexCount % 3) != 0))
+		return false;
+
+	vertices.resize(uiVertexCount);
+	indices.resize(uiIndexCount);
+
+	in.read(reinterpret_cast<char*>(vertices.data()), uiVertexCount * sizeof(VertexPT));
+	in.read(reinterpret_cast<char*>(indices.data()), uiIndexCount * sizeof(unsigned int));
+
+	if(!in)
+		return false;
+
+	for(auto index : indices)
+	{
+		if(index >= uiVertexCount)
+			return false;
+	}
+
+	DeduplicateVertices(vertices, indices);
+	OptimizeVertexCache(indices, (unsigned int)vertices.size());
+	OptimizeVertexFetch(vertices, indices);
+
+	return true;
+}
+
 bool ResourceManager::CreateOpenGLTexture(const std::string& file, int& width, int& height, int& comp, unsigned char** pImgData, GLuint& textureId)
 {
 	if(!CreateTexture(file, width, height, comp, pImgData))
@@ -485,112 +637,209 @@ bool ResourceManager::CreateOpenGLTexture(const std::string& file, int& width, i
 
 bool ResourceManager::LoadCursor(const std::string& id, const std::string& file)
 {
-	auto iter = m_resources.find(id);
-	if(iter != m_resources.end())
-	{
-		// ID is taken, resource must be a cursor
-		return (iter->second->QueryInterface(ResourceType::Cursor) != nullptr);
-	}
-
-	unsigned char* pImg;
-	int width, height;
-	int comp;
-	bool success;
-	if ((success = CreateTexture(file, width, height, comp, &pImg)))
-	{
-		m_resources.emplace(id, new Cursor(width, height, pImg));
-	}
-	return success;
+	return Load(id, ResourceType::Cursor, file);
 }
 
 bool ResourceManager::LoadTexture(const std::string& id, const std::string& file)
 {
-	auto iter = m_resources.find(id);
-	if(iter != m_resources.end())
-	{
-		// ID is taken, resource must be a texture
-		return (iter->second->QueryInterface(ResourceType::Texture) != nullptr);
-	}
-
-	GLuint textureID;
-	unsigned char* pImg;
-	int width, height;
-	int comp;
-	bool success;
-	if ((success = CreateOpenGLTexture(file, width, height, comp, &pImg, textureID)))
-	{
-		m_resources.emplace(id, new Texture(textureID, pImg, comp, width, height));
-	}
-	return success;
+	return Load(id, ResourceType::Texture, file);
 }
 
 bool ResourceManager::LoadAnimation(const std::string& id, const std::string& file)
 {
-	auto iter = m_resources.find(id);
-	if(iter != m_resources.end())
-	{
-		// ID is taken, resource must be a texture
-		return (iter->second->QueryInterface(ResourceType::Texture) != nullptr);
-	}
+	return Load(id, ResourceType::Animation, file);
+}
 
-	GLuint textureID;
-	unsigned char* pImg;
-	int width, height;
-	int comp;
-	bool success;
-	if ((success = CreateOpenGLTexture(file, width, height, comp, &pImg, textureID)))
+bool ResourceManager::LoadFont(const std::string& id, const std::string& file)
+{
+	return Load(id, ResourceType::Font, file);
+}
+
+bool ResourceManager::LoadShader(const std::string& id, const std::string& vert, const std::string& frag, const std::vector<std::string>& features)
+{
+	unsigned int uiFeatures = 0;
+	for(auto& feature : features)
 	{
-		std::ifstream in(file + ".txt");
-		if((success = in.is_open()))
+		auto iter = std::find_if(std::begin(SHADER_FEATURE_NAMES), std::end(SHADER_FEATURE_NAMES), [&](const ShaderFeatureName& info)
+		{
+			return feature == info.name;
+		});
+
+		if(iter == std::end(SHADER_FEATURE_NAMES))
 		{
-			int spriteWidth, spriteHeight;
-			in >> spriteWidth >> spriteHeight;
-			m_resources.emplace(id, new Texture(textureID, pImg, comp, width, height, spriteWidth, spriteHeight));
+			Log::Instance().Write("Unknown shader feature: " + feature);
+			return false;
 		}
+
+		uiFeatures |= iter->feature;
 	}
-	return success;
+
+	return Load(id, ResourceType::Shader, vert, frag, uiFeatures);
 }
 
-bool ResourceManager::LoadFont(const std::string& id, const std::string& file)
+bool ResourceManager::LoadMesh(const std::string& id, const std::string& file)
+{
+	return Load(id, ResourceType::Mesh, file);
+}
+
+bool ResourceManager::Load(const std::string& id, ResourceType type, const std::string& file, const std::string& frag, unsigned int uiFeatures)
 {
 	auto iter = m_resources.find(id);
 	if(iter != m_resources.end())
 	{
-		// ID is taken, resource must be a font
-		return (iter->second->QueryInterface(ResourceType::Texture) != nullptr);
+		// ID is taken, resource must be of the same kind
+		ResourceType existing = iter->second.type;
+		bool bTexture = (type != ResourceType::Cursor) && (type != ResourceType::Shader) && (type != ResourceType::Mesh);
+		bool bExistingTexture = (existing != ResourceType::Cursor) && (existing != ResourceType::Shader) && (existing != ResourceType::Mesh);
+
+		if((bTexture != bExistingTexture) || (!bTexture && (type != existing)))
+			return false;
+
+		// Shared resources are only referenced once by each scope
+		if(m_scopes[m_scope].insert(id).second)
+		{
+			iter->second.uiRefCount++;
+		}
+
+		return true;
 	}
 
+	ResourceEntry entry;
+	entry.pResource = nullptr;
+	entry.type = type;
+	entry.file = file;
+	entry.frag = frag;
+	entry.uiFeatures = uiFeatures;
+	entry.uiRefCount = 1;
+	entry.uiSize = 0;
+
+	entry.pResource = CreateResource(entry);
+	if(entry.pResource == nullptr)
+		return false;
+
+	auto& inserted = *m_resources.emplace(id, entry).first;
+	inserted.second.lruIter = m_lru.insert(m_lru.end(), &inserted);
+
+	m_scopes[m_scope].insert(id);
+
+	m_uiTextureMemory += entry.uiSize;
+	EnforceBudget();
+
+	return true;
+}
+
+IResource* ResourceManager::CreateResource(ResourceEntry& entry)
+{
+	IResource* pResource = nullptr;
+
 	GLuint textureID;
 	unsigned char* pImg;
-	int width, height;
-	int comp;
-	bool success;
-	if ((success = CreateOpenGLTexture(file, width, height, comp, &pImg, textureID)))
+	int width = 0, height = 0;
+	int comp = 0;
+
+	switch(entry.type)
 	{
-		std::ifstream in(file + ".fnt");
-		if((success = in.is_open()))
+	case ResourceType::Cursor:
+		if(CreateTexture(entry.file, width, height, comp, &pImg))
+		{
+			pResource = new Cursor(width, height, pImg);
+		}
+		break;
+	case ResourceType::Texture:
+		if(CreateOpenGLTexture(entry.file, width, height, comp, &pImg, textureID))
+		{
+			pResource = new Texture(textureID, pImg, comp, width, height);
+		}
+		break;
+	case ResourceType::Animation:
+		if(CreateOpenGLTexture(entry.file, width, height, comp, &pImg, textureID))
+		{
+			std::ifstream in(entry.file + ".txt");
+			if(in.is_open())
+			{
+				int spriteWidth, spriteHeight;
+				in >> spriteWidth >> spriteHeight;
+				pResource = new Texture(textureID, pImg, comp, width, height, spriteWidth, spriteHeight);
+			}
+			else
+			{
+				glDeleteTextures(1, &textureID);
+				stbi_image_free(pImg);
+			}
+		}
+		break;
+	case ResourceType::Font:
+		if(CreateOpenGLTexture(entry.file, width, height, comp, &pImg, textureID))
 		{
 			Font* pCharset = new Font(textureID, pImg, comp, width, height);
-			in >> (*pCharset);
 
-			m_resources.emplace(id, pCharset);
+			std::ifstream in(entry.file + ".fnt");
+			if(in.is_open())
+			{
+				in >> (*pCharset);
+				pResource = pCharset;
+			}
+			else
+			{
+				delete static_cast<IResource*>(pCharset);
+			}
+		}
+		break;
+	case ResourceType::Shader:
+	case ResourceType::TexturedShader:
+		// The resource itself is the variant with every declared feature
+		pResource = CreateShaderProgram(entry.file, entry.frag, entry.uiFeatures);
+		break;
+	case ResourceType::Mesh:
+		{
+			std::vector<VertexPT> vertices;
+			std::vector<unsigned int> indices;
+			if(CreateMesh(entry.file, vertices, indices))
+			{
+				pResource = new StaticMesh(m_meshPool.Add(vertices, indices));
+			}
 		}
+		break;
 	}
-	return success;
+
+	// Only textures count towards the budget, the image data is kept on the CPU as well as the mipmapped GPU copy
+	if((pResource != nullptr) && (entry.type != ResourceType::Cursor) && (entry.type != ResourceType::Shader) && (entry.type != ResourceType::Mesh))
+	{
+		unsigned int uiImgSize = width * height * comp;
+		entry.uiSize = uiImgSize + (uiImgSize * 4) / 3;
+	}
+
+	return pResource;
 }
 
-bool ResourceManager::LoadShader(const std::string& id, const std::string& vert, const std::string& frag)
+void ResourceManager::Touch(ResourceMap::value_type& entry)
 {
-	auto iter = m_resources.find(id);
-	if(iter != m_resources.end())
+	m_lru.splice(m_lru.end(), m_lru, entry.second.lruIter);
+}
+
+void ResourceManager::EnforceBudget()
+{
+	for(auto iter = m_lru.begin(); (iter != m_lru.end()) && (m_uiTextureMemory > m_uiTextureBudget); ++iter)
 	{
-		// ID is taken, resource must be a shader
-		return (iter->second->QueryInterface(ResourceType::Shader) != nullptr);
+		ResourceEntry& entry = (*iter)->second;
+
+		if((entry.pResource != nullptr) && (entry.uiRefCount == 0) && (entry.uiSize > 0))
+		{
+			Unload(entry.pResource);
+			entry.pResource = nullptr;
+
+			m_uiTextureMemory -= entry.uiSize;
+
+			Log::Instance().Write("Evicted resource: " + (*iter)->first);
+		}
 	}
+}
 
+Shader* ResourceManager::CreateShaderProgram(const std::string& vert, const std::string& frag, unsigned int uiFeatures)
+{
 	// Create the shaders
-	GLuint VertexShaderID = CreateGLShader(vert, GL_VERTEX_SHADER);
-	GLuint FragmentShaderID = CreateGLShader(frag, GL_FRAGMENT_SHADER);
+	GLuint VertexShaderID = CreateGLShader(vert, GL_VERTEX_SHADER, uiFeatures);
+	GLuint FragmentShaderID = CreateGLShader(frag, GL_FRAGMENT_SHADER, uiFeatures);
 
 	// Link the program
 	GLuint programID = glCreateProgram();
@@ -614,10 +863,16 @@ bool ResourceManager::LoadShader(const std::string& id, const std::string& vert,
 	glDeleteShader(VertexShaderID);
 	glDeleteShader(FragmentShaderID);
 
-	return ((result == GL_TRUE) && CreateShaderInstance(id, programID));
+	if(result != GL_TRUE)
+	{
+		glDeleteProgram(programID);
+		return nullptr;
+	}
+
+	return CreateShaderInstance(programID);
 }
 
-GLuint ResourceManager::CreateGLShader(const std::string& file, GLenum type)
+GLuint ResourceManager::CreateGLShader(const std::string& file, GLenum type, unsigned int uiFeatures)
 {
 	// Read the Vertex Shader code from the file
 	std::string shaderCode;
@@ -628,6 +883,18 @@ GLuint ResourceManager::CreateGLShader(const std::string& file, GLenum type)
 		while (getline(shaderStream, Line))
 		{
 			shaderCode += "\n" + Line;
+
+			// The features must be defined after #version, which has to come first
+			if (Line.compare(0, 8, "#version") == 0)
+			{
+				for (auto& info : SHADER_FEATURE_NAMES)
+				{
+					if ((uiFeatures & info.feature) != 0)
+					{
+						shaderCode += std::string("\n#define ") + info.define;
+					}
+				}
+			}
 		}
 	}
 
@@ -651,7 +918,7 @@ GLuint ResourceManager::CreateGLShader(const std::string& file, GLenum type)
 	return shaderID;
 }
 
-bool ResourceManager::CreateShaderInstance(const std::string& id, GLuint programID)
+Shader* ResourceManager::CreateShaderInstance(GLuint programID)
 {
 	Shader::UnifromMap uniforms;
 
@@ -677,12 +944,11 @@ bool ResourceManager::CreateShaderInstance(const std::string& id, GLuint program
 	auto colorIter = uniforms.find("uniformColor");
 	auto textureIter = uniforms.find("textureSampler");
 
-	bool success = false;
+	Shader* pShader = nullptr;
 
 	// Each shader must at least have a MVP matrix and a color vector
-	if((success = ((mvpIter != uniforms.end()) && (colorIter != uniforms.end()))))
+	if((mvpIter != uniforms.end()) && (colorIter != uniforms.end()))
 	{
-		Shader* pShader = nullptr;
 		if(textureIter != uniforms.end())
 		{
 			pShader = new TexturedShader(programID, mvpIter->second, colorIter->second, textureIter->second, std::move(uniforms));
@@ -691,21 +957,23 @@ bool ResourceManager::CreateShaderInstance(const std::string& id, GLuint program
 		{
 			pShader = new Shader(programID, mvpIter->second, colorIter->second, std::move(uniforms));
 		}
-
-		m_resources.emplace(id, pShader);
+	}
+	else
+	{
+		glDeleteProgram(programID);
 	}
 
-	return success;
+	return pShader;
 }
 
 bool ResourceManager::GetTextureInfo(const std::string& name, TextureInfo& out) const
 {
 	auto iter = m_resources.find(name);
 
-	if(iter == m_resources.end())
+	if((iter == m_resources.end()) || (iter->second.pResource == nullptr))
 		return false;
 
-	Texture* pTexture = static_cast<Texture*>(iter->second->QueryInterface(ResourceType::Texture));
+	Texture* pTexture = static_cast<Texture*>(iter->second.pResource->QueryInterface(ResourceType::Texture));
 
 	if (pTexture == nullptr)
 		return false;
@@ -725,10 +993,152 @@ void ResourceManager::Clear()
 {
 	for(auto& iter : m_resources)
 	{
-		delete iter.second;
+		if(iter.second.pResource != nullptr)
+		{
+			Unload(iter.second.pResource);
+		}
 	}
 
 	m_resources.clear();
+	m_lru.clear();
+	m_scopes.clear();
+
+	// Queued meshes are removed from the pool once they are deleted
+	if(!m_bDeferDeletion)
+	{
+		m_meshPool.Clear();
+	}
+
+	m_uiTextureMemory = 0;
+}
+
+void ResourceManager::SetScope(const std::string& scope)
+{
+	m_scope = scope;
+}
+
+void ResourceManager::ReleaseScope(const std::string& scope)
+{
+	auto scopeIter = m_scopes.find(scope);
+	if(scopeIter == m_scopes.end())
+		return;
+
+	for(auto& id : scopeIter->second)
+	{
+		Release(id);
+
+		// Meshes do not count towards the texture budget, so they are unloaded as soon as they are not referenced
+		// Their space in the mesh pool is reused, and they are reloaded if they are used again
+		ResourceEntry& entry = m_resources.find(id)->second;
+		if((entry.type == ResourceType::Mesh) && (entry.uiRefCount == 0) && (entry.pResource != nullptr))
+		{
+			Unload(entry.pResource);
+			entry.pResource = nullptr;
+		}
+	}
+
+	m_scopes.erase(scopeIter);
+
+	EnforceBudget();
+}
+
+void ResourceManager::AddRef(const std::string& id)
+{
+	auto iter = m_resources.find(id);
+	if(iter != m_resources.end())
+	{
+		iter->second.uiRefCount++;
+	}
+}
+
+void ResourceManager::Release(const std::string& id)
+{
+	auto iter = m_resources.find(id);
+	if(iter != m_resources.end())
+	{
+		assert(iter->second.uiRefCount > 0);
+		iter->second.uiRefCount--;
+	}
+}
+
+void ResourceManager::SetTextureBudget(unsigned int uiBytes)
+{
+	m_uiTextureBudget = uiBytes;
+	EnforceBudget();
+}
+
+unsigned int ResourceManager::GetTextureMemory() const
+{
+	return m_uiTextureMemory;
+}
+
+unsigned int ResourceManager::GetScopeMemory(const std::string& scope) const
+{
+	auto scopeIter = m_scopes.find(scope);
+	if(scopeIter == m_scopes.end())
+		return 0;
+
+	unsigned int uiBytes = 0;
+	for(auto& id : scopeIter->second)
+	{
+		auto iter = m_resources.find(id);
+		if((iter != m_resources.end()) && (iter->second.pResource != nullptr))
+		{
+			uiBytes += iter->second.uiSize;
+		}
+	}
+
+	return uiBytes;
+}
+
+void ResourceManager::SetDeletionBudget(unsigned int uiObjects)
+{
+	DeletionQueue::SetBudget(uiObjects);
+}
+
+bool ResourceManager::PrefetchImage(const std::string& file)
+{
+	PrefetchedImage image;
+	image.pImg = stbi_load(file.c_str(), &image.width, &image.height, &image.comp, 0);
+
+	if(image.pImg == nullptr)
+		return false;
+
+	std::lock_guard<std::mutex> lock(m_prefetchMutex);
+
+	// Another thread may have prefetched the same file
+	if(!m_prefetchedImages.emplace(file, image).second)
+	{
+		stbi_image_free(image.pImg);
+	}
+
+	return true;
+}
+
+bool ResourceManager::PrefetchMesh(const std::string& file)
+{
+	PrefetchedMesh mesh;
+
+	if(!ReadMesh(file, mesh.vertices, mesh.indices))
+		return false;
+
+	std::lock_guard<std::mutex> lock(m_prefetchMutex);
+	m_prefetchedMeshes.emplace(file, std::move(mesh));
+
+	return true;
+}
+
+void ResourceManager::ClearPrefetched()
+{
+	std::lock_guard<std::mutex> lock(m_prefetchMutex);
+
+	for(auto& iter : m_prefetchedImages)
+	{
+		stbi_image_free(iter.second.pImg);
+	}
+
+	m_prefetchedImages.clear();
+	m_prefetchedMeshes.clear();
 }
 
 IResource* ResourceManager::GetResource(const std::string& name, ResourceType type)
@@ -762,7 +1172,25 @@ IResource* ResourceManager::GetResource(const std::string& name)
 		return nullptr;
 	}
 
-	return iter->second;
+	ResourceEntry& entry = iter->second;
+
+	// Transparently reload evicted resources
+	if(entry.pResource == nullptr)
+	{
+		entry.pResource = CreateResource(entry);
+		if(entry.pResource == nullptr)
+		{
+			Log::Instance().Write("Error reloading resource: " + name);
+			return nullptr;
+		}
+
+		// Evicting now could delete resources that were already handed to the frame being recorded
+		m_uiTextureMemory += entry.uiSize;
+	}
+
+	Touch(*iter);
+
+	return entry.pResource;
 }
 
 const IResource* ResourceManager::GetResource(const std::string& name) const
@@ -774,5 +1202,93 @@ const IResource* ResourceManager::GetResource(const std::string& name) const
 		return nullptr;
 	}
 
-	return iter->second;
+	return iter->second.pResource;
+}
+
+Shader* ResourceManager::GetShader(const std::string& name, unsigned int features)
+{
+	Shader* pShader = static_cast<Shader*>(GetResource(name, ResourceType::Shader));
+	if(pShader == nullptr)
+	{
+		return nullptr;
+	}
+
+	const ResourceEntry& entry = m_resources.find(name)->second;
+
+	features &= entry.uiFeatures;
+	if(features == entry.uiFeatures)
+	{
+		return pShader;
+	}
+
+	Shader* pVariant = pShader->GetVariant(features);
+	if(pVariant == nullptr)
+	{
+		pVariant = CreateShaderProgram(entry.file, entry.frag, features);
+		if(pVariant == nullptr)
+		{
+			// Fall back to the shader with every feature so that the variant is not compiled again each frame
+			Log::Instance().Write("Failed to compile a variant of shader: " + name);
+			pVariant = pShader;
+		}
+
+		pShader->AddVariant(features, pVariant);
+	}
+
+	return pVariant;
+}
+
+MeshPool& ResourceManager::GetMeshPool()
+{
+	return m_meshPool;
+}
+
+void ResourceManager::DeferDeletion(bool bDefer)
+{
+	m_bDeferDeletion = bDefer;
+
+	if(!bDefer)
+	{
+		DeleteResources(m_unloaded);
+	}
+}
+
+void ResourceManager::TakeUnloaded(std::vector<IResource*>& out)
+{
+	out.insert(out.end(), m_unloaded.begin(), m_unloaded.end());
+	m_unloaded.clear();
+}
+
+void ResourceManager::DeleteResources(std::vector<IResource*>& resources)
+{
+	for(IResource* pResource : resources)
+	{
+		Delete(pResource);
+	}
+
+	resources.clear();
+}
+
+void ResourceManager::Unload(IResource* pResource)
+{
+	if(m_bDeferDeletion)
+	{
+		m_unloaded.push_back(pResource);
+	}
+	else
+	{
+		Delete(pResource);
+	}
+}
+
+void ResourceManager::Delete(IResource* pResource)
+{
+	// The space of the mesh is only reused once no frame draws it
+	StaticMesh* pMesh = static_cast<StaticMesh*>(pResource->QueryInterface(ResourceType::Mesh));
+	if(pMesh != nullptr)
+	{
+		m_meshPool.Remove(pMesh->GetRange());
+	}
+
+	delete pResource;
 }
@@ -2,12 +2,17 @@
 #define _OGLRESOURCEMANAGER_
 
 #include "IResourceManager.h"
+#include "MeshPool.h"
 #include <GL/glew.h>
 #include <glm/mat4x4.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
 #include <unordered_map>
+#include <unordered_set>
+#include <list>
 #include <array>
+#include <vector>
+#include <mutex>
 
 // Valid resource types
 enum class ResourceType
@@ -17,7 +22,8 @@ enum class ResourceType
 	Animation,
 	Font,
 	Shader,
-	TexturedShader
+	TexturedShader,
+	Mesh
 };
 
 // Resource Interface
@@ -104,6 +110,17 @@ private:
 
 };
 
+// Optional features of a shader, declared in the resource file after the shader files. ex: "shader sprite a.vert a.frag texture tiling"
+// Each feature is compiled into the shader as a #define, so variants without the feature skip its work entirely
+enum ShaderFeature
+{
+	SHADER_TEXTURE = 1 << 0, // "texture": samples the texture, color only quads leave it out
+	SHADER_TILING = 1 << 1, // "tiling": repeats the texture across the quad
+	SHADER_ANIMATION = 1 << 2, // "animation": selects a cell of an animation
+	SHADER_ALPHA_TEST = 1 << 3, // "alphaTest": discards transparent fragments
+	SHADER_ALL_FEATURES = 0xf
+};
+
 // Defines a shader resource
 class Shader : public OpenGLResource
 {
@@ -138,6 +155,12 @@ public:
 	void SetValue(const std::string& location, const glm::vec2& v);
 	void SetValue(const std::string& location, const glm::mat4& v);
 
+	// Returns the variant of the shader compiled with the features, nullptr if it has not been compiled yet
+	Shader* GetVariant(unsigned int features) const;
+
+	// Takes ownership of a variant, the variant is deleted along with this shader
+	void AddVariant(unsigned int features, Shader* pVariant);
+
 protected:
 
 	virtual ~Shader();
@@ -148,6 +171,9 @@ private:
 	GLuint m_color;
 	UnifromMap m_uniforms;
 	bool m_bUse;
+
+	// Variants compiled with a subset of the features of this shader
+	std::unordered_map<unsigned int, Shader*> m_variants;
 };
 
 // Defines a textured shader resource
@@ -170,6 +196,26 @@ private:
 	GLuint m_TextureSamplerID;
 };
 
+// Defines a static mesh resource stored in the shared mesh pool
+class StaticMesh : public IResource
+{
+public:
+
+	StaticMesh(const MeshRange& range);
+
+	void* QueryInterface(ResourceType type) const override;
+
+	const MeshRange& GetRange() const;
+
+protected:
+
+	virtual ~StaticMesh() {}
+
+private:
+
+	MeshRange m_range;
+};
+
 struct CharDescriptor
 {
 	unsigned short x, y;
@@ -228,6 +274,8 @@ private:
 std::istream& operator >>(const std::istream& stream, Font& out);
 
 // Resource Manager implementation
+// Resources are reference counted by the scopes that load them and by handles,
+// unreferenced textures are evicted least recently used first once the texture budget is exceeded
 class ResourceManager : public IResourceManager
 {
 public:
@@ -243,37 +291,156 @@ public:
 
 	bool LoadFont(const std::string& id, const std::string& file) override;
 
-	bool LoadShader(const std::string& id, const std::string& vert, const std::string& frag) override;
+	bool LoadShader(const std::string& id, const std::string& vert, const std::string& frag, const std::vector<std::string>& features = std::vector<std::string>()) override;
+
+	bool LoadMesh(const std::string& id, const std::string& file) override;
 
 	bool GetTextureInfo(const std::string& id, TextureInfo& out) const override;
 
 	void Clear() override;
 
+	void SetScope(const std::string& scope) override;
+	void ReleaseScope(const std::string& scope) override;
+
+	void AddRef(const std::string& id) override;
+	void Release(const std::string& id) override;
+
+	void SetTextureBudget(unsigned int uiBytes) override;
+	void SetDeletionBudget(unsigned int uiObjects) override;
+	unsigned int GetTextureMemory() const override;
+	unsigned int GetScopeMemory(const std::string& scope) const override;
+
+	bool PrefetchImage(const std::string& file) override;
+	bool PrefetchMesh(const std::string& file) override;
+	void ClearPrefetched() override;
+
 	// Method only accessible in the OpenGL plugin to access OpenGL specific information about the resources
 	// If the resource is not found, nullptr is returned
+	// The non-const methods reload the resource if it was evicted, the const methods return nullptr instead
+	// The manager is not thread safe, only the main thread may call these methods
 	IResource* GetResource(const std::string& name, ResourceType type);
 	const IResource* GetResource(const std::string& name, ResourceType type) const;
 
 	IResource* GetResource(const std::string& name);
 	const IResource* GetResource(const std::string& name) const;
 
+	// Returns the cheapest variant of the shader that provides the features, see ShaderFeature
+	// Variants are compiled the first time they are requested, features that the shader does not declare are ignored
+	// If the shader is not found, nullptr is returned
+	Shader* GetShader(const std::string& name, unsigned int features);
+
+	// Returns the buffers shared by all meshes
+	MeshPool& GetMeshPool();
+
+	// Evicts unreferenced textures until the texture memory fits the budget
+	// Resources reloaded by GetResource() are only evicted by the next call, so that the resources of a frame stay valid until it is rendered
+	// The renderer calls it once per frame while no frame is being recorded
+	void EnforceBudget();
+
+	// While deletion is deferred, unloaded resources are queued instead of being deleted, see TakeUnloaded()
+	// The render thread renders frames recorded earlier, so the resources they use must outlive them
+	// Disabling it deletes the queued resources
+	void DeferDeletion(bool bDefer);
+
+	// Appends the resources unloaded since the last call to out, they are deleted with DeleteResources()
+	void TakeUnloaded(std::vector<IResource*>& out);
+
+	// Deletes unloaded resources and clears the vector
+	// Only the mesh pool is touched, which is locked, so the render thread may call it
+	void DeleteResources(std::vector<IResource*>& resources);
+
 private:
 
-	typedef std::unordered_map<std::string, IResource*> ResourceMap;
+	struct ResourceEntry;
+	typedef std::list<std::pair<const std::string, ResourceEntry>*> LRUList;
+
+	struct ResourceEntry
+	{
+		IResource* pResource; // null if evicted
+		ResourceType type; // how the resource was loaded
+		std::string file;
+		std::string frag; // fragment shader file, only used by shaders
+		unsigned int uiFeatures; // features declared by a shader
+		unsigned int uiRefCount;
+		unsigned int uiSize; // bytes used by the resource while loaded
+		LRUList::iterator lruIter; // most recently used resources are at the back
+	};
+
+	typedef std::unordered_map<std::string, ResourceEntry> ResourceMap;
 
 	ResourceMap m_resources;
+	LRUList m_lru;
+
+	// ids referenced by each scope
+	std::unordered_map<std::string, std::unordered_set<std::string>> m_scopes;
+	std::string m_scope;
+
+	unsigned int m_uiTextureBudget;
+	unsigned int m_uiTextureMemory;
+
+	MeshPool m_meshPool;
 
+	// Resources unloaded while deletion is deferred
+	std::vector<IResource*> m_unloaded;
+	bool m_bDeferDeletion;
+
+	// Files decoded ahead of time by PrefetchImage() and PrefetchMesh(), they are taken by the first load of the file
+	struct PrefetchedImage
+	{
+		unsigned char* pImg;
+		int width;
+		int height;
+		int comp;
+	};
+
+	struct PrefetchedMesh
+	{
+		std::vector<VertexPT> vertices;
+		std::vector<unsigned int> indices;
+	};
+
+	std::mutex m_prefetchMutex;
+	std::unordered_map<std::string, PrefetchedImage> m_prefetchedImages;
+	std::unordered_map<std::string, PrefetchedMesh> m_prefetchedMeshes;
+
+	// Loads the resource, or adds a reference from the current scope if the id is already loaded
+	bool Load(const std::string& id, ResourceType type, const std::string& file, const std::string& frag = std::string(), unsigned int uiFeatures = 0);
+
+	// Creates the resource described by the entry, returns nullptr on error
+	IResource* CreateResource(ResourceEntry& entry);
+
+	// Deletes the resource, or queues it if deletion is deferred
+	void Unload(IResource* pResource);
+
+	// Deletes the resource, a mesh is removed from the mesh pool
+	void Delete(IResource* pResource);
+
+	// Moves the entry to the back of the LRU list
+	void Touch(ResourceMap::value_type& entry);
+
+	// Decodes an image, or takes it from the prefetched images
 	bool CreateTexture(const std::string& file, int& width, int& height, int& comp, unsigned char** pImgData);
+
+	// Loads a binary mesh file, removes duplicate vertices and optimizes the mesh for the vertex cache
+	// The mesh is taken from the prefetched meshes if it was prefetched
+	bool CreateMesh(const std::string& file, std::vector<VertexPT>& vertices, std::vector<unsigned int>& indices);
+
+	// Reads a binary mesh file, see CreateMesh(), does not touch any member so it can run on any thread
+	static bool ReadMesh(const std::string& file, std::vector<VertexPT>& vertices, std::vector<unsigned int>& indices);
 	bool CreateOpenGLTexture(const std::string& file, int& width, int& height, int& comp, unsigned char** pImgData, GLuint& out);
 
 	// converts # of components into the corresponding OpenGL format.
 	void GetOpenGLFormat(int comp, GLenum& format, GLint& internalFormat);
 
 	// Creates and returns an OpenGL shader of the specified type loaded from the file.
-	GLuint CreateGLShader(const std::string& file, GLenum type);
+	// Each feature is defined right after the #version directive
+	GLuint CreateGLShader(const std::string& file, GLenum type, unsigned int uiFeatures);
+
+	// Compiles and links a shader program with the features, returns nullptr on error
+	Shader* CreateShaderProgram(const std::string& vert, const std::string& frag, unsigned int uiFeatures);
 
-	// Create shader objects from program id
-	bool CreateShaderInstance(const std::string& id, GLuint programID);
+	// Create shader objects from program id, returns nullptr if the shader is missing required uniforms
+	Shader* CreateShaderInstance(GLuint programID);
 };
 
 #endif // _OGLRESOURCEMANAGER_
@@ -0,0 +1,48 @@
+#ifndef _SPRITE_BATCH_RENDERER_
+#define _SPRITE_BATCH_RENDERER_
+
+#include "IRenderable.h"
+#include "InstanceBuffer.h"
+#include "ApplyShader.h"
+#include "ResourceManager.h"
+#include "Mesh.h"
+#include <vector>
+
+// Defines how a batch of sprites submitted with DrawSprites() should be rendered
+// Buffer: InstanceBuffer the sprites get streamed into
+template< class Buffer >
+class SpriteBatchRenderable : public IRenderable
+{
+public:
+
+	typedef typename Buffer::InstanceType InstanceType;
+
+	SpriteBatchRenderable(Buffer* pBuffer, const std::vector<InstanceType>* pStream, unsigned int offset, unsigned int length) :
+		m_pBuffer(pBuffer), m_pStream(pStream), m_uiOffset(offset), m_uiLength(length)
+	{
+	}
+
+	void Render(const Mesh& mesh, ApplyShader& shader, const IResource*) override
+	{
+		shader->SetColor(glm::vec4(1.0f));
+
+		m_pBuffer->Upload(m_pStream->data() + m_uiOffset, m_uiLength);
+		m_pBuffer->Bind();
+		m_pBuffer->Draw(m_uiLength);
+
+		// Restore the quad for the rest of the renderables
+		mesh.Bind();
+	}
+
+private:
+
+	// Buffer the sprites get streamed into
+	Buffer* m_pBuffer;
+
+	// Range of the frame's sprite stream that belongs to this batch
+	const std::vector<InstanceType>* m_pStream;
+	unsigned int m_uiOffset;
+	unsigned int m_uiLength;
+};
+
+#endif // _SPRITE_BATCH_RENDERER_
@@ -16,3 +16,20 @@ void SpriteRenderable::Render(const Mesh& mesh, ApplyShader& shader, const IReso
 
 	mesh.Draw();
 }
+
+unsigned int SpriteRenderable::GetShaderFeatures() const
+{
+	unsigned int features = 0;
+
+	if(tiling != glm::vec2(1.0f))
+	{
+		features |= SHADER_TILING;
+	}
+
+	if(color.a <= 0.0f)
+	{
+		features |= SHADER_ALPHA_TEST;
+	}
+
+	return features;
+}
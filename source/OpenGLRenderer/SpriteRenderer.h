@@ -14,6 +14,9 @@ public:
 
 	void Render(const class Mesh& mesh, class ApplyShader& shader, const IResource* resource) override;
 
+	// Tiling is only needed if the texture is repeated, color only sprites only need the alpha test if they are invisible
+	unsigned int GetShaderFeatures() const override;
+
 private:
 
 	// Transformation applied to the sprite
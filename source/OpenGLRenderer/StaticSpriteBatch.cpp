@@ -0,0 +1,102 @@
+#include "StaticSpriteBatch.h"
+#include "ApplyShader.h"
+#include "ResourceManager.h"
+#include "Mesh.h"
+#include "DeletionQueue.h"
+
+#include <cmath>
+
+StaticSpriteBatch::StaticSpriteBatch() : m_iLayer(0), m_uiVersion(0), m_buffer(0), m_uiUploadedVersion(0), m_uiUploadedLength(0)
+{
+}
+
+StaticSpriteBatch::~StaticSpriteBatch()
+{
+	// The buffer may still be used by frames in flight
+	DeletionQueue::Instance().DeleteBuffer(m_buffer);
+}
+
+void StaticSpriteBatch::Update(const SpriteInstance* pArray, unsigned int length)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (pArray != nullptr)
+	{
+		m_sprites.assign(pArray, pArray + length);
+	}
+	else
+	{
+		m_sprites.clear();
+	}
+
+	m_iLayer = m_sprites.empty() ? 0 : (int)floor(m_sprites[0].transformation[3].z);
+	++m_uiVersion;
+}
+
+std::vector<SpriteInstance> StaticSpriteBatch::GetSprites() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_sprites;
+}
+
+int StaticSpriteBatch::GetLayer() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_iLayer;
+}
+
+unsigned int StaticSpriteBatch::GetVersion() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_uiVersion;
+}
+
+void StaticSpriteBatch::Draw(SpriteBuffer& buffer)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// Only a batch that changed since it was last drawn gets uploaded
+		if ((m_buffer == 0) || (m_uiUploadedVersion != m_uiVersion))
+		{
+			if (m_buffer == 0)
+			{
+				glGenBuffers(1, &m_buffer);
+			}
+
+			GLsizeiptr size = m_sprites.size() * sizeof(SpriteInstance);
+
+			glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+			glBufferData(GL_ARRAY_BUFFER, size, m_sprites.data(), GL_STATIC_DRAW);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+			RenderCounters::Instance().Upload((unsigned int)size);
+
+			m_uiUploadedVersion = m_uiVersion;
+			m_uiUploadedLength = (unsigned int)m_sprites.size();
+		}
+	}
+
+	if (m_uiUploadedLength > 0)
+	{
+		buffer.SetInstanceBuffer(m_buffer);
+		buffer.Draw(m_uiUploadedLength);
+		buffer.SetInstanceBuffer(0);
+	}
+}
+
+StaticSpriteBatchRenderable::StaticSpriteBatchRenderable(SpriteBuffer* pBuffer, const std::shared_ptr<StaticSpriteBatch>& pBatch) :
+	m_pBuffer(pBuffer), m_pBatch(pBatch)
+{
+}
+
+void StaticSpriteBatchRenderable::Render(const Mesh& mesh, ApplyShader& shader, const IResource*)
+{
+	shader->SetColor(glm::vec4(1.0f));
+
+	m_pBuffer->Bind();
+	m_pBatch->Draw(*m_pBuffer);
+
+	// Restore the quad for the rest of the renderables
+	mesh.Bind();
+}
@@ -0,0 +1,67 @@
+#ifndef _STATICSPRITEBATCH_
+#define _STATICSPRITEBATCH_
+
+#include "IRenderable.h"
+#include "InstanceBuffer.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Sprites that stay on the GPU between frames, see IRenderer::CreateSpriteBatch()
+// The main thread updates the sprites while the render thread may draw the batch, the sprites are uploaded by the thread that draws them
+class StaticSpriteBatch
+{
+public:
+
+	StaticSpriteBatch();
+	~StaticSpriteBatch();
+
+	// Replaces the sprites, they are uploaded the next time the batch is drawn
+	void Update(const SpriteInstance* pArray, unsigned int length);
+
+	// Returns a copy of the sprites, used to capture the batch
+	std::vector<SpriteInstance> GetSprites() const;
+
+	// Returns the z level of the batch, taken from its first sprite
+	int GetLayer() const;
+
+	// Returns a number incremented by each update
+	unsigned int GetVersion() const;
+
+	// Draws the sprites with the instance format of the buffer, the buffer must be bound
+	void Draw(SpriteBuffer& buffer);
+
+private:
+
+	mutable std::mutex m_mutex;
+	std::vector<SpriteInstance> m_sprites;
+	int m_iLayer;
+	unsigned int m_uiVersion;
+
+	// Buffer objects are shared between contexts, so the batch can be drawn by any thread
+	GLuint m_buffer;
+	unsigned int m_uiUploadedVersion;
+	unsigned int m_uiUploadedLength;
+
+	StaticSpriteBatch(const StaticSpriteBatch&) = delete;
+	StaticSpriteBatch& operator = (const StaticSpriteBatch&) = delete;
+};
+
+// Defines how a static sprite batch should be rendered
+class StaticSpriteBatchRenderable : public IRenderable
+{
+public:
+
+	StaticSpriteBatchRenderable(SpriteBuffer* pBuffer, const std::shared_ptr<StaticSpriteBatch>& pBatch);
+
+	void Render(const class Mesh& mesh, class ApplyShader& shader, const class IResource* resource) override;
+
+private:
+
+	SpriteBuffer* m_pBuffer;
+
+	// The batch is kept alive until the frame is rendered, even if it gets destroyed in the meantime
+	std::shared_ptr<StaticSpriteBatch> m_pBatch;
+};
+
+#endif // _STATICSPRITEBATCH_
@@ -2,27 +2,43 @@
 #define _VERTEXBUFFER_
 
 #include <GL/glew.h>
+#include "VertexLayout.h"
 #include "VertexStructures.h"
+#include "RenderCounters.h"
+#include "DeletionQueue.h"
 
 // Defines a a vertex buffer which manages the creation buffers(vao and vbo) which are
 // needed to render objects
+// Format: VertexFormat of the vertices
+// InstanceFormat: VertexFormat of the per instance data streamed with UploadInstances(), or NoInstances
+template< class Format, class InstanceFormat = NoInstances >
 class VertexBuffer
 {
 public:
 
+	static_assert((Format::LOCATIONS & InstanceFormat::LOCATIONS) == 0, "Vertex and instance attributes share a location");
+
+	typedef typename Format::VertexType VertexType;
+	typedef typename InstanceFormat::VertexType InstanceType;
 
 	// Construct a VertexBuffer,
 	// pVertexBuffer: pointer to the vertex buffer. May be null if the buffer is dynamic or streamed
-	// vertexStructureSize: the size of the vertex structure in bytes
 	// vertexBufferLength: the number of vertices to be part of the vertex buffer
 	// usage: Specifies the usage of the vertex buffer. Can be GL_STATIC_DRAW, GL_STREAM_DRAW, or GL_DYNAMIC_DRAW
 	// pIndexBuffer: pointer to the index buffer. This pointer cannot be null
 	// indexSize: size of the underlying type of the index buffer array
 	// indexBufferLength: length of the index buffer
-	// bTexture: should be true if the vertex structure uses a texture, else false
-	VertexBuffer(void* pVertexBuffer, GLuint vertexStructureSize, GLuint vertexBufferLength, GLenum usage, void* pIndexBuffer, GLuint indexSize, GLuint indexBufferLength, bool bTexture = true);
+	VertexBuffer(const VertexType* pVertexBuffer, GLuint vertexBufferLength, GLenum usage, const void* pIndexBuffer, GLuint indexSize, GLuint indexBufferLength);
 	~VertexBuffer();
 
+	// Copies the instances into the instance buffer
+	// The old storage of the buffer is orphaned so that the driver does not need to wait on draws still using it
+	void UploadInstances(const InstanceType* pArray, GLuint length);
+
+	// Reads the instances from another buffer, 0 restores the instance buffer
+	// The buffer must hold instances of InstanceFormat, the vertex array object must be bound
+	void SetInstanceBuffer(GLuint buffer);
+
 	// Binds the vertex buffer object
 	void BindVBO() const;
 
@@ -42,15 +58,20 @@ private:
 
 	GLuint m_vertexBuffer;
 	GLuint m_indexBuffer;
+	GLuint m_instanceBuffer;
 	GLuint m_arrayObject;
 	GLuint m_length;
 	GLuint m_size;
 
+	// Size of the instance buffer in bytes
+	GLsizeiptr m_instanceCapacity;
+
 	// This class cannot be copied
 	VertexBuffer(const VertexBuffer&) = delete;
 	VertexBuffer& operator = (const VertexBuffer&) = delete;
 	
 };
 
+#include "VertexBuffer.inl"
 
 #endif // _VERTEXBUFFER_
@@ -0,0 +1,113 @@
+#include <cassert>
+
+template< class Format, class InstanceFormat >
+VertexBuffer<Format, InstanceFormat>::VertexBuffer(const VertexType* pVertexBuffer, GLuint vertexBufferLength, GLenum usage, const void* pIndexBuffer, GLuint indexSize, GLuint indexBufferLength) :
+	m_instanceBuffer(0), m_length(vertexBufferLength), m_size(sizeof(VertexType) * vertexBufferLength), m_instanceCapacity(0)
+{
+	assert(pIndexBuffer != nullptr);
+
+	glGenVertexArrays(1,&m_arrayObject);
+	glBindVertexArray(m_arrayObject);
+
+	glGenBuffers(1,&m_vertexBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER,m_vertexBuffer);
+
+	glBufferData(GL_ARRAY_BUFFER, m_size, pVertexBuffer, usage);
+
+	glGenBuffers(1, &m_indexBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBufferLength * indexSize, pIndexBuffer, GL_STATIC_DRAW);
+
+	RenderCounters::Instance().Upload(m_size + indexBufferLength * indexSize);
+
+	Format::Enable();
+
+	// Per instance data is stored in its own buffer so that it can be streamed without touching the vertices
+	if(InstanceFormat::ENABLED)
+	{
+		glGenBuffers(1, &m_instanceBuffer);
+		glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+
+		InstanceFormat::Enable();
+	}
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+template< class Format, class InstanceFormat >
+VertexBuffer<Format, InstanceFormat>::~VertexBuffer()
+{
+	// The buffers may still be used by frames in flight
+	DeletionQueue& queue = DeletionQueue::Instance();
+	queue.DeleteBuffer(m_vertexBuffer);
+	queue.DeleteBuffer(m_indexBuffer);
+	queue.DeleteBuffer(m_instanceBuffer);
+	queue.DeleteVertexArray(m_arrayObject);
+}
+
+template< class Format, class InstanceFormat >
+void VertexBuffer<Format, InstanceFormat>::UploadInstances(const InstanceType* pArray, GLuint length)
+{
+	static_assert(InstanceFormat::ENABLED, "VertexBuffer has no instance format");
+
+	GLsizeiptr size = length * sizeof(InstanceType);
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+
+	if (size > m_instanceCapacity)
+	{
+		m_instanceCapacity = size;
+	}
+
+	glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, pArray);
+
+	RenderCounters::Instance().Upload((unsigned int)size);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+template< class Format, class InstanceFormat >
+void VertexBuffer<Format, InstanceFormat>::SetInstanceBuffer(GLuint buffer)
+{
+	static_assert(InstanceFormat::ENABLED, "VertexBuffer has no instance format");
+
+	glBindBuffer(GL_ARRAY_BUFFER, (buffer != 0) ? buffer : m_instanceBuffer);
+
+	// The attribute pointers of the vertex array object capture the buffer bound when they are set
+	InstanceFormat::Enable();
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+template< class Format, class InstanceFormat >
+void VertexBuffer<Format, InstanceFormat>::BindVBO() const
+{
+	glBindBuffer(GL_ARRAY_BUFFER,m_vertexBuffer);
+}
+
+template< class Format, class InstanceFormat >
+void VertexBuffer<Format, InstanceFormat>::BindVAO() const
+{
+	glBindVertexArray(m_arrayObject);
+}
+
+template< class Format, class InstanceFormat >
+GLuint VertexBuffer<Format, InstanceFormat>::GetLength() const
+{
+	return m_length;
+}
+
+template< class Format, class InstanceFormat >
+GLuint VertexBuffer<Format, InstanceFormat>::GetSize() const
+{
+	return m_size;
+}
+
+template< class Format, class InstanceFormat >
+GLuint VertexBuffer<Format, InstanceFormat>::GetVertexSize() const
+{
+	return sizeof(VertexType);
+}
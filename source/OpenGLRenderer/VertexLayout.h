@@ -0,0 +1,143 @@
+#ifndef _VERTEXLAYOUT_
+#define _VERTEXLAYOUT_
+
+#include <GL/glew.h>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <cstddef>
+
+// Describes how the shader reads an attribute
+// The format of float, unsigned int and glm vector members is deduced from their type, all of them are read as floats
+template< class T >
+struct AttributeFormat;
+
+template< class T, GLint Components, GLenum Type, GLboolean Normalized >
+struct AttributeFormatBase
+{
+	static const GLint COMPONENTS = Components;
+	static const GLenum TYPE = Type;
+	static const GLboolean NORMALIZED = Normalized;
+	static const size_t BYTES = sizeof(T);
+};
+
+template<> struct AttributeFormat<float> : AttributeFormatBase<float, 1, GL_FLOAT, GL_FALSE> {};
+template<> struct AttributeFormat<unsigned int> : AttributeFormatBase<unsigned int, 1, GL_UNSIGNED_INT, GL_FALSE> {};
+template<> struct AttributeFormat<glm::vec2> : AttributeFormatBase<glm::vec2, 2, GL_FLOAT, GL_FALSE> {};
+template<> struct AttributeFormat<glm::vec3> : AttributeFormatBase<glm::vec3, 3, GL_FLOAT, GL_FALSE> {};
+template<> struct AttributeFormat<glm::vec4> : AttributeFormatBase<glm::vec4, 4, GL_FLOAT, GL_FALSE> {};
+
+// Four unsigned bytes packed into an unsigned int, read by the shader as a vec4 in [0, 1]. ex: RGBA8 color
+struct NormalizedUByte4 : AttributeFormatBase<unsigned int, 4, GL_UNSIGNED_BYTE, GL_TRUE> {};
+
+// Two signed shorts packed into an unsigned int, read by the shader as a vec2 in [-1, 1]
+struct NormalizedShort2 : AttributeFormatBase<unsigned int, 2, GL_SHORT, GL_TRUE> {};
+
+// Defines a single attribute of a vertex
+// Location: attribute location in the shader
+// Member: type of the member in the vertex structure
+// Offset: offset of the member in the vertex structure
+// Divisor: 0 if the attribute advances per vertex, else the number of instances between each advance
+// Format: how the shader reads the member
+template< GLuint Location, class Member, size_t Offset, GLuint Divisor = 0, class Format = AttributeFormat<Member> >
+struct VertexAttribute
+{
+	static_assert(sizeof(Member) == Format::BYTES, "Vertex member does not match the size of the attribute format");
+	static_assert(Location < 16, "Attribute location is out of range");
+
+	static const GLuint LOCATION = Location;
+	static const size_t OFFSET = Offset;
+	static const size_t END = Offset + sizeof(Member);
+
+	static void Enable(GLsizei stride)
+	{
+		glEnableVertexAttribArray(Location);
+		glVertexAttribPointer(Location, Format::COMPONENTS, Format::TYPE, Format::NORMALIZED, stride, reinterpret_cast<void*>(Offset));
+		glVertexAttribDivisor(Location, Divisor);
+	}
+};
+
+// Helpers to declare attributes from a member of the vertex structure
+#define VERTEX_ATTRIBUTE(location, vertex, member) VertexAttribute<location, decltype(vertex::member), offsetof(vertex, member)>
+#define INSTANCE_ATTRIBUTE(location, vertex, member) VertexAttribute<location, decltype(vertex::member), offsetof(vertex, member), 1>
+#define INSTANCE_ATTRIBUTE_AS(location, vertex, member, format) VertexAttribute<location, decltype(vertex::member), offsetof(vertex, member), 1, format>
+
+namespace Detail
+{
+	// Bitmask of the locations used by a list of attributes, fails to compile if a location is used twice
+	template< class... Attributes >
+	struct LocationMask
+	{
+		static const unsigned int value = 0;
+	};
+
+	template< class Attribute, class... Rest >
+	struct LocationMask<Attribute, Rest...>
+	{
+		static_assert((LocationMask<Rest...>::value & (1u << Attribute::LOCATION)) == 0, "Attribute location is used twice");
+		static const unsigned int value = LocationMask<Rest...>::value | (1u << Attribute::LOCATION);
+	};
+
+	// Largest end offset of a list of attributes
+	template< class... Attributes >
+	struct MaxEnd
+	{
+		static const size_t value = 0;
+	};
+
+	template< class Attribute, class... Rest >
+	struct MaxEnd<Attribute, Rest...>
+	{
+		static const size_t value = (Attribute::END > MaxEnd<Rest...>::value) ? Attribute::END : MaxEnd<Rest...>::value;
+	};
+
+	// Enables a list of attributes
+	template< class... Attributes >
+	struct EnableAttributes
+	{
+		static void Enable(GLsizei) {}
+	};
+
+	template< class Attribute, class... Rest >
+	struct EnableAttributes<Attribute, Rest...>
+	{
+		static void Enable(GLsizei stride)
+		{
+			Attribute::Enable(stride);
+			EnableAttributes<Rest...>::Enable(stride);
+		}
+	};
+}
+
+// Defines the layout of a vertex structure
+// Vertex: the vertex structure stored in the buffer
+// Attributes: list of VertexAttribute
+template< class Vertex, class... Attributes >
+struct VertexFormat
+{
+	static_assert(Detail::MaxEnd<Attributes...>::value <= sizeof(Vertex), "Attribute lies outside of the vertex structure");
+
+	typedef Vertex VertexType;
+
+	static const bool ENABLED = true;
+	static const unsigned int LOCATIONS = Detail::LocationMask<Attributes...>::value;
+
+	// Configures the attributes of the currently bound vertex array object from the currently bound array buffer
+	static void Enable()
+	{
+		Detail::EnableAttributes<Attributes...>::Enable(sizeof(Vertex));
+	}
+};
+
+// Used by VertexBuffer when there is no per instance data
+struct NoInstances
+{
+	typedef void VertexType;
+
+	static const bool ENABLED = false;
+	static const unsigned int LOCATIONS = 0;
+
+	static void Enable() {}
+};
+
+#endif // _VERTEXLAYOUT_
@@ -4,6 +4,7 @@
 #include <glm/vec4.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec2.hpp>
+#include "VertexLayout.h"
 
 struct VertexP
 {
@@ -16,4 +17,11 @@ struct VertexPT
 	glm::vec2 tex;
 };
 
+typedef VertexFormat<VertexP,
+	VERTEX_ATTRIBUTE(0, VertexP, pos)> VertexFormatP;
+
+typedef VertexFormat<VertexPT,
+	VERTEX_ATTRIBUTE(0, VertexPT, pos),
+	VERTEX_ATTRIBUTE(1, VertexPT, tex)> VertexFormatPT;
+
 #endif // __VERTEXSTRUCTURES__
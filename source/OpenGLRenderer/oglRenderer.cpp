@@ -3,12 +3,16 @@
 #include "ApplyShader.h"
 #include "VertexStructures.h"
 #include "oglCallback.h"
+#include "RenderCounters.h"
+#include "DeletionQueue.h"
+#include "Timer.h"
 #include "Log.h"
 
 #include <sstream>
 #include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <cstring>
 
 using namespace std;
 
@@ -29,10 +33,17 @@ void oglRenderer::IconifyCallback(GLFWwindow* window, int flag)
 }
 
 oglRenderer::oglRenderer() : m_pWorldCamera(nullptr), m_pWindow(nullptr), m_pWorldSpaceSprites(nullptr), m_pScreenSpaceSprites(nullptr),
-m_pMonitors(nullptr), m_iMonitorCount(0), m_iCurrentMonitor(0), m_iCurrentDisplayMode(0), m_renderSpace(RenderSpace::Screen), m_bFullscreen(true)
+m_pMonitors(nullptr), m_iMonitorCount(0), m_iCurrentMonitor(0), m_iCurrentDisplayMode(0), m_renderSpace(RenderSpace::Screen), m_bFullscreen(true), m_iNextSpriteBatch(1), m_statsHistory(), m_uiStatsFrame(0), m_uiMaxFramesInFlight(2)
 {
 	s_pThis = this;
 	m_iClearBits = GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT;
+	m_clearColor = glm::vec3(0.0f);
+
+	// GLFW could not be initialized or there is no display, see GLFWInit
+	if (glfwGetPrimaryMonitor() == nullptr)
+	{
+		throw std::string("No monitor found, use the headless mode");
+	}
 
 	ParseVideoSettingsFile();
 	EnumerateDisplayAdaptors();
@@ -46,6 +57,26 @@ m_pMonitors(nullptr), m_iMonitorCount(0), m_iCurrentMonitor(0), m_iCurrentDispla
 
 oglRenderer::~oglRenderer()
 {
+	// Release every GPU object while the context still exists
+	m_pRenderThread.reset();
+	m_spriteBatches.clear();
+	m_pWorldSpaceSprites.reset();
+	m_pScreenSpaceSprites.reset();
+	m_mesh.reset();
+	m_particleBuffer.reset();
+	m_spriteBuffer.reset();
+	m_sprite2DBuffer.reset();
+	m_rm.Clear();
+	m_dynamicResolution.Release();
+	m_frameElision.Release();
+
+	DeletionQueue::Instance().Flush();
+
+	for (GLsync fence : m_frameFences)
+	{
+		glDeleteSync(fence);
+	}
+
 	glfwDestroyWindow(m_pWindow);
 }
 
@@ -64,14 +95,23 @@ int oglRenderer::GetVersion() const
 
 void oglRenderer::DrawLine(const glm::vec3* pArray, unsigned int length, float fWidth, const glm::vec4& color, const glm::mat4& T)
 {
-	if (m_renderSpace == World)
+	if (m_pCapture)
 	{
-		m_pWorldSpaceSprites->DrawLine(pArray, length, fWidth, color, T);
+		m_pCapture->DrawLine(pArray, length, fWidth, color, T);
 	}
-	else
+
+	if (m_frameElision.IsEnabled() && (pArray != nullptr))
 	{
-		m_pScreenSpaceSprites->DrawLine(pArray, length, fWidth, color, T);
+		uint64_t hash = HashCommand(RenderCommand::Line);
+		FrameElision::Hash(hash, pArray, length * sizeof(glm::vec3));
+		FrameElision::Hash(hash, fWidth);
+		FrameElision::Hash(hash, color);
+		FrameElision::Hash(hash, T);
+
+		AddCommand(hash, pArray, length, T, fWidth);
 	}
+
+	GetSpaceRenderer().DrawLine(pArray, length, fWidth, color, T);
 }
 
 void oglRenderer::DrawCircle(const glm::vec3 &center, float radius, float thickness, unsigned int segments, const glm::vec4 &color)
@@ -90,38 +130,206 @@ void oglRenderer::DrawCircle(const glm::vec3 &center, float radius, float thickn
 
 void oglRenderer::DrawString(const char* str, const glm::vec3& pos, const glm::vec4& color, float scale, const char* font, FontAlignment alignment)
 {
-	if (m_renderSpace == World)
+	if (m_pCapture)
 	{
-		m_pWorldSpaceSprites->DrawString(str, font, pos, scale, color, alignment);
+		m_pCapture->DrawString(str, pos, color, scale, font, alignment);
 	}
-	else
+
+	if (m_frameElision.IsEnabled() && (str != nullptr))
 	{
-		m_pScreenSpaceSprites->DrawString(str, font, pos, scale, color, alignment);
+		const char* pFontName = (font != nullptr) ? font : "font";
+
+		uint64_t hash = HashCommand(RenderCommand::Text);
+		FrameElision::Hash(hash, str, strlen(str) + 1);
+		FrameElision::Hash(hash, pFontName, strlen(pFontName) + 1);
+		FrameElision::Hash(hash, pos);
+		FrameElision::Hash(hash, color);
+		FrameElision::Hash(hash, scale);
+		FrameElision::Hash(hash, alignment);
+
+		const Font* pFont = static_cast<const Font*>(m_rm.GetResource(pFontName, ResourceType::Font));
+		if (pFont != nullptr)
+		{
+			Math::FRECT rect(glm::vec2(pos.x, pos.y));
+			FontRenderable::GetStringRect(str, pFont, scale, alignment, rect);
+
+			// Glyphs may extend past the advance of the characters
+			glm::vec3 corners[] = { glm::vec3(rect.topLeft, pos.z), glm::vec3(rect.bottomRight, pos.z) };
+			AddCommand(hash, corners, 2, glm::mat4(1.0f), scale * 0.25f);
+		}
+		else
+		{
+			AddCommand(hash, nullptr, 0, glm::mat4(1.0f), 0.0f);
+		}
 	}
+
+	GetSpaceRenderer().DrawString(str, font, pos, scale, color, alignment);
 }
 
 void oglRenderer::DrawSprite(const std::string& texture, const glm::mat4& transformation, const glm::vec4& color, const glm::vec2& tiling, unsigned int iCellId, const std::string& tech)
 {
-	if(m_renderSpace == World)
+	if (m_pCapture)
 	{
-		m_pWorldSpaceSprites->DrawSprite(tech,texture,transformation,color,tiling,iCellId);
+		m_pCapture->DrawSprite(texture, transformation, color, tiling, iCellId, tech);
 	}
-	else
+
+	if (m_frameElision.IsEnabled())
 	{
-		m_pScreenSpaceSprites->DrawSprite(tech,texture,transformation,color,tiling,iCellId);
+		uint64_t hash = HashCommand(RenderCommand::Sprite);
+		FrameElision::Hash(hash, texture.data(), texture.size() + 1);
+		FrameElision::Hash(hash, tech.data(), tech.size() + 1);
+		FrameElision::Hash(hash, transformation);
+		FrameElision::Hash(hash, color);
+		FrameElision::Hash(hash, tiling);
+		FrameElision::Hash(hash, iCellId);
+
+		// Corners of the sprite quad
+		const glm::vec3 corners[] = { glm::vec3(-0.5f, -0.5f, 0.0f), glm::vec3(0.5f, -0.5f, 0.0f), glm::vec3(-0.5f, 0.5f, 0.0f), glm::vec3(0.5f, 0.5f, 0.0f) };
+		AddCommand(hash, corners, 4, transformation, 0.0f);
 	}
+
+	GetSpaceRenderer().DrawSprite(tech,texture,transformation,color,tiling,iCellId);
 }
 
 void oglRenderer::DrawSprite(const glm::mat4& transformation, const glm::vec4& color, const glm::vec2& tiling, unsigned int iCellId, const std::string& tech)
 {
-	if (m_renderSpace == World)
+	DrawSprite("blank", transformation, color, tiling, iCellId, tech);
+}
+
+void oglRenderer::DrawSprites(const std::string& texture, const SpriteInstance* pArray, unsigned int length, const std::string& tech)
+{
+	if (m_pCapture)
 	{
-		m_pWorldSpaceSprites->DrawSprite(tech, "blank", transformation, color, tiling, iCellId);
+		m_pCapture->DrawSprites(texture, pArray, length, tech);
 	}
-	else
+
+	if (m_frameElision.IsEnabled() && (pArray != nullptr))
+	{
+		uint64_t hash = HashCommand(RenderCommand::Sprites);
+		FrameElision::Hash(hash, texture.data(), texture.size() + 1);
+		FrameElision::Hash(hash, tech.data(), tech.size() + 1);
+		FrameElision::Hash(hash, pArray, length * sizeof(SpriteInstance));
+
+		AddCommand(hash, nullptr, 0, glm::mat4(1.0f), 0.0f);
+	}
+
+	GetSpaceRenderer().DrawSprites(tech, texture, pArray, length);
+}
+
+void oglRenderer::DrawSprites(const std::string& texture, const Sprite2D* pArray, unsigned int length, const std::string& tech)
+{
+	if (m_pCapture)
+	{
+		m_pCapture->DrawSprites(texture, pArray, length, tech);
+	}
+
+	if (m_frameElision.IsEnabled() && (pArray != nullptr))
+	{
+		uint64_t hash = HashCommand(RenderCommand::Sprites2D);
+		FrameElision::Hash(hash, texture.data(), texture.size() + 1);
+		FrameElision::Hash(hash, tech.data(), tech.size() + 1);
+		FrameElision::Hash(hash, pArray, length * sizeof(Sprite2D));
+
+		AddCommand(hash, nullptr, 0, glm::mat4(1.0f), 0.0f);
+	}
+
+	GetSpaceRenderer().DrawSprites(tech, texture, pArray, length);
+}
+
+void oglRenderer::DrawParticles(const std::string& texture, const ParticleVertex* pArray, unsigned int length, const std::string& tech)
+{
+	if (m_pCapture)
 	{
-		m_pScreenSpaceSprites->DrawSprite(tech, "blank", transformation, color, tiling, iCellId);
+		m_pCapture->DrawParticles(texture, pArray, length, tech);
+	}
+
+	if (m_frameElision.IsEnabled() && (pArray != nullptr))
+	{
+		uint64_t hash = HashCommand(RenderCommand::Particles);
+		FrameElision::Hash(hash, texture.data(), texture.size() + 1);
+		FrameElision::Hash(hash, tech.data(), tech.size() + 1);
+		FrameElision::Hash(hash, pArray, length * sizeof(ParticleVertex));
+
+		AddCommand(hash, nullptr, 0, glm::mat4(1.0f), 0.0f);
 	}
+
+	GetSpaceRenderer().DrawParticles(tech, texture, pArray, length);
+}
+
+void oglRenderer::DrawMesh(const std::string& mesh, const std::string& texture, const glm::mat4& transformation, const glm::vec4& color, const std::string& tech)
+{
+	if (m_pCapture)
+	{
+		m_pCapture->DrawMesh(mesh, texture, transformation, color, tech);
+	}
+
+	if (m_frameElision.IsEnabled())
+	{
+		uint64_t hash = HashCommand(RenderCommand::Mesh);
+		FrameElision::Hash(hash, mesh.data(), mesh.size() + 1);
+		FrameElision::Hash(hash, texture.data(), texture.size() + 1);
+		FrameElision::Hash(hash, tech.data(), tech.size() + 1);
+		FrameElision::Hash(hash, transformation);
+		FrameElision::Hash(hash, color);
+
+		AddCommand(hash, nullptr, 0, glm::mat4(1.0f), 0.0f);
+	}
+
+	GetSpaceRenderer().DrawMesh(tech, texture, mesh, transformation, color);
+}
+
+int oglRenderer::CreateSpriteBatch()
+{
+	int index = m_iNextSpriteBatch++;
+	m_spriteBatches.emplace(index, std::make_shared<StaticSpriteBatch>());
+
+	return index;
+}
+
+void oglRenderer::DestroySpriteBatch(int batch)
+{
+	m_spriteBatches.erase(batch);
+}
+
+void oglRenderer::UpdateSpriteBatch(int batch, const SpriteInstance* pArray, unsigned int length)
+{
+	auto iter = m_spriteBatches.find(batch);
+	if (iter != m_spriteBatches.end())
+	{
+		iter->second->Update(pArray, length);
+	}
+}
+
+void oglRenderer::DrawSpriteBatch(int batch, const std::string& texture, const std::string& tech)
+{
+	auto iter = m_spriteBatches.find(batch);
+	if (iter == m_spriteBatches.end())
+		return;
+
+	const std::shared_ptr<StaticSpriteBatch>& pBatch = iter->second;
+
+	// Captures are replayed without the batch, so the sprites are recorded
+	if (m_pCapture)
+	{
+		std::vector<SpriteInstance> sprites = pBatch->GetSprites();
+		m_pCapture->DrawSprites(texture, sprites.data(), (unsigned int)sprites.size(), tech);
+	}
+
+	// The sprites only change when the batch is updated, so hashing the version is enough
+	if (m_frameElision.IsEnabled())
+	{
+		unsigned int uiVersion = pBatch->GetVersion();
+
+		uint64_t hash = HashCommand(RenderCommand::Sprites);
+		FrameElision::Hash(hash, texture.data(), texture.size() + 1);
+		FrameElision::Hash(hash, tech.data(), tech.size() + 1);
+		FrameElision::Hash(hash, &batch, sizeof(batch));
+		FrameElision::Hash(hash, &uiVersion, sizeof(uiVersion));
+
+		AddCommand(hash, nullptr, 0, glm::mat4(1.0f), 0.0f);
+	}
+
+	GetSpaceRenderer().DrawSpriteBatch(tech, texture, pBatch);
 }
 
 int oglRenderer::CreateCursor(const std::string& texture, int xhot, int yhot)
@@ -172,11 +380,29 @@ void oglRenderer::SetCursor(int cursor)
 
 IResourceManager& oglRenderer::GetResourceManager()
 {
+	// Resources unloaded while the render thread is enabled are deleted by the thread once the frames using them are rendered
 	return m_rm;
 }
 
 float oglRenderer::ReadPixels(const glm::ivec2 &pos) const
 {
+	// The depth is read by the render thread from the next frame it renders
+	if (m_pRenderThread)
+	{
+		return m_pRenderThread->ReadDepth(pos);
+	}
+
+	// The depth of the world space pass is in the offscreen framebuffer
+	if (m_dynamicResolution.IsEnabled())
+	{
+		return m_dynamicResolution.ReadDepth(pos);
+	}
+
+	if (m_frameElision.IsCached())
+	{
+		return m_frameElision.ReadDepth(pos);
+	}
+
 	float depth = 0.0f;
 	glReadPixels(pos.x, pos.y, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &depth);
 
@@ -256,12 +482,15 @@ void oglRenderer::GetStringRect(const char* str, float scale, FontAlignment alig
 void oglRenderer::SetCamera(PerspectiveCamera* pCam)
 {
 	m_pWorldCamera = pCam;
-	m_pWorldSpaceSprites->SetCamera(pCam);
+	m_pWorldSpaceSprites->SetCamera(pCam); // the render thread copies the camera during Present()
+	m_frameElision.Invalidate();
 }
 
 void oglRenderer::SetClearColor(const glm::vec3& color)
 {
 	glClearColor(color.x,color.y,color.z,0.0f);
+	m_clearColor = color;
+	m_frameElision.Invalidate();
 }
 
 void oglRenderer::EnableColorClearing(bool bEnable)
@@ -271,41 +500,91 @@ void oglRenderer::EnableColorClearing(bool bEnable)
 	{
 		m_iClearBits |= GL_COLOR_BUFFER_BIT;
 	}
+
+	m_frameElision.Invalidate();
 }
 
 void oglRenderer::SetDisplayMode(int i)
 {
-	std::pair<const GLFWvidmode*, int> videoMode = m_videoModes[m_iCurrentMonitor];
-	if (i < videoMode.second && i >= 0)
+	if (GetDisplayMode(m_iCurrentMonitor, i) != nullptr)
 	{
-		int index = videoMode.second - i - 1;
-		glfwSetWindowSize(m_pWindow, videoMode.first[index].width, videoMode.first[index].height);
-		UpdateCamera();
-
 		m_iCurrentDisplayMode = i;
+		ApplyDisplayMode();
 	}
 }
 
+void oglRenderer::SetFullscreen(bool bFullscreen)
+{
+	if (bFullscreen != m_bFullscreen)
+	{
+		m_bFullscreen = bFullscreen;
+		ApplyDisplayMode();
+	}
+}
+
+bool oglRenderer::IsFullscreen() const
+{
+	return m_bFullscreen;
+}
+
 void oglRenderer::SetRenderSpace(RenderSpace space)
 {
+	if (m_pCapture)
+	{
+		m_pCapture->SetRenderSpace(space);
+	}
+
 	m_renderSpace = space;
 }
 
 void oglRenderer::SetShaderValue(const std::string& shader, const string& location, float value)
 {
-	ApplyShader pShader = static_cast<Shader*>(m_rm.GetResource(shader, ResourceType::Shader));
-	pShader->SetValue(location, value);
+	Shader* pShader = static_cast<Shader*>(m_rm.GetResource(shader, ResourceType::Shader));
+
+	// The render thread sets the value before the next frame, the shader may be in use
+	if (m_pRenderThread)
+	{
+		m_pRenderThread->SetShaderValue(pShader, location, value);
+	}
+	else
+	{
+		ApplyShader shaderApplied(pShader);
+		shaderApplied->SetValue(location, value);
+	}
+
+	m_frameElision.Invalidate();
 }
 
 void oglRenderer::SetShaderValue(const std::string& shader, const string& location, const glm::vec2& value)
 {
-	ApplyShader pShader = static_cast<Shader*>(m_rm.GetResource(shader, ResourceType::Shader));
-	pShader->SetValue(location, value);
+	Shader* pShader = static_cast<Shader*>(m_rm.GetResource(shader, ResourceType::Shader));
+
+	// The render thread sets the value before the next frame, the shader may be in use
+	if (m_pRenderThread)
+	{
+		m_pRenderThread->SetShaderValue(pShader, location, value);
+	}
+	else
+	{
+		ApplyShader shaderApplied(pShader);
+		shaderApplied->SetValue(location, value);
+	}
+
+	m_frameElision.Invalidate();
 }
 
 void oglRenderer::EnableVSync(bool enable)
 {
-	glfwSwapInterval(enable);
+	// The swap interval belongs to the context of the window
+	if (m_pRenderThread)
+	{
+		m_pRenderThread->SetSwapInterval(enable);
+	}
+	else
+	{
+		glfwSwapInterval(enable);
+	}
+
 	m_bVSync = enable;
 }
 
@@ -314,14 +593,271 @@ bool oglRenderer::IsIconified() const
 	return m_bIconify;
 }
 
+void oglRenderer::SetResolutionBudget(double fBudget)
+{
+	m_dynamicResolution.SetBudget(fBudget);
+}
+
+void oglRenderer::EnableRenderThread(bool bEnable)
+{
+	if (bEnable && !m_pRenderThread)
+	{
+		// Frames rendered by this thread are discarded
+		m_pWorldSpaceSprites->Clear();
+		m_pScreenSpaceSprites->Clear();
+
+		// The render thread limits the frames in flight with its own fences
+		for (GLsync fence : m_frameFences)
+		{
+			glDeleteSync(fence);
+		}
+
+		m_frameFences.clear();
+
+		m_pRenderThread.reset(new RenderThread(m_pWindow, &m_rm));
+		m_pRenderThread->SetSwapInterval(m_bVSync);
+	}
+	else if (!bEnable && m_pRenderThread)
+	{
+		m_pRenderThread.reset();
+
+		// The context of the window is current on this thread again
+		glfwSwapInterval(m_bVSync);
+		UpdateCamera();
+	}
+}
+
+void oglRenderer::EnableFrameElision(bool bEnable)
+{
+	m_frameElision.Enable(bEnable);
+}
+
+void oglRenderer::SetMaxFramesInFlight(unsigned int frames)
+{
+	m_uiMaxFramesInFlight = frames;
+
+	if (frames == 0)
+	{
+		for (GLsync fence : m_frameFences)
+		{
+			glDeleteSync(fence);
+		}
+
+		m_frameFences.clear();
+	}
+}
+
+unsigned int oglRenderer::GetMaxFramesInFlight() const
+{
+	return m_uiMaxFramesInFlight;
+}
+
+void oglRenderer::WaitForFrames()
+{
+	if (m_pRenderThread)
+	{
+		m_pRenderThread->WaitForFrames(m_uiMaxFramesInFlight);
+		return;
+	}
+
+	while (!m_frameFences.empty())
+	{
+		GLsync fence = m_frameFences.front();
+
+		// Only block if the next frame would go over the limit, else just drop the frames that are done
+		GLuint64 timeout = (m_frameFences.size() >= m_uiMaxFramesInFlight) ? 100000000 : 0; // 100ms
+		GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+
+		if ((result == GL_TIMEOUT_EXPIRED) && (timeout == 0))
+			break;
+
+		// A timeout while blocking is treated as complete so that a lost fence cannot hang the game
+		glDeleteSync(fence);
+		m_frameFences.pop_front();
+	}
+}
+
 void oglRenderer::Present()
 {
-	glClear(m_iClearBits);
+	Timer timer;
+	timer.Start();
+
+	int width, height;
+	GetDisplayMode(&width, &height);
+
+	FrameElision::Redraw redraw = FrameElision::Redraw::All;
+	FrameElision::Region region = { 0, 0, width, height };
+
+	if (m_frameElision.IsEnabled())
+	{
+		if (m_pWorldCamera != nullptr)
+		{
+			uint64_t camera = FrameElision::HASH_SEED;
+			FrameElision::Hash(camera, m_pWorldCamera->ViewProj());
+			m_frameElision.AddState(camera);
+		}
+
+		redraw = m_frameElision.EndFrame(width, height, region);
+	}
+
+	RenderStats rendered = RenderStats();
+
+	if (redraw == FrameElision::Redraw::None)
+	{
+		// Nothing changed, the frame that is already on screen is kept
+		if (m_pRenderThread)
+		{
+			m_pRenderThread->Clear();
+		}
+		else
+		{
+			m_pWorldSpaceSprites->Clear();
+			m_pScreenSpaceSprites->Clear();
+		}
+	}
+	else if (m_pRenderThread)
+	{
+		// The frame gets rendered and presented by the render thread, the counters are those of a frame it rendered since the last call
+		m_pRenderThread->Present(m_pWorldCamera, m_OrthoCamera, m_clearColor, m_iClearBits, width, height, rendered);
+	}
+	else
+	{
+		// Frames are rendered into the cache when frame elision is enabled, so that the next frame can redraw only a part of it
+		// The world space pass of dynamic resolution is upscaled straight into the window, so it always redraws everything
+		bool bCached = m_frameElision.IsEnabled() && !m_dynamicResolution.IsEnabled() && (width > 0) && (height > 0);
+
+		if (bCached)
+		{
+			m_frameElision.BeginCached(width, height, m_iClearBits, region);
+		}
+		else
+		{
+			glClear(m_iClearBits);
+		}
+
+		if (m_dynamicResolution.IsEnabled() && (width > 0) && (height > 0))
+		{
+			m_dynamicResolution.Begin(width, height, m_iClearBits);
+			m_pWorldSpaceSprites->Render();
+			m_dynamicResolution.End();
+		}
+		else
+		{
+			m_pWorldSpaceSprites->Render();
+		}
 
-	m_pWorldSpaceSprites->Render();
-	m_pScreenSpaceSprites->Render();
+		m_pScreenSpaceSprites->Render();
 
-	glfwSwapBuffers(m_pWindow);
+		if (bCached)
+		{
+			m_frameElision.EndCached();
+		}
+
+		glfwSwapBuffers(m_pWindow);
+
+		if (m_uiMaxFramesInFlight > 0)
+		{
+			m_frameFences.push_back(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+		}
+	}
+
+	// The render thread evicts resources when the frame is handed over, see RenderThread::Present()
+	if (!m_pRenderThread)
+	{
+		m_rm.EnforceBudget();
+	}
+
+	// Objects released this frame are deleted once the GPU is done with them
+	DeletionQueue::Instance().EndFrame();
+
+	RenderStats stats = RenderCounters::Instance().Flush();
+
+	// The render thread counts the work it submits, only the objects culled are counted by this thread
+	if (m_pRenderThread)
+	{
+		rendered.culled = stats.culled;
+		stats = rendered;
+	}
+
+	stats.presentTime = timer.GetTime();
+	bool bDynamicResolution = m_dynamicResolution.IsEnabled() && !m_pRenderThread;
+	stats.worldGpuTime = bDynamicResolution ? m_dynamicResolution.GetGPUTime() : 0.0;
+	stats.resolutionScale = bDynamicResolution ? m_dynamicResolution.GetScale() : 1.0f;
+	stats.redrawn = 1.0f;
+
+	if (redraw == FrameElision::Redraw::None)
+	{
+		stats.redrawn = 0.0f;
+	}
+	else if ((redraw == FrameElision::Redraw::Region) && (width > 0) && (height > 0))
+	{
+		stats.redrawn = (float)(region.x1 - region.x0) * (region.y1 - region.y0) / ((float)width * height);
+	}
+
+	m_uiStatsFrame = (m_uiStatsFrame + 1) % m_statsHistory.size();
+	m_statsHistory[m_uiStatsFrame] = stats;
+
+	if (m_pCapture && m_pCapture->Present(m_pWorldCamera))
+	{
+		m_pCapture.reset();
+		Log::Instance().Write("Render capture complete");
+	}
+}
+
+bool oglRenderer::BeginCapture(const std::string& file, unsigned int frames)
+{
+	assert(frames > 0);
+
+	m_pCapture.reset(new RenderCaptureWriter(file, frames));
+	if (!m_pCapture->IsOpen())
+	{
+		m_pCapture.reset();
+		return false;
+	}
+
+	// Commands are recorded in the render space that is currently active
+	m_pCapture->SetRenderSpace(m_renderSpace);
+
+	return true;
+}
+
+bool oglRenderer::IsCapturing() const
+{
+	return m_pCapture != nullptr;
+}
+
+const RenderStats& oglRenderer::GetStats(unsigned int frame) const
+{
+	assert(frame < m_statsHistory.size());
+	return m_statsHistory[(m_uiStatsFrame + m_statsHistory.size() - frame) % m_statsHistory.size()];
+}
+
+unsigned int oglRenderer::GetStatsHistorySize() const
+{
+	return (unsigned int)m_statsHistory.size();
+}
+
+void oglRenderer::AddCulled(unsigned int count)
+{
+	RenderCounters::Instance().Culled(count);
+}
+
+void oglRenderer::FramebufferSizeCallback(GLFWwindow* window, int width, int height)
+{
+	// The window manager may apply a new size after SetDisplayMode() has returned
+	if ((s_pThis != nullptr) && (width > 0) && (height > 0))
+	{
+		s_pThis->UpdateCamera();
+	}
+}
+
+void oglRenderer::RefreshCallback(GLFWwindow* window)
+{
+	// The contents of the window were damaged, ex: by another window, so the next frame cannot be skipped
+	if (s_pThis != nullptr)
+	{
+		s_pThis->m_frameElision.Invalidate();
+	}
 }
 
 void oglRenderer::MonitorCallback(GLFWmonitor* monitor, int state)
@@ -364,6 +900,8 @@ void oglRenderer::ConfigureGLFW()
 	glfwMakeContextCurrent(m_pWindow);
 	glfwSetMonitorCallback(MonitorCallback);
 	glfwSetWindowIconifyCallback(m_pWindow, IconifyCallback);
+	glfwSetFramebufferSizeCallback(m_pWindow, FramebufferSizeCallback);
+	glfwSetWindowRefreshCallback(m_pWindow, RefreshCallback);
 
 	// Get the OpenGL version that we have created
 	int major = glfwGetWindowAttrib(m_pWindow,GLFW_CONTEXT_VERSION_MAJOR);
@@ -549,9 +1087,12 @@ void oglRenderer::SaveDisplayList()
 void oglRenderer::BuildRenderers()
 {
 	m_mesh.reset(new Mesh());
+	m_particleBuffer.reset(new ParticleBuffer());
+	m_spriteBuffer.reset(new SpriteBuffer());
+	m_sprite2DBuffer.reset(new Sprite2DBuffer());
 
-	m_pWorldSpaceSprites.reset(new AbstractRenderer(&m_rm, m_mesh));
-	m_pScreenSpaceSprites.reset(new AbstractRenderer(&m_rm, m_mesh, &m_OrthoCamera));
+	m_pWorldSpaceSprites.reset(new AbstractRenderer(&m_rm, m_mesh, m_particleBuffer, m_spriteBuffer, m_sprite2DBuffer));
+	m_pScreenSpaceSprites.reset(new AbstractRenderer(&m_rm, m_mesh, m_particleBuffer, m_spriteBuffer, m_sprite2DBuffer, &m_OrthoCamera));
 }
 
 void oglRenderer::BuildCamera()
@@ -564,6 +1105,73 @@ void oglRenderer::BuildCamera()
 	m_OrthoCamera.Update();
 }
 
+AbstractRenderer& oglRenderer::GetSpaceRenderer()
+{
+	if (m_pRenderThread)
+	{
+		return (m_renderSpace == World) ? m_pRenderThread->GetWorldRenderer() : m_pRenderThread->GetScreenRenderer();
+	}
+
+	return (m_renderSpace == World) ? *m_pWorldSpaceSprites : *m_pScreenSpaceSprites;
+}
+
+uint64_t oglRenderer::HashCommand(RenderCommand command) const
+{
+	uint64_t hash = FrameElision::HASH_SEED;
+	FrameElision::Hash(hash, command);
+	FrameElision::Hash(hash, m_renderSpace);
+
+	return hash;
+}
+
+void oglRenderer::AddCommand(uint64_t hash, const glm::vec3* pPoints, unsigned int count, const glm::mat4& T, float padding)
+{
+	// Only screen space commands are bounded, world space objects may be hidden by depth or be partially behind the camera
+	FrameElision::Region bounds;
+	bool bBounded = false;
+
+	if ((pPoints != nullptr) && (m_renderSpace == Screen))
+	{
+		int width, height;
+		GetDisplayMode(&width, &height);
+
+		bBounded = FrameElision::Project(pPoints, count, T, m_OrthoCamera.ViewProj(), width, height, padding, bounds);
+	}
+
+	m_frameElision.AddCommand(hash, bBounded ? &bounds : nullptr);
+}
+
+void oglRenderer::ApplyDisplayMode()
+{
+	const GLFWvidmode* pVideoMode = GetDisplayMode();
+	assert(pVideoMode != nullptr);
+
+	GLFWmonitor* pMonitor = m_pMonitors[m_iCurrentMonitor];
+
+	// The window is changed in place, so the context and every GPU resource survive the mode change
+	if (m_bFullscreen)
+	{
+		glfwSetWindowMonitor(m_pWindow, pMonitor, 0, 0, pVideoMode->width, pVideoMode->height, pVideoMode->refreshRate);
+	}
+	else
+	{
+		// Center the window on the monitor
+		int x = 0, y = 0;
+		glfwGetMonitorPos(pMonitor, &x, &y);
+
+		const GLFWvidmode* pDesktop = glfwGetVideoMode(pMonitor);
+		x += (pDesktop->width - pVideoMode->width) / 2;
+		y += (pDesktop->height - pVideoMode->height) / 2;
+
+		glfwSetWindowMonitor(m_pWindow, nullptr, x, y, pVideoMode->width, pVideoMode->height, GLFW_DONT_CARE);
+	}
+
+	// Some platforms reset the swap interval when the window changes monitor
+	EnableVSync(m_bVSync);
+	UpdateCamera();
+	SaveDisplayList();
+}
+
 void oglRenderer::UpdateCamera()
 {
 	int width, height;
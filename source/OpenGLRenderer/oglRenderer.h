@@ -9,7 +9,13 @@
 #include "VertexBuffer.h"
 
 #include "Camera.h"
+#include "RenderCapture.h"
+#include "DynamicResolution.h"
+#include "FrameElision.h"
+#include "RenderThread.h"
 #include <memory>
+#include <array>
+#include <deque>
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
@@ -69,6 +75,49 @@ public:
 							const std::string& tech = "sprite"
 							) override;
 
+	// DrawSprites() caches an array of sprites to be drawn by Present() with a single draw call
+	// Note: if pArray is NULL, then DrawSprites() terminates
+	void DrawSprites(const std::string& texture, // texture used to draw each sprite
+					 const SpriteInstance* pArray, // array of sprites to draw
+					 unsigned int length, // number of sprites
+					 const std::string& tech = "spriteBatch"
+					 ) override;
+
+	// DrawSprites() caches an array of compact 2D sprites to be drawn by Present() with a single draw call
+	// Note: if pArray is NULL, then DrawSprites() terminates
+	void DrawSprites(const std::string& texture, // texture used to draw each sprite
+					 const Sprite2D* pArray, // array of sprites to draw
+					 unsigned int length, // number of sprites
+					 const std::string& tech = "sprite2D"
+					 ) override;
+
+	// DrawParticles() caches a stream of particles to be drawn by Present() with a single draw call
+	// Note: if pArray is NULL, then DrawParticles() terminates
+	void DrawParticles(const std::string& texture, // texture used to draw each particle
+					   const ParticleVertex* pArray, // array of particles to draw
+					   unsigned int length, // number of particles
+					   const std::string& tech = "particle"
+					   ) override;
+
+	// DrawMesh() caches a static mesh to be drawn by Present()
+	void DrawMesh(const std::string& mesh, // mesh resource to draw
+				  const std::string& texture, // texture applied to the mesh
+				  const glm::mat4& transformation, // transformation applied to the mesh
+				  const glm::vec4& color = glm::vec4(1.0f), // color that gets blended together with the mesh
+				  const std::string& tech = "sprite"
+				  ) override;
+
+	// Static sprite batches stay on the GPU between frames, they are only uploaded again when they are updated
+	int CreateSpriteBatch() override;
+	void DestroySpriteBatch(int batch) override;
+	void UpdateSpriteBatch(int batch, const SpriteInstance* pArray, unsigned int length) override;
+
+	// DrawSpriteBatch() caches a static batch to be drawn by Present() with a single draw call
+	void DrawSpriteBatch(int batch, // batch created by CreateSpriteBatch()
+						 const std::string& texture, // texture used to draw each sprite
+						 const std::string& tech = "spriteBatch"
+						 ) override;
+
 	// Manage cursor creation
 	// Todo: move this code into the input plugin
 	int CreateCursor(const std::string& texture, int xhot, int yhot) override;
@@ -78,6 +127,21 @@ public:
 	// Returns the resource manager
 	IResourceManager& GetResourceManager() override;
 
+	// Returns the statistics of a previously rendered frame, 0 being the last frame presented
+	const RenderStats& GetStats(unsigned int frame = 0) const override;
+
+	// Returns the number of frames kept in the statistics history
+	unsigned int GetStatsHistorySize() const override;
+
+	// Adds objects culled by the caller to the statistics of the current frame
+	void AddCulled(unsigned int count) override;
+
+	// Records every command submitted during the next frames into a render capture, returns false if the file cannot be created
+	bool BeginCapture(const std::string& file, unsigned int frames) override;
+
+	// Returns true while a render capture is being recorded
+	bool IsCapturing() const override;
+
 	// todo: add the ability to specify which component is being read
 	// Returns depth value in the buffer at a single point in screen space
 	float ReadPixels(const glm::ivec2& pos) const override;
@@ -116,6 +180,12 @@ public:
 	// Sets the display mode
 	void SetDisplayMode(int mode) override;
 
+	// Switches between fullscreen and windowed mode on the current monitor
+	void SetFullscreen(bool bFullscreen) override;
+
+	// Returns true if the window is fullscreen
+	bool IsFullscreen() const override;
+
 	// Sets the coordinate system to render all objects in(screen space or world space)
 	void SetRenderSpace(RenderSpace) override;
 
@@ -130,11 +200,29 @@ public:
 	// Returns true if the window is iconified
 	bool IsIconified() const override;
 
+	// Renders the world space pass at a reduced resolution when its GPU time goes over fBudget seconds, 0 disables dynamic resolution
+	void SetResolutionBudget(double fBudget) override;
+
+	// Renders frames on a separate thread while the next frame is being recorded
+	void EnableRenderThread(bool bEnable) override;
+
+	// Skips presenting frames identical to the last one and only redraws the areas of the screen that changed
+	void EnableFrameElision(bool bEnable) override;
+
+	// Sets the maximum number of frames that may be queued on the GPU, 0 disables the limit
+	void SetMaxFramesInFlight(unsigned int frames) override;
+	unsigned int GetMaxFramesInFlight() const override;
+
+	// Blocks until another frame can be queued without going over the frames in flight limit
+	void WaitForFrames() override;
+
 	// Render everything that has been cached so far to the back buffer and then swap the back buffer with the front buffer
 	void Present() override;
 
 	static void MonitorCallback(GLFWmonitor*, int);
 	static void IconifyCallback(GLFWwindow*, int);
+	static void FramebufferSizeCallback(GLFWwindow*, int, int);
+	static void RefreshCallback(GLFWwindow*);
 
 private:
 
@@ -163,10 +251,38 @@ private:
 	bool m_bIconify = false;
 	bool m_bFirstRun = true;
 	GLuint m_iClearBits;
+	glm::vec3 m_clearColor;
 
 	std::shared_ptr<Mesh> m_mesh;
+	std::shared_ptr<ParticleBuffer> m_particleBuffer;
+	std::shared_ptr<SpriteBuffer> m_spriteBuffer;
+	std::shared_ptr<Sprite2DBuffer> m_sprite2DBuffer;
 	std::map<int, GLFWcursor*> m_cursors;
 
+	// Static sprite batches, a batch is shared with the frames that draw it so it can be destroyed while they are in flight
+	std::map<int, std::shared_ptr<StaticSpriteBatch>> m_spriteBatches;
+	int m_iNextSpriteBatch;
+
+	// Statistics of the last frames, m_uiStatsFrame is the last frame presented
+	std::array<RenderStats, 120> m_statsHistory;
+	unsigned int m_uiStatsFrame;
+
+	// Offscreen target of the world space pass when dynamic resolution is enabled
+	DynamicResolution m_dynamicResolution;
+
+	// Renders the frames when the render thread is enabled, null otherwise
+	std::unique_ptr<RenderThread> m_pRenderThread;
+
+	// Commands of the last frame, used to skip or partially redraw frames that did not change
+	FrameElision m_frameElision;
+
+	// Fences inserted after each frame still queued on the GPU, oldest first
+	std::deque<GLsync> m_frameFences;
+	unsigned int m_uiMaxFramesInFlight;
+
+	// Render capture being recorded, null if there is none
+	std::unique_ptr<RenderCaptureWriter> m_pCapture;
+
 	static oglRenderer* s_pThis;
 	static const std::string s_videoModeFile;
 
@@ -180,6 +296,19 @@ private:
 	void BuildCamera();
 	void UpdateCamera();
 
+	// Returns the renderer recording the commands of the current render space
+	AbstractRenderer& GetSpaceRenderer();
+
+	// Starts the hash of a command submitted in the current render space
+	uint64_t HashCommand(RenderCommand command) const;
+
+	// Records a command for frame elision, its bounds are computed from the points transformed by T
+	// pPoints may be null if the bounds are unknown
+	void AddCommand(uint64_t hash, const glm::vec3* pPoints, unsigned int count, const glm::mat4& T, float padding);
+
+	// Applies the current display mode and fullscreen state to the existing window
+	void ApplyDisplayMode();
+
 	oglRenderer(const oglRenderer&) = delete;
 	oglRenderer& operator = (const oglRenderer&) = delete;
 };
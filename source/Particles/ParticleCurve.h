@@ -0,0 +1,71 @@
+#ifndef _PARTICLECURVE_
+#define _PARTICLECURVE_
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+// Defines a piecewise linear curve over the normalized lifetime of a particle [0, 1]
+// The curve is baked into a lookup table by the emitter so that it is never evaluated per particle
+template< class T >
+class ParticleCurve
+{
+public:
+
+	// Builds a constant curve
+	explicit ParticleCurve(const T& value)
+	{
+		AddKey(0.0f, value);
+	}
+
+	// Builds a curve that linearly moves from start to end
+	ParticleCurve(const T& start, const T& end)
+	{
+		AddKey(0.0f, start);
+		AddKey(1.0f, end);
+	}
+
+	// Adds a key to the curve, t is clamped into [0, 1]
+	void AddKey(float t, const T& value)
+	{
+		t = std::min(std::max(t, 0.0f), 1.0f);
+
+		auto iter = m_keys.begin();
+		while ((iter != m_keys.end()) && (iter->first <= t))
+		{
+			++iter;
+		}
+
+		m_keys.insert(iter, std::make_pair(t, value));
+	}
+
+	// Returns the value of the curve at t
+	T Sample(float t) const
+	{
+		if (t <= m_keys.front().first)
+			return m_keys.front().second;
+
+		for (unsigned int i = 1; i < m_keys.size(); ++i)
+		{
+			if (t <= m_keys[i].first)
+			{
+				const std::pair<float, T>& a = m_keys[i - 1];
+				const std::pair<float, T>& b = m_keys[i];
+
+				float range = b.first - a.first;
+				float s = (range > 0.0f) ? ((t - a.first) / range) : 1.0f;
+
+				return a.second + (b.second - a.second) * s;
+			}
+		}
+
+		return m_keys.back().second;
+	}
+
+private:
+
+	// sorted list of (t, value) pairs
+	std::vector<std::pair<float, T>> m_keys;
+};
+
+#endif // _PARTICLECURVE_
@@ -0,0 +1,251 @@
+#include "ParticleEmitter.h"
+#include "RandomGenerator.h"
+
+#include <cassert>
+#include <algorithm>
+#include <limits>
+#include <glm/common.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PARTICLES_SSE
+#include <emmintrin.h>
+#else
+#include <cstdlib>
+#endif
+
+namespace
+{
+	float* AllocateArray(unsigned int length)
+	{
+#ifdef PARTICLES_SSE
+		return static_cast<float*>(_mm_malloc(length * sizeof(float), 16));
+#else
+		return static_cast<float*>(malloc(length * sizeof(float)));
+#endif
+	}
+
+	void FreeArray(float* pArray)
+	{
+#ifdef PARTICLES_SSE
+		_mm_free(pArray);
+#else
+		free(pArray);
+#endif
+	}
+}
+
+ParticleEmitterDesc::ParticleEmitterDesc() : pos(0.0f), spawnArea(0.0f), velocityMin(-1.0f), velocityMax(1.0f), acceleration(0.0f),
+lifetimeMin(1.0f), lifetimeMax(1.0f), spawnRate(100.0f), maxParticles(1000), color(glm::vec4(1.0f)), size(1.0f), texture("blank"), tech("particle")
+{
+}
+
+ParticleEmitter::ParticleEmitter(const ParticleEmitterDesc& desc) : m_desc(desc), m_uiCount(0),
+m_fSpawnAccumulator(0.0f), m_bSpawning(true)
+{
+	// Round up to a multiple of 4 so that the SSE loops never need to check the tail of the arrays
+	m_uiCapacity = (desc.maxParticles + 3) & ~3u;
+
+	m_pPosX = AllocateArray(m_uiCapacity);
+	m_pPosY = AllocateArray(m_uiCapacity);
+	m_pVelX = AllocateArray(m_uiCapacity);
+	m_pVelY = AllocateArray(m_uiCapacity);
+	m_pAge = AllocateArray(m_uiCapacity);
+	m_pInvLifetime = AllocateArray(m_uiCapacity);
+
+	m_uiRandom = (unsigned int)RandomGenerator::Instance().Generate(1, std::numeric_limits<int>::max());
+
+	BakeCurves();
+}
+
+ParticleEmitter::~ParticleEmitter()
+{
+	FreeArray(m_pPosX);
+	FreeArray(m_pPosY);
+	FreeArray(m_pVelX);
+	FreeArray(m_pVelY);
+	FreeArray(m_pAge);
+	FreeArray(m_pInvLifetime);
+}
+
+void ParticleEmitter::Spawn(float dt)
+{
+	if (!m_bSpawning)
+		return;
+
+	m_fSpawnAccumulator += m_desc.spawnRate * dt;
+
+	unsigned int uiSpawnCount = (unsigned int)m_fSpawnAccumulator;
+	m_fSpawnAccumulator -= uiSpawnCount;
+
+	uiSpawnCount = std::min(uiSpawnCount, m_desc.maxParticles - m_uiCount);
+
+	for (unsigned int i = m_uiCount; i < (m_uiCount + uiSpawnCount); ++i)
+	{
+		m_pPosX[i] = m_desc.pos.x + Random(-m_desc.spawnArea.x, m_desc.spawnArea.x);
+		m_pPosY[i] = m_desc.pos.y + Random(-m_desc.spawnArea.y, m_desc.spawnArea.y);
+		m_pVelX[i] = Random(m_desc.velocityMin.x, m_desc.velocityMax.x);
+		m_pVelY[i] = Random(m_desc.velocityMin.y, m_desc.velocityMax.y);
+		m_pAge[i] = 0.0f;
+		m_pInvLifetime[i] = 1.0f / glm::max(Random(m_desc.lifetimeMin, m_desc.lifetimeMax), 0.0001f);
+	}
+
+	m_uiCount += uiSpawnCount;
+}
+
+void ParticleEmitter::Integrate(unsigned int begin, unsigned int end, float dt)
+{
+	assert(end <= m_uiCount);
+
+	const float ax = m_desc.acceleration.x * dt;
+	const float ay = m_desc.acceleration.y * dt;
+
+	unsigned int i = begin;
+
+#ifdef PARTICLES_SSE
+	// Process the unaligned head of the range one particle at a time
+	for (; (i < end) && ((i & 3) != 0); ++i)
+	{
+		m_pVelX[i] += ax;
+		m_pVelY[i] += ay;
+		m_pPosX[i] += m_pVelX[i] * dt;
+		m_pPosY[i] += m_pVelY[i] * dt;
+		m_pAge[i] += m_pInvLifetime[i] * dt;
+	}
+
+	const __m128 vdt = _mm_set1_ps(dt);
+	const __m128 vax = _mm_set1_ps(ax);
+	const __m128 vay = _mm_set1_ps(ay);
+
+	for (; (i + 4) <= end; i += 4)
+	{
+		__m128 vx = _mm_add_ps(_mm_load_ps(m_pVelX + i), vax);
+		__m128 vy = _mm_add_ps(_mm_load_ps(m_pVelY + i), vay);
+
+		_mm_store_ps(m_pVelX + i, vx);
+		_mm_store_ps(m_pVelY + i, vy);
+
+		_mm_store_ps(m_pPosX + i, _mm_add_ps(_mm_load_ps(m_pPosX + i), _mm_mul_ps(vx, vdt)));
+		_mm_store_ps(m_pPosY + i, _mm_add_ps(_mm_load_ps(m_pPosY + i), _mm_mul_ps(vy, vdt)));
+
+		__m128 age = _mm_load_ps(m_pAge + i);
+		__m128 invLifetime = _mm_load_ps(m_pInvLifetime + i);
+		_mm_store_ps(m_pAge + i, _mm_add_ps(age, _mm_mul_ps(invLifetime, vdt)));
+	}
+#endif
+
+	for (; i < end; ++i)
+	{
+		m_pVelX[i] += ax;
+		m_pVelY[i] += ay;
+		m_pPosX[i] += m_pVelX[i] * dt;
+		m_pPosY[i] += m_pVelY[i] * dt;
+		m_pAge[i] += m_pInvLifetime[i] * dt;
+	}
+}
+
+void ParticleEmitter::Cull()
+{
+	unsigned int i = 0;
+
+#ifdef PARTICLES_SSE
+	const __m128 one = _mm_set1_ps(1.0f);
+#endif
+
+	while (i < m_uiCount)
+	{
+#ifdef PARTICLES_SSE
+		// Skip over groups of 4 particles that are all still alive
+		if ((i + 4) <= m_uiCount)
+		{
+			__m128 dead = _mm_cmpge_ps(_mm_loadu_ps(m_pAge + i), one);
+			if (_mm_movemask_ps(dead) == 0)
+			{
+				i += 4;
+				continue;
+			}
+		}
+#endif
+
+		if (m_pAge[i] >= 1.0f)
+		{
+			// Replace the dead particle with the last particle, which then needs to be checked as well
+			Move(--m_uiCount, i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+}
+
+void ParticleEmitter::BuildVertices(ParticleVertex* pOut) const
+{
+	const float fTableScale = (float)(CURVE_RESOLUTION - 1);
+	const float z = m_desc.pos.z;
+
+	for (unsigned int i = 0; i < m_uiCount; ++i)
+	{
+		unsigned int uiIndex = (unsigned int)(glm::min(m_pAge[i], 1.0f) * fTableScale);
+
+		pOut[i].pos = glm::vec3(m_pPosX[i], m_pPosY[i], z);
+		pOut[i].size = m_sizeTable[uiIndex];
+		pOut[i].color = m_colorTable[uiIndex];
+	}
+}
+
+void ParticleEmitter::Clear()
+{
+	m_uiCount = 0;
+	m_fSpawnAccumulator = 0.0f;
+}
+
+void ParticleEmitter::SetPos(const glm::vec3& pos)
+{
+	m_desc.pos = pos;
+}
+
+void ParticleEmitter::EnableSpawning(bool bEnable)
+{
+	m_bSpawning = bEnable;
+}
+
+unsigned int ParticleEmitter::GetCount() const
+{
+	return m_uiCount;
+}
+
+const ParticleEmitterDesc& ParticleEmitter::GetDesc() const
+{
+	return m_desc;
+}
+
+float ParticleEmitter::Random(float min, float max)
+{
+	// xorshift32
+	m_uiRandom ^= m_uiRandom << 13;
+	m_uiRandom ^= m_uiRandom >> 17;
+	m_uiRandom ^= m_uiRandom << 5;
+
+	return min + (max - min) * ((m_uiRandom >> 8) * (1.0f / 16777216.0f));
+}
+
+void ParticleEmitter::Move(unsigned int from, unsigned int to)
+{
+	m_pPosX[to] = m_pPosX[from];
+	m_pPosY[to] = m_pPosY[from];
+	m_pVelX[to] = m_pVelX[from];
+	m_pVelY[to] = m_pVelY[from];
+	m_pAge[to] = m_pAge[from];
+	m_pInvLifetime[to] = m_pInvLifetime[from];
+}
+
+void ParticleEmitter::BakeCurves()
+{
+	for (unsigned int i = 0; i < CURVE_RESOLUTION; ++i)
+	{
+		float t = i / (float)(CURVE_RESOLUTION - 1);
+
+		m_colorTable[i] = PackRGBA8(m_desc.color.Sample(t));
+		m_sizeTable[i] = m_desc.size.Sample(t);
+	}
+}
@@ -0,0 +1,125 @@
+#ifndef _PARTICLEEMITTER_
+#define _PARTICLEEMITTER_
+
+#include "ParticleCurve.h"
+#include "IRenderer.h"
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <string>
+
+// Describes how an emitter spawns and animates its particles
+struct ParticleEmitterDesc
+{
+	ParticleEmitterDesc();
+
+	// Center of the emitter
+	glm::vec3 pos;
+
+	// Particles are spawned uniformly within [pos - spawnArea, pos + spawnArea]
+	glm::vec2 spawnArea;
+
+	// Initial velocity range in units per second
+	glm::vec2 velocityMin;
+	glm::vec2 velocityMax;
+
+	// Constant acceleration applied to every particle, ex: gravity
+	glm::vec2 acceleration;
+
+	// Lifetime range in seconds
+	float lifetimeMin;
+	float lifetimeMax;
+
+	// Number of particles spawned per second
+	float spawnRate;
+
+	// Maximum number of particles alive at once
+	unsigned int maxParticles;
+
+	// Color and size over the normalized lifetime of a particle
+	ParticleCurve<glm::vec4> color;
+	ParticleCurve<float> size;
+
+	// Texture and technique used to render the particles
+	std::string texture;
+	std::string tech;
+};
+
+// Stores the particles of a single emitter as a structure of arrays
+// Each array is 16 byte aligned and padded to a multiple of 4 so that it can be processed with SSE
+class ParticleEmitter
+{
+public:
+
+	// Number of entries in the baked color and size lookup tables
+	static const unsigned int CURVE_RESOLUTION = 64;
+
+	ParticleEmitter(const ParticleEmitterDesc& desc);
+	~ParticleEmitter();
+
+	// Spawns new particles based on the spawn rate
+	void Spawn(float dt);
+
+	// Integrates velocity and position, and ages the particles in [begin, end)
+	// Ranges that do not overlap may be integrated concurrently
+	void Integrate(unsigned int begin, unsigned int end, float dt);
+
+	// Removes all particles that have reached the end of their lifetime
+	void Cull();
+
+	// Writes the render data of every alive particle into pOut
+	// pOut must be able to hold GetCount() vertices
+	void BuildVertices(ParticleVertex* pOut) const;
+
+	// Removes all particles
+	void Clear();
+
+	// Moves the emitter, only newly spawned particles are affected
+	void SetPos(const glm::vec3& pos);
+
+	// Enables or disables spawning of new particles
+	void EnableSpawning(bool bEnable);
+
+	// Returns the number of alive particles
+	unsigned int GetCount() const;
+
+	const ParticleEmitterDesc& GetDesc() const;
+
+private:
+
+	ParticleEmitterDesc m_desc;
+
+	// Particle data
+	float* m_pPosX;
+	float* m_pPosY;
+	float* m_pVelX;
+	float* m_pVelY;
+	float* m_pAge; // normalized age [0, 1]
+	float* m_pInvLifetime; // 1 / lifetime in seconds
+
+	unsigned int m_uiCount;
+	unsigned int m_uiCapacity;
+
+	float m_fSpawnAccumulator;
+	bool m_bSpawning;
+
+	// xorshift state used to randomize spawned particles
+	unsigned int m_uiRandom;
+
+	// Baked curves
+	unsigned int m_colorTable[CURVE_RESOLUTION];
+	float m_sizeTable[CURVE_RESOLUTION];
+
+	// Returns a random float in [min, max]
+	float Random(float min, float max);
+
+	// Moves particle from into slot to
+	void Move(unsigned int from, unsigned int to);
+
+	void BakeCurves();
+
+	ParticleEmitter(const ParticleEmitter&) = delete;
+	ParticleEmitter& operator =(const ParticleEmitter&) = delete;
+};
+
+#endif // _PARTICLEEMITTER_
@@ -0,0 +1,106 @@
+#include "ParticleSystem.h"
+
+#include <cassert>
+#include <algorithm>
+
+ParticleSystem::ParticleSystem()
+{
+}
+
+ParticleSystem::HANDLE ParticleSystem::CreateEmitter(const ParticleEmitterDesc& desc)
+{
+	// Reuse the slot of a destroyed emitter if there is one
+	auto iter = std::find(m_emitters.begin(), m_emitters.end(), nullptr);
+	if (iter != m_emitters.end())
+	{
+		iter->reset(new ParticleEmitter(desc));
+		return (HANDLE)(iter - m_emitters.begin());
+	}
+
+	m_emitters.emplace_back(new ParticleEmitter(desc));
+	return (HANDLE)(m_emitters.size() - 1);
+}
+
+void ParticleSystem::DestroyEmitter(HANDLE emitter)
+{
+	if (emitter < m_emitters.size())
+	{
+		m_emitters[emitter].reset();
+	}
+}
+
+ParticleEmitter& ParticleSystem::GetEmitter(HANDLE emitter)
+{
+	assert(emitter < m_emitters.size() && m_emitters[emitter] != nullptr);
+	return *m_emitters[emitter];
+}
+
+const ParticleEmitter& ParticleSystem::GetEmitter(HANDLE emitter) const
+{
+	assert(emitter < m_emitters.size() && m_emitters[emitter] != nullptr);
+	return *m_emitters[emitter];
+}
+
+void ParticleSystem::SetParallelFor(const PARALLEL_FOR& parallelFor)
+{
+	m_parallelFor = parallelFor;
+}
+
+void ParticleSystem::Update(float dt)
+{
+	for (auto& iter : m_emitters)
+	{
+		if (iter == nullptr)
+			continue;
+
+		ParticleEmitter& emitter = *iter;
+		emitter.Spawn(dt);
+
+		unsigned int uiCount = emitter.GetCount();
+
+		if (m_parallelFor && (uiCount > BATCH_SIZE))
+		{
+			m_parallelFor(uiCount, BATCH_SIZE, [&emitter, dt](unsigned int begin, unsigned int end)
+			{
+				emitter.Integrate(begin, end, dt);
+			});
+		}
+		else
+		{
+			emitter.Integrate(0, uiCount, dt);
+		}
+
+		emitter.Cull();
+	}
+}
+
+void ParticleSystem::Render(IRenderer& renderer)
+{
+	for (auto& iter : m_emitters)
+	{
+		if ((iter == nullptr) || (iter->GetCount() == 0))
+			continue;
+
+		const ParticleEmitterDesc& desc = iter->GetDesc();
+
+		m_vertices.resize(iter->GetCount());
+		iter->BuildVertices(m_vertices.data());
+
+		renderer.DrawParticles(desc.texture, m_vertices.data(), (unsigned int)m_vertices.size(), desc.tech);
+	}
+}
+
+unsigned int ParticleSystem::GetCount() const
+{
+	unsigned int uiCount = 0;
+
+	for (auto& iter : m_emitters)
+	{
+		if (iter != nullptr)
+		{
+			uiCount += iter->GetCount();
+		}
+	}
+
+	return uiCount;
+}
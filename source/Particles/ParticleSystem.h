@@ -0,0 +1,56 @@
+#ifndef _PARTICLESYSTEM_
+#define _PARTICLESYSTEM_
+
+#include "ParticleEmitter.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Manages a set of particle emitters
+// Particles are updated in batches which can be distributed over multiple threads via SetParallelFor()
+class ParticleSystem
+{
+public:
+
+	typedef unsigned int HANDLE;
+
+	// Invokes body(begin, end) over [0, count) in batches, possibly concurrently, and returns once all batches are done
+	typedef std::function<void(unsigned int count, unsigned int batchSize, const std::function<void(unsigned int, unsigned int)>& body)> PARALLEL_FOR;
+
+	ParticleSystem();
+
+	// Creates a new emitter and returns a handle to it
+	HANDLE CreateEmitter(const ParticleEmitterDesc& desc);
+
+	// Destroys the emitter along with all of its particles
+	void DestroyEmitter(HANDLE emitter);
+
+	// Returns the emitter specified by the handle
+	ParticleEmitter& GetEmitter(HANDLE emitter);
+	const ParticleEmitter& GetEmitter(HANDLE emitter) const;
+
+	// Sets the function used to distribute the update of the particles
+	// If parallelFor is empty, particles are updated on the calling thread
+	void SetParallelFor(const PARALLEL_FOR& parallelFor);
+
+	// Spawns, integrates and culls the particles of every emitter
+	void Update(float dt);
+
+	// Streams the particles of every emitter to the renderer in the current render space
+	void Render(IRenderer& renderer);
+
+	// Returns the number of alive particles of all emitters
+	unsigned int GetCount() const;
+
+private:
+
+	// Number of particles updated by a single batch, must be a multiple of 4
+	static const unsigned int BATCH_SIZE = 16384;
+
+	std::vector<std::unique_ptr<ParticleEmitter>> m_emitters;
+	std::vector<ParticleVertex> m_vertices;
+
+	PARALLEL_FOR m_parallelFor;
+};
+
+#endif // _PARTICLESYSTEM_
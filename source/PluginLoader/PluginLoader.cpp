@@ -49,6 +49,20 @@ void PluginLoader::Destroy(Game& game)
 	game.EnableEventWaiting(false);
 }
 
+void PluginLoader::Suspend(Game& game)
+{
+	game.EnableEventWaiting(false);
+}
+
+void PluginLoader::Resume(Game& game)
+{
+	// Start over from the menu
+	m_buttonPressed.clear();
+	m_pProgressBar.reset();
+
+	game.EnableEventWaiting(true);
+}
+
 void PluginLoader::Update(Game& game)
 {
 	IInput& input = game.GetInput();
@@ -60,7 +74,23 @@ void PluginLoader::Update(Game& game)
 	}
 	else if (!m_buttonPressed.empty())
 	{
-		game.SetNextState(m_buttonPressed);
+		if (m_pProgressBar == nullptr)
+		{
+			// The menu keeps running while the plugin loads, the state changes once the preload completes
+			game.PreloadState(m_buttonPressed);
+			game.SetNextState(m_buttonPressed);
+
+			int width, height;
+			game.GetRenderer().GetDisplayMode(&width, &height);
+
+			m_pProgressBar.reset(new UI::ProgressBar(glm::vec2(width / 4.0f, height / 12.0f), glm::vec2(3.0f * width / 4.0f, height / 12.0f), []{}));
+			m_pProgressBar->SetRenderSpace(Screen);
+
+			// Events may not come while loading, the bar must still be redrawn
+			game.EnableEventWaiting(false);
+		}
+
+		m_pProgressBar->SetProgress(game.GetPreloadProgress());
 	}
 }
 
@@ -75,6 +105,11 @@ void PluginLoader::Draw(Game& game)
 						glm::vec4(1.0f), 50.0f, nullptr, FontAlignment::Center);
 
 	m_gui.Render(renderer);
+
+	if (m_pProgressBar != nullptr)
+	{
+		m_pProgressBar->Render(renderer);
+	}
 }
 
 void PluginLoader::ButtonCallback(UI::Button& button)
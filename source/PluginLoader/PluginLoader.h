@@ -4,6 +4,8 @@
 #include "IGameState.h"
 #include "GUI.h"
 #include "Button.h"
+#include "ProgressBar.h"
+#include <memory>
 
 class PluginLoader : public IGameState
 {
@@ -30,6 +32,12 @@ public:
 	// Called only once when the plugin is destroyed
 	virtual void Destroy(class Game& game);
 
+	// Called when the game switches to another state while this state stays resident
+	virtual void Suspend(class Game& game);
+
+	// Called when the game switches back to this state while it is resident
+	virtual void Resume(class Game& game);
+
 	// Called every frame to update the state of the game
 	virtual void Update(class Game& game);
 
@@ -45,6 +53,9 @@ private:
 	UI::GUI m_gui;
 	UI::GUI::HANDLE m_rootNode;
 	std::string m_buttonPressed;
+
+	// Shown while the chosen plugin is preloaded
+	std::unique_ptr<UI::ProgressBar> m_pProgressBar;
 };
 
 #endif // _PLUGINLOADER_
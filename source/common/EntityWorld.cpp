@@ -0,0 +1,406 @@
+#include "EntityWorld.h"
+
+#include <cassert>
+#include <string>
+
+namespace
+{
+	// Size of a chunk, small enough to stay in the L1 or L2 cache while its entities are processed
+	const unsigned int CHUNK_BYTES = 16 * 1024;
+
+	// Component types of the process, shared by every world
+	// The infos never move once registered, so they are read without locking
+	struct ComponentRegistry
+	{
+		std::mutex mutex;
+		std::unordered_map<std::string, unsigned int> ids;
+		ComponentTypeInfo types[MAX_COMPONENT_TYPES];
+		unsigned int count;
+
+		ComponentRegistry() : count(0) {}
+	};
+
+	ComponentRegistry& GetRegistry()
+	{
+		static ComponentRegistry registry;
+		return registry;
+	}
+
+	// Adds a row for the entity at the end of the archetype, its components are not constructed
+	unsigned int AddRow(Archetype* pArchetype, Entity e)
+	{
+		unsigned int row = pArchetype->count;
+
+		if ((row / pArchetype->capacity) >= pArchetype->chunks.size())
+		{
+			unsigned int uiElements = (pArchetype->chunkBytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+			pArchetype->chunks.emplace_back(new std::max_align_t[uiElements]);
+		}
+
+		++pArchetype->count;
+		pArchetype->GetEntities(row / pArchetype->capacity)[row % pArchetype->capacity] = e;
+
+		return row;
+	}
+
+	unsigned int AlignUp(unsigned int value, unsigned int alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	// Returns the bytes needed by a chunk of uiCapacity entities, the offsets of the arrays are written to offsets
+	unsigned int GetChunkLayout(const std::vector<ComponentTypeInfo>& infos, unsigned int uiCapacity, std::vector<unsigned int>& offsets)
+	{
+		unsigned int bytes = uiCapacity * sizeof(Entity);
+
+		offsets.resize(infos.size());
+
+		for (unsigned int i = 0; i < infos.size(); ++i)
+		{
+			const ComponentTypeInfo& info = infos[i];
+
+			bytes = AlignUp(bytes, info.alignment);
+			offsets[i] = bytes;
+			bytes += uiCapacity * info.size;
+		}
+
+		return bytes;
+	}
+}
+
+unsigned int RegisterComponentType(const char* name, const ComponentTypeInfo& info)
+{
+	ComponentRegistry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+
+	auto iter = registry.ids.find(name);
+	if (iter != registry.ids.end())
+		return iter->second;
+
+	if (registry.count >= MAX_COMPONENT_TYPES)
+	{
+		throw std::string("Too many component types");
+	}
+
+	unsigned int id = registry.count++;
+	registry.types[id] = info;
+	registry.ids.insert({ name, id });
+
+	return id;
+}
+
+const ComponentTypeInfo& GetComponentTypeInfo(unsigned int id)
+{
+	assert(id < MAX_COMPONENT_TYPES);
+
+	return GetRegistry().types[id];
+}
+
+EntityWorld::EntityWorld() : m_uiNumEntities(0), m_iIterating(0)
+{
+}
+
+EntityWorld::~EntityWorld()
+{
+	Clear();
+}
+
+Entity EntityWorld::Create()
+{
+	assert(m_iIterating == 0);
+
+	return Allocate(GetArchetype(ComponentMask()));
+}
+
+void EntityWorld::Destroy(Entity e)
+{
+	assert(m_iIterating == 0);
+
+	if (!IsAlive(e))
+		return;
+
+	EntityRecord& record = m_records[e.index];
+	Archetype* pArchetype = record.pArchetype;
+
+	for (unsigned int i = 0; i < pArchetype->types.size(); ++i)
+	{
+		pArchetype->infos[i].destroy(GetRow(pArchetype, record.row, i));
+	}
+
+	FillRow(pArchetype, record.row);
+
+	record.pArchetype = nullptr;
+	++record.generation;
+	m_freeIndices.push_back(e.index);
+	--m_uiNumEntities;
+}
+
+void EntityWorld::DestroyDeferred(Entity e)
+{
+	std::lock_guard<std::mutex> lock(m_deferredMutex);
+	m_deferred.push_back(e);
+}
+
+void EntityWorld::Flush()
+{
+	std::vector<Entity> deferred;
+
+	{
+		std::lock_guard<std::mutex> lock(m_deferredMutex);
+		deferred.swap(m_deferred);
+	}
+
+	for (Entity e : deferred)
+	{
+		Destroy(e);
+	}
+}
+
+bool EntityWorld::IsAlive(Entity e) const
+{
+	return (e.index < m_records.size()) && (m_records[e.index].generation == e.generation) && (m_records[e.index].pArchetype != nullptr);
+}
+
+unsigned int EntityWorld::GetNumEntities() const
+{
+	return m_uiNumEntities;
+}
+
+void EntityWorld::Clear()
+{
+	assert(m_iIterating == 0);
+
+	for (auto& pArchetype : m_archetypes)
+	{
+		for (unsigned int row = 0; row < pArchetype->count; ++row)
+		{
+			for (unsigned int i = 0; i < pArchetype->types.size(); ++i)
+			{
+				pArchetype->infos[i].destroy(GetRow(pArchetype.get(), row, i));
+			}
+		}
+
+		pArchetype->count = 0;
+		pArchetype->chunks.clear();
+	}
+
+	// Handles of destroyed entities must stay invalid, so the generations are kept
+	m_freeIndices.clear();
+	for (unsigned int i = 0; i < m_records.size(); ++i)
+	{
+		if (m_records[i].pArchetype != nullptr)
+		{
+			m_records[i].pArchetype = nullptr;
+			++m_records[i].generation;
+		}
+
+		m_freeIndices.push_back(i);
+	}
+
+	m_uiNumEntities = 0;
+
+	std::lock_guard<std::mutex> lock(m_deferredMutex);
+	m_deferred.clear();
+}
+
+Archetype* EntityWorld::GetArchetype(const ComponentMask& mask)
+{
+	auto iter = m_archetypeMap.find(mask);
+	if (iter != m_archetypeMap.end())
+		return iter->second;
+
+	std::unique_ptr<Archetype> pArchetype(new Archetype());
+	pArchetype->mask = mask;
+	pArchetype->count = 0;
+	std::fill(pArchetype->columns, pArchetype->columns + MAX_COMPONENT_TYPES, -1);
+
+	for (unsigned int type = 0; type < MAX_COMPONENT_TYPES; ++type)
+	{
+		if (mask.test(type))
+		{
+			pArchetype->columns[type] = (int)pArchetype->types.size();
+			pArchetype->types.push_back(type);
+			pArchetype->infos.push_back(GetComponentTypeInfo(type));
+		}
+	}
+
+	// As many entities as fit in a chunk, a chunk is made bigger if not even one entity fits
+	unsigned int uiRowBytes = sizeof(Entity);
+	for (const ComponentTypeInfo& info : pArchetype->infos)
+	{
+		uiRowBytes += info.size;
+	}
+
+	unsigned int uiCapacity = std::max(CHUNK_BYTES / uiRowBytes, 1u);
+	unsigned int uiBytes = GetChunkLayout(pArchetype->infos, uiCapacity, pArchetype->offsets);
+
+	while ((uiBytes > CHUNK_BYTES) && (uiCapacity > 1))
+	{
+		uiBytes = GetChunkLayout(pArchetype->infos, --uiCapacity, pArchetype->offsets);
+	}
+
+	pArchetype->capacity = uiCapacity;
+	pArchetype->chunkBytes = uiBytes;
+
+	Archetype* pResult = pArchetype.get();
+	m_archetypes.push_back(std::move(pArchetype));
+	m_archetypeMap.insert({ mask, pResult });
+
+	return pResult;
+}
+
+Archetype* EntityWorld::GetAddEdge(Archetype* pArchetype, unsigned int type)
+{
+	auto iter = pArchetype->addEdges.find(type);
+	if (iter != pArchetype->addEdges.end())
+		return iter->second;
+
+	ComponentMask mask = pArchetype->mask;
+	mask.set(type);
+
+	Archetype* pTarget = GetArchetype(mask);
+	pArchetype->addEdges[type] = pTarget;
+	pTarget->removeEdges[type] = pArchetype;
+
+	return pTarget;
+}
+
+Archetype* EntityWorld::GetRemoveEdge(Archetype* pArchetype, unsigned int type)
+{
+	auto iter = pArchetype->removeEdges.find(type);
+	if (iter != pArchetype->removeEdges.end())
+		return iter->second;
+
+	ComponentMask mask = pArchetype->mask;
+	mask.reset(type);
+
+	Archetype* pTarget = GetArchetype(mask);
+	pArchetype->removeEdges[type] = pTarget;
+	pTarget->addEdges[type] = pArchetype;
+
+	return pTarget;
+}
+
+Entity EntityWorld::Allocate(Archetype* pArchetype)
+{
+	Entity e;
+
+	if (m_freeIndices.empty())
+	{
+		e.index = (uint32_t)m_records.size();
+		e.generation = 0;
+
+		EntityRecord record = { nullptr, 0, 0 };
+		m_records.push_back(record);
+	}
+	else
+	{
+		e.index = m_freeIndices.back();
+		e.generation = m_records[e.index].generation;
+		m_freeIndices.pop_back();
+	}
+
+	EntityRecord& record = m_records[e.index];
+	record.pArchetype = pArchetype;
+	record.row = AddRow(pArchetype, e);
+
+	++m_uiNumEntities;
+
+	return e;
+}
+
+void EntityWorld::MoveEntity(Entity e, Archetype* pTarget)
+{
+	assert(IsAlive(e));
+
+	EntityRecord& record = m_records[e.index];
+	Archetype* pSource = record.pArchetype;
+	unsigned int sourceRow = record.row;
+
+	if (pSource == pTarget)
+		return;
+
+	unsigned int targetRow = AddRow(pTarget, e);
+	record.pArchetype = pTarget;
+	record.row = targetRow;
+
+	for (unsigned int i = 0; i < pSource->types.size(); ++i)
+	{
+		unsigned int type = pSource->types[i];
+		const ComponentTypeInfo& info = pSource->infos[i];
+		void* pSrc = GetRow(pSource, sourceRow, i);
+
+		if (pTarget->columns[type] >= 0)
+		{
+			info.move(GetRow(pTarget, targetRow, pTarget->columns[type]), pSrc);
+		}
+		else
+		{
+			info.destroy(pSrc);
+		}
+	}
+
+	FillRow(pSource, sourceRow);
+}
+
+void* EntityWorld::GetComponent(Entity e, unsigned int type) const
+{
+	if (!IsAlive(e))
+		return nullptr;
+
+	const EntityRecord& record = m_records[e.index];
+	int column = record.pArchetype->columns[type];
+
+	if (column < 0)
+		return nullptr;
+
+	return GetRow(record.pArchetype, record.row, column);
+}
+
+void EntityWorld::GetChunks(const ComponentMask& mask, std::vector<ChunkRef>& out) const
+{
+	for (auto& pArchetype : m_archetypes)
+	{
+		if ((pArchetype->mask & mask) != mask)
+			continue;
+
+		for (unsigned int chunk = 0; pArchetype->GetChunkCount(chunk) > 0; ++chunk)
+		{
+			ChunkRef ref = { pArchetype.get(), chunk };
+			out.push_back(ref);
+		}
+	}
+}
+
+unsigned char* EntityWorld::GetRow(const Archetype* pArchetype, unsigned int row, unsigned int column)
+{
+	unsigned int chunk = row / pArchetype->capacity;
+	unsigned int index = row % pArchetype->capacity;
+
+	return pArchetype->GetChunk(chunk) + pArchetype->offsets[column] + index * pArchetype->infos[column].size;
+}
+
+void EntityWorld::FillRow(Archetype* pArchetype, unsigned int row)
+{
+	unsigned int last = pArchetype->count - 1;
+
+	if (row != last)
+	{
+		for (unsigned int i = 0; i < pArchetype->types.size(); ++i)
+		{
+			pArchetype->infos[i].move(GetRow(pArchetype, row, i), GetRow(pArchetype, last, i));
+		}
+
+		Entity moved = pArchetype->GetEntities(last / pArchetype->capacity)[last % pArchetype->capacity];
+		pArchetype->GetEntities(row / pArchetype->capacity)[row % pArchetype->capacity] = moved;
+		m_records[moved.index].row = row;
+	}
+
+	--pArchetype->count;
+
+	// One empty chunk is kept so that an entity moving in and out of the archetype does not allocate every time
+	while ((pArchetype->chunks.size() * pArchetype->capacity) >= (pArchetype->count + 2 * pArchetype->capacity))
+	{
+		pArchetype->chunks.pop_back();
+	}
+}
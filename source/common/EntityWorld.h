@@ -0,0 +1,218 @@
+#ifndef _ENTITYWORLD_
+#define _ENTITYWORLD_
+
+#include "CommonExport.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Handle of an entity
+// Indices are reused once an entity is destroyed, the generation tells the old entity apart from the new one
+struct Entity
+{
+	uint32_t index;
+	uint32_t generation;
+
+	bool operator ==(const Entity& other) const { return (index == other.index) && (generation == other.generation); }
+	bool operator !=(const Entity& other) const { return !(*this == other); }
+};
+
+// Handle that never refers to an entity
+const Entity NULL_ENTITY = { 0xffffffff, 0 };
+
+// Maximum number of component types in the process
+const unsigned int MAX_COMPONENT_TYPES = 128;
+
+typedef std::bitset<MAX_COMPONENT_TYPES> ComponentMask;
+
+// Components are stored as raw bytes, these functions move and destroy them
+struct ComponentTypeInfo
+{
+	unsigned int size;
+	unsigned int alignment;
+	void (*move)(void* pDst, void* pSrc); // move constructs pDst from pSrc, then destroys pSrc
+	void (*destroy)(void* p);
+};
+
+// Returns the id of a component type, the same name always gets the same id so that plugins and the engine agree on the ids
+// Use GetComponentId() instead
+COMMON_API unsigned int RegisterComponentType(const char* name, const ComponentTypeInfo& info);
+
+COMMON_API const ComponentTypeInfo& GetComponentTypeInfo(unsigned int id);
+
+// Returns the id of the component type T
+template< class T >
+unsigned int GetComponentId();
+
+// Array of entities with the same set of components
+// Chunks hold a fixed number of entities as structure of arrays: the handles, followed by one array per component type
+struct Archetype
+{
+	ComponentMask mask;
+	std::vector<unsigned int> types; // component types, sorted by id
+	std::vector<ComponentTypeInfo> infos; // info of each component type
+	std::vector<unsigned int> offsets; // offset of the array of each component type in a chunk
+	int columns[MAX_COMPONENT_TYPES]; // index of each component type in types, -1 if the archetype does not have it
+
+	unsigned int capacity; // entities per chunk
+	unsigned int chunkBytes;
+	std::vector<std::unique_ptr<std::max_align_t[]>> chunks;
+	unsigned int count; // entities in the archetype, every chunk is full except the last one
+
+	// Archetypes reached by adding or removing a component type, filled as they are needed
+	std::unordered_map<unsigned int, Archetype*> addEdges;
+	std::unordered_map<unsigned int, Archetype*> removeEdges;
+
+	unsigned char* GetChunk(unsigned int chunk) const { return reinterpret_cast<unsigned char*>(chunks[chunk].get()); }
+
+	// Number of entities in the chunk
+	unsigned int GetChunkCount(unsigned int chunk) const { return (count > chunk * capacity) ? std::min(count - chunk * capacity, capacity) : 0; }
+
+	Entity* GetEntities(unsigned int chunk) const { return reinterpret_cast<Entity*>(GetChunk(chunk)); }
+
+	// Returns the array of the component type in the chunk, the archetype must have the type
+	void* GetColumn(unsigned int chunk, unsigned int type) const { return GetChunk(chunk) + offsets[columns[type]]; }
+};
+
+// Stores entities and their components, entities with the same components are stored together in archetypes
+// Components must be movable, they are moved when components are added to or removed from their entity,
+// and when another entity of their archetype gets destroyed. Pointers to components are only valid until then
+// Entities must not be created or destroyed and components must not be added or removed while iterating,
+// DestroyDeferred() destroys entities once the iteration is over
+class EntityWorld
+{
+public:
+
+	COMMON_API EntityWorld();
+	COMMON_API ~EntityWorld();
+
+	// Creates an entity without components
+	COMMON_API Entity Create();
+
+	// Creates an entity with components
+	template< class... Ts >
+	Entity Create(Ts&&... components);
+
+	// Destroys the entity and its components, does nothing if the entity is not alive
+	COMMON_API void Destroy(Entity e);
+
+	// Destroys the entity during the next Flush(), safe to call from any thread while iterating
+	COMMON_API void DestroyDeferred(Entity e);
+
+	// Destroys the entities passed to DestroyDeferred()
+	COMMON_API void Flush();
+
+	// Returns true if the entity has been created and not destroyed
+	COMMON_API bool IsAlive(Entity e) const;
+
+	COMMON_API unsigned int GetNumEntities() const;
+
+	// Adds a component to the entity, or replaces it if the entity already has one
+	// Returns the component of the entity
+	template< class T >
+	typename std::decay<T>::type& Add(Entity e, T&& component);
+
+	// Removes a component from the entity, does nothing if it does not have one
+	template< class T >
+	void Remove(Entity e);
+
+	// Returns the component of the entity, null if it does not have one
+	template< class T >
+	T* Get(Entity e);
+
+	template< class T >
+	bool Has(Entity e) const;
+
+	// Calls f(Entity, Ts&...) for every entity that has the components Ts
+	template< class... Ts, class F >
+	void ForEach(F f);
+
+	// Calls f(count, const Entity*, Ts*...) for each chunk of entities that have the components Ts
+	// The arrays hold the count entities of the chunk, which makes for tight loops over contiguous memory
+	template< class... Ts, class F >
+	void ForEachChunk(F f);
+
+	// ForEach() spread over the job system, the chunks are processed in parallel so f must be thread safe
+	template< class... Ts, class F >
+	void ParallelForEach(JobSystem& jobs, F f);
+
+	// ForEachChunk() spread over the job system, the chunks are processed in parallel so f must be thread safe
+	template< class... Ts, class F >
+	void ParallelForEachChunk(JobSystem& jobs, F f);
+
+	// Destroys every entity
+	COMMON_API void Clear();
+
+private:
+
+	// Location of an entity
+	struct EntityRecord
+	{
+		Archetype* pArchetype;
+		uint32_t row; // index in the archetype
+		uint32_t generation;
+	};
+
+	// Chunk of an archetype, gathered for parallel iteration
+	struct ChunkRef
+	{
+		Archetype* pArchetype;
+		unsigned int chunk;
+	};
+
+	std::vector<std::unique_ptr<Archetype>> m_archetypes;
+	std::unordered_map<ComponentMask, Archetype*> m_archetypeMap;
+
+	std::vector<EntityRecord> m_records;
+	std::vector<uint32_t> m_freeIndices;
+	unsigned int m_uiNumEntities;
+
+	std::mutex m_deferredMutex;
+	std::vector<Entity> m_deferred;
+
+	// Number of iterations in progress, structural changes are not allowed during an iteration
+	int m_iIterating;
+
+	EntityWorld(const EntityWorld&) = delete;
+	EntityWorld& operator =(const EntityWorld&) = delete;
+
+	// Returns the archetype of the component types, creates it if it does not exist yet
+	COMMON_API Archetype* GetArchetype(const ComponentMask& mask);
+
+	// Returns the archetype of the entity with a component type added or removed
+	COMMON_API Archetype* GetAddEdge(Archetype* pArchetype, unsigned int type);
+	COMMON_API Archetype* GetRemoveEdge(Archetype* pArchetype, unsigned int type);
+
+	// Creates an entity in the archetype, its components are not constructed
+	COMMON_API Entity Allocate(Archetype* pArchetype);
+
+	// Moves the entity to another archetype, components the archetype does not have are destroyed
+	// and the components the entity did not have are not constructed
+	COMMON_API void MoveEntity(Entity e, Archetype* pTarget);
+
+	// Returns the address of the component of the entity, null if it does not have one
+	COMMON_API void* GetComponent(Entity e, unsigned int type) const;
+
+	// Appends the chunks of the archetypes that have the components of the mask
+	COMMON_API void GetChunks(const ComponentMask& mask, std::vector<ChunkRef>& out) const;
+
+	// Returns the address of an entity row in an archetype
+	static unsigned char* GetRow(const Archetype* pArchetype, unsigned int row, unsigned int column);
+
+	// Fills a row left empty by moving the last entity of the archetype into it
+	void FillRow(Archetype* pArchetype, unsigned int row);
+
+	template< class... Ts >
+	static ComponentMask MakeMask();
+};
+
+#include "EntityWorld.inl"
+
+#endif // _ENTITYWORLD_
@@ -0,0 +1,190 @@
+
+#include <cassert>
+#include <new>
+#include <utility>
+
+template< class T >
+void MoveComponent(void* pDst, void* pSrc)
+{
+	T* pComponent = static_cast<T*>(pSrc);
+	new (pDst) T(std::move(*pComponent));
+	pComponent->~T();
+}
+
+template< class T >
+void DestroyComponent(void* p)
+{
+	static_cast<T*>(p)->~T();
+}
+
+template< class T >
+unsigned int GetComponentId()
+{
+	typedef typename std::decay<T>::type Type;
+
+	// RTTI is disabled, the signature of the function names the type instead
+	// Each module caches the id, the registry makes sure that every module gets the same one
+	if (!std::is_same<T, Type>::value)
+		return GetComponentId<Type>();
+
+	// Chunks are only aligned for the fundamental types
+	static_assert(alignof(Type) <= alignof(std::max_align_t), "Over-aligned components are not supported");
+
+	ComponentTypeInfo info = { sizeof(Type), alignof(Type), &MoveComponent<Type>, &DestroyComponent<Type> };
+
+#ifdef _MSC_VER
+	static const unsigned int id = RegisterComponentType(__FUNCSIG__, info);
+#else
+	static const unsigned int id = RegisterComponentType(__PRETTY_FUNCTION__, info);
+#endif
+
+	return id;
+}
+
+template< class... Ts >
+ComponentMask EntityWorld::MakeMask()
+{
+	ComponentMask mask;
+	int expand[] = { 0, (mask.set(GetComponentId<Ts>()), 0)... };
+	(void)expand;
+
+	return mask;
+}
+
+template< class... Ts >
+Entity EntityWorld::Create(Ts&&... components)
+{
+	assert(m_iIterating == 0);
+
+	Entity e = Allocate(GetArchetype(MakeMask<Ts...>()));
+
+	int expand[] = { 0, (new (GetComponent(e, GetComponentId<Ts>())) typename std::decay<Ts>::type(std::forward<Ts>(components)), 0)... };
+	(void)expand;
+
+	return e;
+}
+
+template< class T >
+typename std::decay<T>::type& EntityWorld::Add(Entity e, T&& component)
+{
+	typedef typename std::decay<T>::type Type;
+
+	assert(IsAlive(e));
+
+	const unsigned int type = GetComponentId<Type>();
+
+	if (Type* pComponent = static_cast<Type*>(GetComponent(e, type)))
+	{
+		*pComponent = std::forward<T>(component);
+		return *pComponent;
+	}
+
+	assert(m_iIterating == 0);
+
+	MoveEntity(e, GetAddEdge(m_records[e.index].pArchetype, type));
+
+	return *new (GetComponent(e, type)) Type(std::forward<T>(component));
+}
+
+template< class T >
+void EntityWorld::Remove(Entity e)
+{
+	const unsigned int type = GetComponentId<T>();
+
+	if (GetComponent(e, type) == nullptr)
+		return;
+
+	assert(m_iIterating == 0);
+
+	MoveEntity(e, GetRemoveEdge(m_records[e.index].pArchetype, type));
+}
+
+template< class T >
+T* EntityWorld::Get(Entity e)
+{
+	return static_cast<T*>(GetComponent(e, GetComponentId<T>()));
+}
+
+template< class T >
+bool EntityWorld::Has(Entity e) const
+{
+	return GetComponent(e, GetComponentId<T>()) != nullptr;
+}
+
+template< class... Ts, class F >
+void EntityWorld::ForEach(F f)
+{
+	ForEachChunk<Ts...>([&f](unsigned int count, const Entity* pEntities, Ts*... pComponents)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			f(pEntities[i], pComponents[i]...);
+		}
+	});
+}
+
+template< class... Ts, class F >
+void EntityWorld::ForEachChunk(F f)
+{
+	const ComponentMask mask = MakeMask<Ts...>();
+
+	++m_iIterating;
+
+	// Archetypes created by the iteration are not visited, their entities would be visited twice
+	const unsigned int uiArchetypes = (unsigned int)m_archetypes.size();
+
+	for (unsigned int i = 0; i < uiArchetypes; ++i)
+	{
+		Archetype* pArchetype = m_archetypes[i].get();
+
+		if ((pArchetype->count == 0) || ((pArchetype->mask & mask) != mask))
+			continue;
+
+		for (unsigned int chunk = 0; chunk < pArchetype->chunks.size(); ++chunk)
+		{
+			unsigned int count = pArchetype->GetChunkCount(chunk);
+			if (count == 0)
+				break;
+
+			f(count, pArchetype->GetEntities(chunk), static_cast<Ts*>(pArchetype->GetColumn(chunk, GetComponentId<Ts>()))...);
+		}
+	}
+
+	--m_iIterating;
+}
+
+template< class... Ts, class F >
+void EntityWorld::ParallelForEach(JobSystem& jobs, F f)
+{
+	ParallelForEachChunk<Ts...>(jobs, [&f](unsigned int count, const Entity* pEntities, Ts*... pComponents)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			f(pEntities[i], pComponents[i]...);
+		}
+	});
+}
+
+template< class... Ts, class F >
+void EntityWorld::ParallelForEachChunk(JobSystem& jobs, F f)
+{
+	std::vector<ChunkRef> chunks;
+	GetChunks(MakeMask<Ts...>(), chunks);
+
+	++m_iIterating;
+
+	// A chunk is a few kilobytes of work, each job takes one
+	jobs.ParallelFor((unsigned int)chunks.size(), 1, [&](unsigned int begin, unsigned int end)
+	{
+		for (unsigned int i = begin; i < end; ++i)
+		{
+			const ChunkRef& ref = chunks[i];
+			const Archetype* pArchetype = ref.pArchetype;
+
+			f(pArchetype->GetChunkCount(ref.chunk), pArchetype->GetEntities(ref.chunk),
+			  static_cast<Ts*>(pArchetype->GetColumn(ref.chunk, GetComponentId<Ts>()))...);
+		}
+	});
+
+	--m_iIterating;
+}
@@ -0,0 +1,124 @@
+#include "FrameLimiter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+FrameLimiter::FrameLimiter() : m_fTargetFPS(0.0), m_fNextFrame(-1.0), m_fLastFrame(-1.0), m_fSleepMean(0.002), m_fSleepVariance(0.000001),
+m_fWindowStart(0.0), m_uiFrames(0), m_fSum(0.0), m_fSumSquares(0.0), m_fMin(0.0), m_fMax(0.0)
+{
+	m_pacing.frames = 0;
+	m_pacing.meanInterval = m_pacing.jitter = m_pacing.maxDeviation = 0.0;
+
+	m_timer.Start();
+}
+
+void FrameLimiter::SetTargetFPS(double fFPS)
+{
+	fFPS = std::max(fFPS, 0.0);
+
+	if (fFPS != m_fTargetFPS)
+	{
+		m_fTargetFPS = fFPS;
+		m_fNextFrame = -1.0;
+	}
+}
+
+double FrameLimiter::GetTargetFPS() const
+{
+	return m_fTargetFPS;
+}
+
+double FrameLimiter::Wait()
+{
+	double fStart = m_timer.GetTime();
+	double fNow = fStart;
+
+	if (m_fTargetFPS > 0.0)
+	{
+		const double fPeriod = 1.0 / m_fTargetFPS;
+
+		if (m_fNextFrame >= 0.0)
+		{
+			WaitUntil(m_fNextFrame);
+			fNow = m_timer.GetTime();
+		}
+
+		// Deadlines are spaced by the period so that the error of each wait does not accumulate
+		m_fNextFrame = (m_fNextFrame >= 0.0) ? (m_fNextFrame + fPeriod) : (fNow + fPeriod);
+
+		if (m_fNextFrame < fNow)
+		{
+			m_fNextFrame = fNow + fPeriod;
+		}
+	}
+
+	if (m_fLastFrame >= 0.0)
+	{
+		AddInterval(fNow - m_fLastFrame, fNow);
+	}
+
+	m_fLastFrame = fNow;
+
+	return fNow - fStart;
+}
+
+const FramePacing& FrameLimiter::GetPacing() const
+{
+	return m_pacing;
+}
+
+void FrameLimiter::WaitUntil(double fDeadline)
+{
+	double fNow = m_timer.GetTime();
+
+	// Sleep in short steps while a step is very unlikely to overshoot the deadline
+	while ((fDeadline - fNow) > (m_fSleepMean + 2.0 * std::sqrt(m_fSleepVariance)))
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		double fAfter = m_timer.GetTime();
+		double fDelta = (fAfter - fNow) - m_fSleepMean;
+
+		m_fSleepMean += fDelta * 0.05;
+		m_fSleepVariance += (fDelta * fDelta - m_fSleepVariance) * 0.05;
+
+		fNow = fAfter;
+	}
+
+	// Spin for the rest
+	while (fNow < fDeadline)
+	{
+		std::this_thread::yield();
+		fNow = m_timer.GetTime();
+	}
+}
+
+void FrameLimiter::AddInterval(double fInterval, double fNow)
+{
+	if (m_uiFrames == 0)
+	{
+		m_fMin = m_fMax = fInterval;
+	}
+
+	++m_uiFrames;
+	m_fSum += fInterval;
+	m_fSumSquares += fInterval * fInterval;
+	m_fMin = std::min(m_fMin, fInterval);
+	m_fMax = std::max(m_fMax, fInterval);
+
+	if ((fNow - m_fWindowStart) < 1.0)
+		return;
+
+	double fMean = m_fSum / m_uiFrames;
+
+	m_pacing.frames = m_uiFrames;
+	m_pacing.meanInterval = fMean;
+	m_pacing.jitter = std::sqrt(std::max(0.0, m_fSumSquares / m_uiFrames - fMean * fMean));
+	m_pacing.maxDeviation = std::max(m_fMax - fMean, fMean - m_fMin);
+
+	m_fWindowStart = fNow;
+	m_uiFrames = 0;
+	m_fSum = m_fSumSquares = 0.0;
+}
@@ -0,0 +1,66 @@
+#ifndef _FRAMELIMITER_
+#define _FRAMELIMITER_
+
+#include "CommonExport.h"
+#include "Timer.h"
+
+// Pacing of the frames over a period of time, in seconds
+struct FramePacing
+{
+	unsigned int frames;
+	double meanInterval; // average time between frames
+	double jitter; // standard deviation of the time between frames
+	double maxDeviation; // largest difference between the time between two frames and the average
+};
+
+// Paces frames at a target frame rate
+// The limiter sleeps for most of the time left and spins for the rest, since the OS may wake a sleeping thread up late
+// The time a sleep really takes is measured, so that the limiter only spins for as long as needed
+class FrameLimiter
+{
+public:
+
+	COMMON_API FrameLimiter();
+
+	// Sets the target frame rate, fFPS <= 0 removes the cap, frames are then only measured
+	COMMON_API void SetTargetFPS(double fFPS);
+	COMMON_API double GetTargetFPS() const;
+
+	// Blocks until the next frame is due, must be called once per frame
+	// When a frame is late, the following frames are paced from it instead of being rushed to catch up
+	// Returns the time spent waiting in seconds
+	COMMON_API double Wait();
+
+	// Returns the pacing of the frames measured over the last second
+	COMMON_API const FramePacing& GetPacing() const;
+
+private:
+
+	Timer m_timer;
+
+	double m_fTargetFPS;
+	double m_fNextFrame; // time the next frame is due, negative if unknown
+	double m_fLastFrame; // negative before the first frame
+
+	// Estimated time a short sleep takes, average and variance
+	double m_fSleepMean;
+	double m_fSleepVariance;
+
+	// Time between frames measured since the beginning of the window
+	double m_fWindowStart;
+	unsigned int m_uiFrames;
+	double m_fSum;
+	double m_fSumSquares;
+	double m_fMin;
+	double m_fMax;
+
+	FramePacing m_pacing;
+
+	// Sleeps and then spins until the timer reaches fDeadline
+	void WaitUntil(double fDeadline);
+
+	// Adds the time between two frames to the measurements
+	void AddInterval(double fInterval, double fNow);
+};
+
+#endif // _FRAMELIMITER_
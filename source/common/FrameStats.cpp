@@ -0,0 +1,190 @@
+#include "FrameStats.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+// 1000 buckets of 0.1 ms cover frames up to 100 ms
+const double FrameStats::BUCKET_WIDTH = 0.0001;
+
+namespace
+{
+	const unsigned int NUM_BUCKETS = 1001;
+
+	// Nearest rank percentile of sorted values
+	double GetPercentile(const std::vector<double>& sorted, double p)
+	{
+		unsigned int rank = (unsigned int)std::ceil(p * sorted.size());
+		return sorted[std::max(rank, 1u) - 1];
+	}
+
+	void WriteSummary(std::ofstream& stream, const char* name, const FrameTimeSummary& summary)
+	{
+		stream << name << ": frames " << summary.frames << " min " << summary.min * 1000.0 << " avg " << summary.avg * 1000.0
+			   << " p50 " << summary.p50 * 1000.0 << " p95 " << summary.p95 * 1000.0 << " p99 " << summary.p99 * 1000.0
+			   << " max " << summary.max * 1000.0 << " hitches " << summary.hitches << std::endl;
+	}
+}
+
+FrameStats::FrameStats(unsigned int uiWindow) : m_window(std::max(uiWindow, 1u)), m_uiNext(0), m_uiCount(0), m_fHitchThreshold(1.0 / 30.0),
+m_bDirty(true), m_buckets(NUM_BUCKETS)
+{
+	Reset();
+}
+
+void FrameStats::SetHitchThreshold(double fThreshold)
+{
+	m_fHitchThreshold = fThreshold;
+	m_bDirty = true;
+}
+
+double FrameStats::GetHitchThreshold() const
+{
+	return m_fHitchThreshold;
+}
+
+void FrameStats::AddFrame(double fFrameTime)
+{
+	m_window[m_uiNext] = fFrameTime;
+	m_uiNext = (m_uiNext + 1) % m_window.size();
+	m_uiCount = std::min(m_uiCount + 1, (unsigned int)m_window.size());
+	m_bDirty = true;
+
+	unsigned int bucket = std::min((unsigned int)(fFrameTime / BUCKET_WIDTH), NUM_BUCKETS - 1);
+	++m_buckets[bucket];
+
+	++m_uiSessionFrames;
+	m_fSessionSum += fFrameTime;
+	m_fSessionMin = (m_uiSessionFrames == 1) ? fFrameTime : std::min(m_fSessionMin, fFrameTime);
+	m_fSessionMax = (m_uiSessionFrames == 1) ? fFrameTime : std::max(m_fSessionMax, fFrameTime);
+
+	if (fFrameTime > m_fHitchThreshold)
+	{
+		++m_uiSessionHitches;
+	}
+}
+
+const FrameTimeSummary& FrameStats::GetSummary() const
+{
+	if (!m_bDirty)
+		return m_summary;
+
+	m_bDirty = false;
+	m_summary = FrameTimeSummary();
+
+	if (m_uiCount == 0)
+		return m_summary;
+
+	m_sorted.assign(m_window.begin(), m_window.begin() + m_uiCount);
+	std::sort(m_sorted.begin(), m_sorted.end());
+
+	double fSum = 0.0;
+	for (double fFrameTime : m_sorted)
+	{
+		fSum += fFrameTime;
+	}
+
+	m_summary.frames = m_uiCount;
+	m_summary.min = m_sorted.front();
+	m_summary.avg = fSum / m_uiCount;
+	m_summary.p50 = GetPercentile(m_sorted, 0.50);
+	m_summary.p95 = GetPercentile(m_sorted, 0.95);
+	m_summary.p99 = GetPercentile(m_sorted, 0.99);
+	m_summary.max = m_sorted.back();
+	m_summary.hitches = (unsigned int)(m_sorted.end() - std::upper_bound(m_sorted.begin(), m_sorted.end(), m_fHitchThreshold));
+
+	return m_summary;
+}
+
+FrameTimeSummary FrameStats::GetSessionSummary() const
+{
+	FrameTimeSummary summary = FrameTimeSummary();
+
+	if (m_uiSessionFrames == 0)
+		return summary;
+
+	summary.frames = m_uiSessionFrames;
+	summary.min = m_fSessionMin;
+	summary.avg = m_fSessionSum / m_uiSessionFrames;
+	summary.p50 = GetSessionPercentile(0.50);
+	summary.p95 = GetSessionPercentile(0.95);
+	summary.p99 = GetSessionPercentile(0.99);
+	summary.max = m_fSessionMax;
+	summary.hitches = m_uiSessionHitches;
+
+	return summary;
+}
+
+void FrameStats::GetHistogram(double fBinWidth, unsigned int uiBins, std::vector<unsigned int>& out) const
+{
+	assert(fBinWidth > 0.0);
+
+	out.assign(uiBins, 0);
+
+	if (uiBins == 0)
+		return;
+
+	for (unsigned int i = 0; i < m_uiCount; ++i)
+	{
+		unsigned int bin = (unsigned int)std::min(m_window[i] / fBinWidth, (double)(uiBins - 1));
+		++out[bin];
+	}
+}
+
+bool FrameStats::Dump(const std::string& file) const
+{
+	std::ofstream stream(file);
+
+	if (!stream)
+		return false;
+
+	stream << std::fixed << std::setprecision(2);
+	stream << "Frame times in ms, hitches are frames longer than " << m_fHitchThreshold * 1000.0 << " ms" << std::endl;
+
+	WriteSummary(stream, "Session", GetSessionSummary());
+	WriteSummary(stream, "Last frames", GetSummary());
+
+	stream << std::endl << "Histogram of the session, lower bound of each bucket in ms and frame count" << std::endl;
+
+	for (unsigned int i = 0; i < m_buckets.size(); ++i)
+	{
+		if (m_buckets[i] > 0)
+		{
+			stream << i * BUCKET_WIDTH * 1000.0 << ((i == (m_buckets.size() - 1)) ? "+ " : " ") << m_buckets[i] << std::endl;
+		}
+	}
+
+	return stream.good();
+}
+
+void FrameStats::Reset()
+{
+	m_uiNext = 0;
+	m_uiCount = 0;
+	m_bDirty = true;
+
+	std::fill(m_buckets.begin(), m_buckets.end(), 0);
+	m_uiSessionFrames = 0;
+	m_uiSessionHitches = 0;
+	m_fSessionSum = 0.0;
+	m_fSessionMin = 0.0;
+	m_fSessionMax = 0.0;
+}
+
+double FrameStats::GetSessionPercentile(double p) const
+{
+	unsigned int rank = std::max((unsigned int)std::ceil(p * m_uiSessionFrames), 1u);
+	unsigned int count = 0;
+
+	for (unsigned int i = 0; i < (m_buckets.size() - 1); ++i)
+	{
+		count += m_buckets[i];
+
+		if (count >= rank)
+			return std::min((i + 1) * BUCKET_WIDTH, m_fSessionMax);
+	}
+
+	return m_fSessionMax;
+}
@@ -0,0 +1,82 @@
+#ifndef _FRAMESTATS_
+#define _FRAMESTATS_
+
+#include "CommonExport.h"
+#include <string>
+#include <vector>
+
+// Statistics of a set of frame times, in seconds
+struct FrameTimeSummary
+{
+	unsigned int frames;
+	double min;
+	double avg;
+	double p50;
+	double p95;
+	double p99;
+	double max;
+	unsigned int hitches; // frames that took longer than the hitch threshold
+};
+
+// Collects frame times, averages alone hide stutters so the percentiles and the hitches are tracked as well
+// The last frames are kept in a rolling window, and every frame of the session is counted in a histogram
+class FrameStats
+{
+public:
+
+	// uiWindow: number of frames kept in the rolling window
+	COMMON_API explicit FrameStats(unsigned int uiWindow = 600);
+
+	// Frames that take longer than fThreshold seconds are counted as hitches, 1/30 s by default
+	COMMON_API void SetHitchThreshold(double fThreshold);
+	COMMON_API double GetHitchThreshold() const;
+
+	// Adds the time a frame took in seconds
+	COMMON_API void AddFrame(double fFrameTime);
+
+	// Returns the statistics of the rolling window
+	COMMON_API const FrameTimeSummary& GetSummary() const;
+
+	// Returns the statistics of every frame since the last Reset(), percentiles are rounded up to the 0.1 ms histogram buckets
+	COMMON_API FrameTimeSummary GetSessionSummary() const;
+
+	// Counts the frames of the rolling window in uiBins bins of fBinWidth seconds, the last bin also counts the longer frames
+	COMMON_API void GetHistogram(double fBinWidth, unsigned int uiBins, std::vector<unsigned int>& out) const;
+
+	// Writes the summaries and the histogram of the session to a text file
+	// Returns false if the file could not be written
+	COMMON_API bool Dump(const std::string& file) const;
+
+	// Forgets every frame
+	COMMON_API void Reset();
+
+private:
+
+	// Rolling window
+	std::vector<double> m_window;
+	unsigned int m_uiNext;
+	unsigned int m_uiCount;
+
+	double m_fHitchThreshold;
+
+	// The summary of the window is only computed when requested after a change
+	mutable FrameTimeSummary m_summary;
+	mutable bool m_bDirty;
+	mutable std::vector<double> m_sorted;
+
+	// Session histogram, the last bucket counts every frame longer than the others
+	std::vector<unsigned int> m_buckets;
+	unsigned int m_uiSessionFrames;
+	unsigned int m_uiSessionHitches;
+	double m_fSessionSum;
+	double m_fSessionMin;
+	double m_fSessionMax;
+
+	// Width of the buckets of the session histogram in seconds
+	static const double BUCKET_WIDTH;
+
+	// Returns the time of the bucket holding the frame at percentile p of the session
+	double GetSessionPercentile(double p) const;
+};
+
+#endif // _FRAMESTATS_
@@ -1,14 +1,21 @@
 #ifndef _IGRID_
 #define _IGRID_
 
+#include "Camera.h"
+#include "IRenderer.h"
 #include <vector>
+#include <string>
+#include <cfloat>
 #include <fstream>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <glm/mat4x4.hpp>
+#include <glm/common.hpp>
+#include <glm/matrix.hpp>
 #include <glm/gtx/transform.hpp>
 
 // Defines a 2D updateable and renderable grid
+// The grid is split into fixed size chunks, only the chunks that are visible are rendered
 template< class T >
 class IGrid
 {
@@ -20,13 +27,17 @@ public:
 	// Loads the grid from the specified file
 	IGrid(const std::string& file);
 
-	virtual ~IGrid() {}
+	// Destroys the sprite batches of the chunks
+	virtual ~IGrid();
 
 	// The logic updater method
 	virtual int Update(class IInput&) = 0;
 
-	// Render calls RenderTileCallback for each tile
-	virtual void Render(class IRenderer& renderer) const;
+	// Render calls RenderChunk for each chunk that is visible by the camera
+	// Only the chunks overlapping the visible area of the grid are visited
+	// The sprite batches of the chunks belong to the renderer, they are rebuilt if the grid is rendered by another renderer
+	// If pCamera is null, the grid is assumed to be in screen space and the visible area is the display
+	virtual void Render(IRenderer& renderer, const Camera* pCamera = nullptr) const;
 
 	// Loads grid from stream
 	virtual bool Load(std::ifstream& stream);
@@ -43,6 +54,18 @@ public:
 	// Sets the center of the grid
 	void SetCenter(const glm::vec3& center);
 
+	// Sets the number of tiles in the x and y axis of each chunk
+	void SetChunkSize(const glm::uvec2& size);
+
+	// Sets the texture of the sprites returned by GetTileSprite
+	void SetTileTexture(const std::string& texture);
+
+	// Marks the chunk containing the tile at index as dirty
+	void MarkTileDirty(unsigned int index);
+
+	// Marks every chunk as dirty
+	void MarkAllDirty();
+
 	glm::vec2 GetTileSize() const;
 
 	// Returns the grid size
@@ -54,9 +77,29 @@ public:
 	// Returns the center of the grid
 	const glm::vec3& GetCenter() const;
 
+	// Returns the number of tiles in the x and y axis of each chunk
+	const glm::uvec2& GetChunkSize() const;
+
+	// Returns the number of chunks in the x and y axis
+	const glm::uvec2& GetNumChunks() const;
+
 protected:
 
-	// RenderTileCallback is called for each tile
+	// RenderChunk is called for each visible chunk
+	// bDirty is true if a tile in the chunk has changed since the chunk was last rendered, so anything cached for the chunk should be rebuilt
+	// The default implementation draws the sprites of the chunk with a static sprite batch, then calls RenderTileCallback for each tile of the chunk with an overlay
+	// The batch and the tiles with an overlay are only gathered when the chunk is dirty, a clean chunk is drawn without touching its tiles
+	virtual void RenderChunk(IRenderer& renderer, const glm::uvec2& chunk, bool bDirty) const;
+
+	// GetTileSprite returns true if the tile is drawn as a sprite with the tile texture, the transformation of the sprite is set by the grid
+	// Only called when the chunk of the tile is dirty, so MarkTileDirty must be called when the sprite of a tile changes
+	virtual bool GetTileSprite(const T&, SpriteInstance&) const { return false; }
+
+	// HasOverlay returns true if RenderTileCallback should be called for the tile
+	// Only called when the chunk of the tile is dirty, so MarkTileDirty must be called when the overlay of a tile appears or disappears
+	virtual bool HasOverlay(const T&) const { return true; }
+
+	// RenderTileCallback is called each frame for the visible tiles with an overlay, for everything that is not part of the sprite of the tile
     virtual void RenderTileCallback(class IRenderer& renderer,const T& tile, const glm::mat4& transformation) const = 0;
 
 	//WorldSpaceToTile returns the tile from the input parameter pos via the parameter outTile
@@ -65,12 +108,51 @@ protected:
 	// returns false if invalid input
 	bool WorldSpaceToTile(const glm::vec2& pos, T** outTile, glm::uvec2* pRoundedPosOut = nullptr);
 
+	// Returns the range of tiles [min, max) covered by the chunk
+	void GetChunkTiles(const glm::uvec2& chunk, glm::uvec2& min, glm::uvec2& max) const;
+
+	// Returns the transformation of the tile at pos
+	glm::mat4 GetTileTransformation(const glm::uvec2& pos) const;
+
 	std::vector<T> m_tiles; // the grid
 	glm::vec2 m_gridSize;
 	glm::uvec2 m_numTiles;
 	
 private:
 	glm::vec3 m_center;
+
+	glm::uvec2 m_chunkSize;
+	glm::uvec2 m_numChunks;
+
+	// one flag per chunk, cleared once the chunk is rendered
+	mutable std::vector<bool> m_dirtyChunks;
+
+	// static sprite batch of each chunk, 0 until the chunk has sprites
+	mutable std::vector<int> m_chunkBatches;
+
+	// tiles of each chunk with an overlay, rebuilt when the chunk is dirty
+	mutable std::vector<std::vector<unsigned int>> m_chunkOverlays;
+
+	// sprites of the chunk being rebuilt
+	mutable std::vector<SpriteInstance> m_sprites;
+
+	// renderer owning the sprite batches
+	mutable IRenderer* m_pRenderer;
+
+	std::string m_tileTexture;
+
+	// Rebuilds the chunk list after the number of tiles or the chunk size changes
+	void BuildChunks();
+
+	// Destroys the sprite batches of the chunks
+	void ReleaseBatches() const;
+
+	// The sprite batches cannot be shared
+	IGrid(const IGrid&) = delete;
+	IGrid& operator = (const IGrid&) = delete;
+
+	// Returns the area of the grid plane that can be seen, false if it cannot be bounded
+	bool GetVisibleArea(IRenderer& renderer, const Camera* pCamera, glm::vec2& min, glm::vec2& max) const;
 };
 
 #include "IGrid.inl"
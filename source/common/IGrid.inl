@@ -1,35 +1,236 @@
 
 
 template< class T >
-IGrid<T>::IGrid() : m_gridSize(0.0f), m_numTiles(0), m_center(0.0f)
+IGrid<T>::IGrid() : m_gridSize(0.0f), m_numTiles(0), m_center(0.0f), m_chunkSize(16), m_numChunks(0), m_pRenderer(nullptr)
 {
 }
 
 template< class T >
-IGrid<T>::IGrid(const std::string& file) : m_gridSize(0.0f), m_numTiles(0.0f), m_center(0.0f)
+IGrid<T>::IGrid(const std::string& file) : m_gridSize(0.0f), m_numTiles(0.0f), m_center(0.0f), m_chunkSize(16), m_numChunks(0), m_pRenderer(nullptr)
 {
 	Load(file);
 }
 
 template< class T >
-void IGrid<T>::Render(class IRenderer& renderer) const
+IGrid<T>::~IGrid()
 {
+	ReleaseBatches();
+}
+
+template< class T >
+void IGrid<T>::Render(IRenderer& renderer, const Camera* pCamera) const
+{
+	if(m_numChunks.x == 0 || m_numChunks.y == 0 || m_gridSize.x <= 0.0f || m_gridSize.y <= 0.0f)
+		return;
+
+	// The batches of another renderer cannot be drawn
+	if(m_pRenderer != &renderer)
+	{
+		ReleaseBatches();
+		m_dirtyChunks.assign(m_dirtyChunks.size(), true);
+		m_pRenderer = &renderer;
+	}
+
 	glm::vec2 tileSize = GetTileSize();
+	glm::vec2 chunkSize = tileSize * glm::vec2(m_chunkSize);
+	glm::vec2 gridMin(m_center.x - (m_gridSize.x / 2.0f), m_center.y - (m_gridSize.y / 2.0f));
+
+	// Range of chunks [chunkMin, chunkMax) overlapping the visible area
+	glm::uvec2 chunkMin(0);
+	glm::uvec2 chunkMax(m_numChunks);
+
+	glm::vec2 areaMin, areaMax;
+	if(GetVisibleArea(renderer, pCamera, areaMin, areaMax))
+	{
+		glm::vec2 numChunks(m_numChunks);
+		glm::vec2 first = glm::clamp(glm::floor((areaMin - gridMin) / chunkSize), glm::vec2(0.0f), numChunks);
+		glm::vec2 last = glm::clamp(glm::floor((areaMax - gridMin) / chunkSize) + 1.0f, glm::vec2(0.0f), numChunks);
+
+		chunkMin = glm::uvec2(first);
+		chunkMax = glm::max(glm::uvec2(last), chunkMin);
+	}
+
+	unsigned int uiRendered = 0;
+
+	for(unsigned int y = chunkMin.y; y < chunkMax.y; ++y)
+	{
+		for(unsigned int x = chunkMin.x; x < chunkMax.x; ++x)
+		{
+			glm::uvec2 chunk(x, y);
+			glm::uvec2 tileMin, tileMax;
+			GetChunkTiles(chunk, tileMin, tileMax);
+
+			// The area bounds the view, the frustum still culls the corners of the area that it does not cover
+			if(pCamera != nullptr)
+			{
+				glm::vec2 min = gridMin + tileSize * glm::vec2(tileMin);
+				glm::vec2 max = gridMin + tileSize * glm::vec2(tileMax);
+
+				if(!pCamera->IsVisible(glm::vec3(min, m_center.z), glm::vec3(max, m_center.z)))
+					continue;
+			}
+
+			unsigned int uiChunk = y * m_numChunks.x + x;
+
+			RenderChunk(renderer, chunk, m_dirtyChunks[uiChunk]);
+			m_dirtyChunks[uiChunk] = false;
+
+			uiRendered += (tileMax.x - tileMin.x) * (tileMax.y - tileMin.y);
+		}
+	}
+
+	renderer.AddCulled(m_numTiles.x * m_numTiles.y - uiRendered);
+}
+
+template< class T >
+void IGrid<T>::RenderChunk(IRenderer& renderer, const glm::uvec2& chunk, bool bDirty) const
+{
+	unsigned int uiChunk = chunk.y * m_numChunks.x + chunk.x;
+
+	int& batch = m_chunkBatches[uiChunk];
+	std::vector<unsigned int>& overlays = m_chunkOverlays[uiChunk];
 
-	unsigned int index = 0;
-	for(unsigned int i = 0; i < m_numTiles.y; ++i)
+	if(bDirty)
 	{
-		for(unsigned int j = 0; j < m_numTiles.x; ++j)
+		glm::uvec2 tileMin, tileMax;
+		GetChunkTiles(chunk, tileMin, tileMax);
+
+		m_sprites.clear();
+		overlays.clear();
+
+		for(unsigned int i = tileMin.y; i < tileMax.y; ++i)
 		{
-			glm::vec2 pos(tileSize.x * j - (m_gridSize.x / 2.0f) + (tileSize.x / 2.0f), tileSize.y * i - (m_gridSize.y / 2.0f) + (tileSize.y / 2.0f));
-			glm::mat4 transformation(glm::translate(glm::vec3(pos.x + m_center.x,pos.y + m_center.y,m_center.z)));
-			transformation = glm::scale(transformation,glm::vec3(tileSize.x,tileSize.y,1.0f));
+			for(unsigned int j = tileMin.x; j < tileMax.x; ++j)
+			{
+				unsigned int index = i * m_numTiles.x + j;
+				const T& tile = m_tiles[index];
+
+				SpriteInstance sprite;
+				if(GetTileSprite(tile, sprite))
+				{
+					sprite.transformation = GetTileTransformation(glm::uvec2(j, i));
+					m_sprites.push_back(sprite);
+				}
+
+				if(HasOverlay(tile))
+				{
+					overlays.push_back(index);
+				}
+			}
+		}
+
+		// The batch is only uploaded again when the chunk changes
+		if((batch == 0) && !m_sprites.empty())
+		{
+			batch = renderer.CreateSpriteBatch();
+		}
+
+		if(batch != 0)
+		{
+			renderer.UpdateSpriteBatch(batch, m_sprites.data(), (unsigned int)m_sprites.size());
+		}
+	}
+
+	if(batch != 0)
+	{
+		renderer.DrawSpriteBatch(batch, m_tileTexture);
+	}
+
+	for(unsigned int index : overlays)
+	{
+		glm::uvec2 pos(index % m_numTiles.x, index / m_numTiles.x);
+		RenderTileCallback(renderer, m_tiles[index], GetTileTransformation(pos));
+	}
+}
+
+template< class T >
+void IGrid<T>::GetChunkTiles(const glm::uvec2& chunk, glm::uvec2& min, glm::uvec2& max) const
+{
+	min = chunk * m_chunkSize;
+	max = glm::min(min + m_chunkSize, m_numTiles);
+}
+
+template< class T >
+glm::mat4 IGrid<T>::GetTileTransformation(const glm::uvec2& tile) const
+{
+	glm::vec2 tileSize = GetTileSize();
+	glm::vec2 pos(tileSize.x * tile.x - (m_gridSize.x / 2.0f) + (tileSize.x / 2.0f), tileSize.y * tile.y - (m_gridSize.y / 2.0f) + (tileSize.y / 2.0f));
+
+	glm::mat4 transformation(glm::translate(glm::vec3(pos.x + m_center.x,pos.y + m_center.y,m_center.z)));
+	return glm::scale(transformation,glm::vec3(tileSize.x,tileSize.y,1.0f));
+}
+
+template< class T >
+void IGrid<T>::BuildChunks()
+{
+	m_numChunks = (m_numTiles + m_chunkSize - 1u) / m_chunkSize;
 
-			RenderTileCallback(renderer,m_tiles[index],transformation);
+	ReleaseBatches();
 
-			index++;
+	m_dirtyChunks.assign(m_numChunks.x * m_numChunks.y, true);
+	m_chunkBatches.assign(m_numChunks.x * m_numChunks.y, 0);
+	m_chunkOverlays.assign(m_numChunks.x * m_numChunks.y, std::vector<unsigned int>());
+}
+
+template< class T >
+void IGrid<T>::ReleaseBatches() const
+{
+	for(int& batch : m_chunkBatches)
+	{
+		if((batch != 0) && (m_pRenderer != nullptr))
+		{
+			m_pRenderer->DestroySpriteBatch(batch);
 		}
+
+		batch = 0;
+	}
+}
+
+template< class T >
+bool IGrid<T>::GetVisibleArea(IRenderer& renderer, const Camera* pCamera, glm::vec2& min, glm::vec2& max) const
+{
+	if(pCamera == nullptr)
+	{
+		int width = 0;
+		int height = 0;
+		renderer.GetDisplayMode(&width, &height);
+
+		min = glm::vec2(0.0f);
+		max = glm::vec2(width, height);
+
+		return true;
 	}
+
+	// Intersects the rays through the corners of the view with the plane of the grid
+	glm::mat4 invViewProj = glm::inverse(pCamera->ViewProj());
+
+	min = glm::vec2(FLT_MAX);
+	max = glm::vec2(-FLT_MAX);
+
+	for(unsigned int i = 0; i < 4; ++i)
+	{
+		glm::vec2 corner((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f);
+
+		glm::vec4 nearPos = invViewProj * glm::vec4(corner, -1.0f, 1.0f);
+		glm::vec4 farPos = invViewProj * glm::vec4(corner, 1.0f, 1.0f);
+
+		glm::vec3 rayStart = glm::vec3(nearPos) / nearPos.w;
+		glm::vec3 rayDir = glm::vec3(farPos) / farPos.w - rayStart;
+
+		// The view is parallel to the grid or looks away from it, the area is not bounded
+		if(glm::abs(rayDir.z) < 1e-6f)
+			return false;
+
+		float t = (m_center.z - rayStart.z) / rayDir.z;
+		if(t < 0.0f)
+			return false;
+
+		glm::vec2 pos = glm::vec2(rayStart + rayDir * t);
+		min = glm::min(min, pos);
+		max = glm::max(max, pos);
+	}
+
+	return true;
 }
 
 template< class T >
@@ -94,6 +295,8 @@ bool IGrid<T>::Load(std::ifstream& stream)
 		++i;
 	}
 
+	BuildChunks();
+
 	return true;
 }
 
@@ -120,6 +323,7 @@ template< class T >
 void IGrid<T>::SetGridSize(const glm::vec2& size)
 {
 	m_gridSize = size;
+	MarkAllDirty();
 }
 
 template< class T >
@@ -127,12 +331,46 @@ void IGrid<T>::SetNumTiles(const glm::uvec2& size)
 {
 	m_numTiles = size;
 	m_tiles.resize(m_numTiles.x * m_numTiles.y);
+
+	BuildChunks();
 }
 
 template< class T >
 void IGrid<T>::SetCenter(const glm::vec3& center)
 {
 	m_center = center;
+	MarkAllDirty();
+}
+
+template< class T >
+void IGrid<T>::SetChunkSize(const glm::uvec2& size)
+{
+	m_chunkSize = glm::max(size, glm::uvec2(1));
+	BuildChunks();
+}
+
+template< class T >
+void IGrid<T>::SetTileTexture(const std::string& texture)
+{
+	m_tileTexture = texture;
+}
+
+template< class T >
+void IGrid<T>::MarkTileDirty(unsigned int index)
+{
+	if(index < m_tiles.size())
+	{
+		unsigned int x = (index % m_numTiles.x) / m_chunkSize.x;
+		unsigned int y = (index / m_numTiles.x) / m_chunkSize.y;
+
+		m_dirtyChunks[y * m_numChunks.x + x] = true;
+	}
+}
+
+template< class T >
+void IGrid<T>::MarkAllDirty()
+{
+	m_dirtyChunks.assign(m_dirtyChunks.size(), true);
 }
 
 template< class T >
@@ -158,3 +396,15 @@ const glm::vec3& IGrid<T>::GetCenter() const
 {
 	return m_center;
 }
+
+template< class T >
+const glm::uvec2& IGrid<T>::GetChunkSize() const
+{
+	return m_chunkSize;
+}
+
+template< class T >
+const glm::uvec2& IGrid<T>::GetNumChunks() const
+{
+	return m_numChunks;
+}
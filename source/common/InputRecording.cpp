@@ -0,0 +1,173 @@
+#include "InputRecording.h"
+#include <cstring>
+
+namespace
+{
+	const char RECORDING_MAGIC[4] = { 'I', 'N', 'P', 'R' };
+	const uint32_t RECORDING_VERSION = 1;
+
+	template< class T >
+	void WriteValue(std::ofstream& stream, T value)
+	{
+		stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template< class T >
+	T ReadValue(std::ifstream& stream)
+	{
+		T value = T();
+		stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+		return value;
+	}
+}
+
+bool InputRecordingWriter::Open(const std::string& file, unsigned int uiSeed)
+{
+	Close();
+
+	m_stream.open(file, std::ios::binary);
+	if (!m_stream.is_open())
+		return false;
+
+	m_stream.write(RECORDING_MAGIC, sizeof(RECORDING_MAGIC));
+	WriteValue<uint32_t>(m_stream, RECORDING_VERSION);
+	WriteValue<uint32_t>(m_stream, uiSeed);
+
+	return true;
+}
+
+bool InputRecordingWriter::IsOpen() const
+{
+	return m_stream.is_open();
+}
+
+void InputRecordingWriter::Close()
+{
+	if (m_stream.is_open())
+	{
+		m_stream.close();
+	}
+}
+
+void InputRecordingWriter::Write(const InputFrame& frame)
+{
+	WriteValue<double>(m_stream, frame.dt);
+	WriteValue<int16_t>(m_stream, (int16_t)frame.key);
+	WriteValue<int8_t>(m_stream, (int8_t)frame.keyAction);
+	WriteValue<uint32_t>(m_stream, frame.charKey);
+
+	for (int action : frame.mouseButtons)
+	{
+		WriteValue<int8_t>(m_stream, (int8_t)action);
+	}
+
+	WriteValue<int32_t>(m_stream, frame.acceleration.x);
+	WriteValue<int32_t>(m_stream, frame.acceleration.y);
+	WriteValue<int32_t>(m_stream, frame.cursorPos.x);
+	WriteValue<int32_t>(m_stream, frame.cursorPos.y);
+	WriteValue<int32_t>(m_stream, frame.selectedPos.x);
+	WriteValue<int32_t>(m_stream, frame.selectedPos.y);
+	WriteValue<double>(m_stream, frame.scroll);
+	WriteValue<uint8_t>(m_stream, frame.entered ? 1 : 0);
+	WriteValue<uint8_t>(m_stream, frame.heldMouseButtons);
+
+	WriteValue<uint16_t>(m_stream, (uint16_t)frame.heldKeys.size());
+	for (uint16_t key : frame.heldKeys)
+	{
+		WriteValue<uint16_t>(m_stream, key);
+	}
+
+	WriteValue<uint8_t>(m_stream, (uint8_t)frame.joystickAxes.size());
+	for (float axis : frame.joystickAxes)
+	{
+		WriteValue<float>(m_stream, axis);
+	}
+
+	WriteValue<uint8_t>(m_stream, (uint8_t)frame.joystickButtons.size());
+	for (unsigned char button : frame.joystickButtons)
+	{
+		WriteValue<uint8_t>(m_stream, button);
+	}
+}
+
+bool InputRecordingReader::Open(const std::string& file, unsigned int& uiSeed)
+{
+	Close();
+
+	m_stream.open(file, std::ios::binary);
+	if (!m_stream.is_open())
+		return false;
+
+	char magic[4];
+	m_stream.read(magic, sizeof(magic));
+	uint32_t version = ReadValue<uint32_t>(m_stream);
+	uiSeed = ReadValue<uint32_t>(m_stream);
+
+	if (!m_stream || (memcmp(magic, RECORDING_MAGIC, sizeof(magic)) != 0) || (version != RECORDING_VERSION))
+	{
+		m_stream.close();
+		return false;
+	}
+
+	return true;
+}
+
+bool InputRecordingReader::IsOpen() const
+{
+	return m_stream.is_open();
+}
+
+void InputRecordingReader::Close()
+{
+	if (m_stream.is_open())
+	{
+		m_stream.close();
+	}
+}
+
+bool InputRecordingReader::Read(InputFrame& frame)
+{
+	frame.dt = ReadValue<double>(m_stream);
+
+	if (!m_stream)
+		return false;
+
+	frame.key = ReadValue<int16_t>(m_stream);
+	frame.keyAction = ReadValue<int8_t>(m_stream);
+	frame.charKey = ReadValue<uint32_t>(m_stream);
+
+	for (int& action : frame.mouseButtons)
+	{
+		action = ReadValue<int8_t>(m_stream);
+	}
+
+	frame.acceleration.x = ReadValue<int32_t>(m_stream);
+	frame.acceleration.y = ReadValue<int32_t>(m_stream);
+	frame.cursorPos.x = ReadValue<int32_t>(m_stream);
+	frame.cursorPos.y = ReadValue<int32_t>(m_stream);
+	frame.selectedPos.x = ReadValue<int32_t>(m_stream);
+	frame.selectedPos.y = ReadValue<int32_t>(m_stream);
+	frame.scroll = ReadValue<double>(m_stream);
+	frame.entered = ReadValue<uint8_t>(m_stream) != 0;
+	frame.heldMouseButtons = ReadValue<uint8_t>(m_stream);
+
+	frame.heldKeys.resize(ReadValue<uint16_t>(m_stream));
+	for (auto& key : frame.heldKeys)
+	{
+		key = ReadValue<uint16_t>(m_stream);
+	}
+
+	frame.joystickAxes.resize(ReadValue<uint8_t>(m_stream));
+	for (auto& axis : frame.joystickAxes)
+	{
+		axis = ReadValue<float>(m_stream);
+	}
+
+	frame.joystickButtons.resize(ReadValue<uint8_t>(m_stream));
+	for (auto& button : frame.joystickButtons)
+	{
+		button = ReadValue<uint8_t>(m_stream);
+	}
+
+	return !m_stream.fail();
+}
@@ -0,0 +1,84 @@
+#ifndef _INPUTRECORDING_
+#define _INPUTRECORDING_
+
+#include "CommonExport.h"
+#include <glm/vec2.hpp>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// An input recording is a binary file that stores the input and the time step of every frame, see IInput::BeginRecording()
+// Layout: "INPR", uint32 version, uint32 seed
+// Then for each frame:
+// double dt, int16 key, int8 key action, uint32 char, int8[INPUT_MOUSE_BUTTONS] mouse button actions,
+// int32 acceleration x, y, int32 cursor x, y, int32 selection x, y, double scroll, uint8 entered,
+// uint8 held mouse buttons, uint16 held key count, uint16[] held keys,
+// uint8 joystick axis count, float[] axes, uint8 joystick button count, uint8[] button states
+
+// Number of mouse buttons stored per frame
+const unsigned int INPUT_MOUSE_BUTTONS = 8;
+
+// Actions of the keys and the mouse buttons, -1 if nothing happened during the frame
+const int INPUT_RELEASE = 0;
+const int INPUT_PRESS = 1;
+
+// Input of a single frame
+struct InputFrame
+{
+	double dt;
+	int key;
+	int keyAction;
+	unsigned int charKey;
+	int mouseButtons[INPUT_MOUSE_BUTTONS];
+	glm::ivec2 acceleration;
+	glm::ivec2 cursorPos;
+	glm::ivec2 selectedPos;
+	double scroll;
+	bool entered;
+	uint8_t heldMouseButtons; // bit i is set while mouse button i is held
+	std::vector<uint16_t> heldKeys;
+	std::vector<float> joystickAxes;
+	std::vector<unsigned char> joystickButtons;
+};
+
+// Writes the frames of an input recording
+class InputRecordingWriter
+{
+public:
+
+	// Creates the recording, returns false if the file cannot be created
+	COMMON_API bool Open(const std::string& file, unsigned int uiSeed);
+
+	COMMON_API bool IsOpen() const;
+	COMMON_API void Close();
+
+	COMMON_API void Write(const InputFrame& frame);
+
+private:
+
+	std::ofstream m_stream;
+};
+
+// Reads the frames of an input recording
+class InputRecordingReader
+{
+public:
+
+	// Opens the recording, the seed of the recording is returned via uiSeed
+	// Returns false if the file is not a recording
+	COMMON_API bool Open(const std::string& file, unsigned int& uiSeed);
+
+	COMMON_API bool IsOpen() const;
+	COMMON_API void Close();
+
+	// Reads the next frame, returns false if there are no frames left
+	// A truncated frame is not returned
+	COMMON_API bool Read(InputFrame& frame);
+
+private:
+
+	std::ifstream m_stream;
+};
+
+#endif // _INPUTRECORDING_
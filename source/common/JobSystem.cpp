@@ -0,0 +1,309 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+	// Index of the worker running on this thread, -1 for threads that are not workers
+	thread_local int s_iWorker = -1;
+}
+
+JobCounter::JobCounter() : m_count(0)
+{
+}
+
+bool JobCounter::IsDone() const
+{
+	return m_count.load(std::memory_order_acquire) == 0;
+}
+
+JobSystem::JobSystem(unsigned int uiWorkers) : m_iQueued(0), m_bQuit(false), m_mainThread(std::this_thread::get_id())
+{
+	if (uiWorkers == 0)
+	{
+		unsigned int uiThreads = std::thread::hardware_concurrency();
+		uiWorkers = (uiThreads > 1) ? (uiThreads - 1) : 0;
+	}
+
+	for (unsigned int i = 0; i <= uiWorkers; ++i)
+	{
+		m_queues.emplace_back(new Queue());
+	}
+
+	for (unsigned int i = 0; i < uiWorkers; ++i)
+	{
+		m_workers.emplace_back(&JobSystem::WorkerMain, this, i);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	// Finish the jobs that are still queued
+	Entry entry;
+	while (Pop(entry))
+	{
+		Execute(entry);
+	}
+
+	RunMainThreadJobs();
+
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_bQuit = true;
+	}
+
+	m_wake.notify_all();
+
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+void JobSystem::Run(const Job& job, JobCounter* pCounter, JobCounter* pDependency)
+{
+	if (pCounter != nullptr)
+	{
+		pCounter->m_count.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	Entry entry = { job, pCounter };
+
+	if ((pDependency != nullptr) && !pDependency->IsDone())
+	{
+		std::lock_guard<std::mutex> lock(m_dependentMutex);
+
+		// The dependency may have completed before the lock was taken, in which case nobody would release the job
+		if (!pDependency->IsDone())
+		{
+			Dependent dependent = { std::move(entry), pDependency };
+			m_dependents.push_back(std::move(dependent));
+			return;
+		}
+	}
+
+	Push(std::move(entry));
+}
+
+void JobSystem::RunOnMainThread(const Job& job, JobCounter* pCounter)
+{
+	if (pCounter != nullptr)
+	{
+		pCounter->m_count.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	std::lock_guard<std::mutex> lock(m_mainQueue.mutex);
+	m_mainQueue.jobs.push_back({ job, pCounter });
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+	bool bMainThread = IsMainThread();
+
+	// Help with the queued jobs instead of blocking
+	while (!counter.IsDone())
+	{
+		Entry entry;
+		if (Pop(entry))
+		{
+			Execute(entry);
+		}
+		else if (bMainThread && HasMainThreadJobs())
+		{
+			RunMainThreadJobs();
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::ParallelFor(unsigned int count, unsigned int batchSize, const std::function<void(unsigned int, unsigned int)>& body)
+{
+	assert(batchSize > 0);
+
+	if (count == 0)
+		return;
+
+	// Without workers or with a single batch, there is nothing to distribute
+	if (m_workers.empty() || (count <= batchSize))
+	{
+		body(0, count);
+		return;
+	}
+
+	JobCounter counter;
+
+	for (unsigned int begin = batchSize; begin < count; begin += batchSize)
+	{
+		unsigned int end = std::min(count, begin + batchSize);
+		Run([&body, begin, end] { body(begin, end); }, &counter);
+	}
+
+	// The calling thread takes the first batch
+	body(0, batchSize);
+
+	Wait(counter);
+}
+
+void JobSystem::RunMainThreadJobs()
+{
+	assert(IsMainThread());
+
+	// Jobs queued by the jobs that run here are left for the next call
+	std::deque<Entry> jobs;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mainQueue.mutex);
+		jobs.swap(m_mainQueue.jobs);
+	}
+
+	for (Entry& entry : jobs)
+	{
+		Execute(entry);
+	}
+}
+
+bool JobSystem::HasMainThreadJobs()
+{
+	// Workers push main thread jobs concurrently
+	std::lock_guard<std::mutex> lock(m_mainQueue.mutex);
+	return !m_mainQueue.jobs.empty();
+}
+
+unsigned int JobSystem::GetNumWorkers() const
+{
+	return (unsigned int)m_workers.size();
+}
+
+bool JobSystem::IsMainThread() const
+{
+	return std::this_thread::get_id() == m_mainThread;
+}
+
+unsigned int JobSystem::GetQueueIndex() const
+{
+	return (s_iWorker >= 0) ? (unsigned int)s_iWorker : (unsigned int)m_workers.size();
+}
+
+void JobSystem::Push(Entry&& entry)
+{
+	Queue& queue = *m_queues[GetQueueIndex()];
+
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back(std::move(entry));
+	}
+
+	m_iQueued.fetch_add(1, std::memory_order_release);
+
+	// Taking the lock makes sure that a worker about to sleep sees the job
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+	}
+
+	m_wake.notify_one();
+}
+
+bool JobSystem::Pop(Entry& out)
+{
+	if (m_iQueued.load(std::memory_order_acquire) <= 0)
+		return false;
+
+	const unsigned int uiQueues = (unsigned int)m_queues.size();
+	const unsigned int uiOwn = GetQueueIndex();
+
+	// The newest job of its own queue is the most likely to still be in the cache
+	{
+		Queue& queue = *m_queues[uiOwn];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if (!queue.jobs.empty())
+		{
+			out = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+			m_iQueued.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	// Steal the oldest job of another queue
+	for (unsigned int i = 1; i < uiQueues; ++i)
+	{
+		Queue& queue = *m_queues[(uiOwn + i) % uiQueues];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if (!queue.jobs.empty())
+		{
+			out = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+			m_iQueued.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobSystem::Execute(Entry& entry)
+{
+	entry.job();
+
+	if (entry.pCounter != nullptr)
+	{
+		Finish(entry.pCounter);
+	}
+}
+
+void JobSystem::Finish(JobCounter* pCounter)
+{
+	if (pCounter->m_count.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		return;
+
+	// Release the jobs that were waiting for this counter
+	std::vector<Entry> released;
+
+	{
+		std::lock_guard<std::mutex> lock(m_dependentMutex);
+
+		auto iter = std::partition(m_dependents.begin(), m_dependents.end(), [pCounter](const Dependent& dependent)
+		{
+			return dependent.pDependency != pCounter;
+		});
+
+		for (auto released_iter = iter; released_iter != m_dependents.end(); ++released_iter)
+		{
+			released.push_back(std::move(released_iter->entry));
+		}
+
+		m_dependents.erase(iter, m_dependents.end());
+	}
+
+	for (Entry& entry : released)
+	{
+		Push(std::move(entry));
+	}
+}
+
+void JobSystem::WorkerMain(unsigned int index)
+{
+	s_iWorker = (int)index;
+
+	while (true)
+	{
+		Entry entry;
+		if (Pop(entry))
+		{
+			Execute(entry);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_wakeMutex);
+		m_wake.wait(lock, [this] { return m_bQuit || (m_iQueued.load(std::memory_order_acquire) > 0); });
+
+		if (m_bQuit && (m_iQueued.load(std::memory_order_acquire) <= 0))
+			break;
+	}
+}
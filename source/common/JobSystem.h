@@ -0,0 +1,135 @@
+#ifndef _JOBSYSTEM_
+#define _JOBSYSTEM_
+
+#include "CommonExport.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+typedef std::function<void()> Job;
+
+// Counts the jobs of a group that have not completed yet
+// Wait on a counter to wait for the group, or pass it as the dependency of other jobs
+class JobCounter
+{
+public:
+
+	COMMON_API JobCounter();
+
+	// Returns true once every job of the group has completed
+	COMMON_API bool IsDone() const;
+
+private:
+
+	std::atomic<unsigned int> m_count;
+
+	friend class JobSystem;
+
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator = (const JobCounter&) = delete;
+};
+
+// Runs jobs on a pool of worker threads
+// Each worker has its own queue, it runs its newest job first and steals the oldest job of another queue when its own is empty
+// Jobs that must run on the main thread, ex: OpenGL work, are kept in a separate queue
+class JobSystem
+{
+public:
+
+	// Starts uiWorkers worker threads, 0 starts one less than the number of hardware threads
+	COMMON_API explicit JobSystem(unsigned int uiWorkers = 0);
+
+	// Runs the jobs still queued and stops the workers
+	COMMON_API ~JobSystem();
+
+	// Queues a job, pCounter may be null if nobody waits for the job
+	// If pDependency is not null, the job does not start before every job of pDependency has completed
+	COMMON_API void Run(const Job& job, JobCounter* pCounter = nullptr, JobCounter* pDependency = nullptr);
+
+	// Queues a job that only runs on the main thread, during Wait() or RunMainThreadJobs()
+	COMMON_API void RunOnMainThread(const Job& job, JobCounter* pCounter = nullptr);
+
+	// Runs queued jobs until every job of the counter has completed
+	// A counter of main thread jobs must only be waited on by the main thread
+	COMMON_API void Wait(JobCounter& counter);
+
+	// Invokes body(begin, end) over [0, count) in batches of batchSize and returns once every batch is done
+	COMMON_API void ParallelFor(unsigned int count, unsigned int batchSize, const std::function<void(unsigned int, unsigned int)>& body);
+
+	// Runs the jobs queued for the main thread, must be called by the main thread
+	COMMON_API void RunMainThreadJobs();
+
+	// Returns the number of worker threads, the main thread is not included
+	COMMON_API unsigned int GetNumWorkers() const;
+
+	// Returns true if the calling thread is the thread that created the job system
+	COMMON_API bool IsMainThread() const;
+
+private:
+
+	struct Entry
+	{
+		Job job;
+		JobCounter* pCounter;
+	};
+
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<Entry> jobs;
+	};
+
+	// Jobs waiting for a dependency
+	struct Dependent
+	{
+		Entry entry;
+		JobCounter* pDependency;
+	};
+
+	std::vector<std::thread> m_workers;
+
+	// One queue per worker, followed by the queue shared by every other thread
+	std::vector<std::unique_ptr<Queue>> m_queues;
+
+	Queue m_mainQueue;
+
+	std::mutex m_dependentMutex;
+	std::vector<Dependent> m_dependents;
+
+	// Idle workers sleep until a job is queued
+	std::mutex m_wakeMutex;
+	std::condition_variable m_wake;
+	std::atomic<int> m_iQueued;
+	bool m_bQuit;
+
+	std::thread::id m_mainThread;
+
+	// Index of the queue the calling thread pushes to
+	unsigned int GetQueueIndex() const;
+
+	void Push(Entry&& entry);
+
+	// Returns true if jobs are queued for the main thread
+	bool HasMainThreadJobs();
+
+	// Pops a job from the queue of the calling thread or steals one from another queue
+	bool Pop(Entry& out);
+
+	// Runs a job and signals its counter
+	void Execute(Entry& entry);
+
+	// Called when a job of the counter completes, releases the jobs depending on the counter once all of them are done
+	void Finish(JobCounter* pCounter);
+
+	void WorkerMain(unsigned int index);
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator = (const JobSystem&) = delete;
+};
+
+#endif // _JOBSYSTEM_
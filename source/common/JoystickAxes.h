@@ -0,0 +1,100 @@
+#ifndef _JOYSTICKAXES_
+#define _JOYSTICKAXES_
+
+#include "IInput.h"
+#include <cmath>
+#include <glm/vec2.hpp>
+#include <glm/geometric.hpp>
+#include <glm/common.hpp>
+#include <glm/gtc/constants.hpp>
+
+// Shared by the input plug-ins, so that replayed axes are processed the same way as the axes of a joystick
+
+// Returns the value of the joystick axis i from the raw axes of the joystick, see IInput::GetJoystickAxes()
+// pAxes must hold at least 2 axes, deadZone only applies to the sticks
+inline glm::vec2 GetJoystickAxes(const float* pAxes, int count, JoystickAxes i, float deadZone)
+{
+	glm::vec2 axes;
+
+	if (i == JoystickAxes::LS || i == JoystickAxes::RS)
+	{
+		if (i == JoystickAxes::LS)
+		{
+			axes = glm::vec2(pAxes[0], pAxes[1]);
+		}
+		else if (count >= 5)
+		{
+			axes = glm::vec2(pAxes[4], pAxes[3]);
+		}
+
+		// Determine how far the controller is pushed
+		float magnitude = glm::length(axes);
+
+		// Check if the controller is outside a circular dead zone
+		if (magnitude > deadZone)
+		{
+			// Clip the magnitude at its expected maximum value
+			if (magnitude > 1.0f)
+			{
+				magnitude = 1.0f;
+			}
+
+			// Determine the direction the controller is pushed
+			axes /= magnitude;
+
+			// Adjust magnitude relative to the end of the dead zone
+			magnitude -= deadZone;
+
+			// Normalize the magnitude with respect to its expected range
+			// giving a magnitude value of 0.0 to 1.0
+			axes *= (magnitude / (1.0f - deadZone));
+		}
+		else
+		{
+			axes = glm::vec2();
+		}
+	}
+	else if (count >= 3)
+	{
+		axes = glm::vec2(0.0f, pAxes[2]);
+
+		// Clip the magnitude at its expected maximum value
+		axes.y = glm::clamp(axes.y, -1.0f, 1.0f);
+	}
+
+	return axes;
+}
+
+// Returns true if the stick is pushed, the direction it is pushed in is returned via dir, see IInput::GetMovingJoystickAxes()
+inline bool GetJoystickDirection(const glm::vec2& axes, int& dir)
+{
+	// If the axes is being pushed
+	if (axes.x > 0.0f || axes.x < 0.0f || axes.y > 0.0f || axes.y < 0.0f)
+	{
+		// Get the angle of the direction in degrees
+		float angle = atan2(-axes.y, axes.x) * 180.0f / glm::pi<float>();
+
+		if (angle < 135.0f && angle > 45.0f)
+		{
+			dir = 0; // Up
+		}
+		else if (angle > -135.0f && angle < -45.0f)
+		{
+			dir = 1; // Down
+		}
+		else if (angle > 135.0f || angle < -135.0f)
+		{
+			dir = 2; // Left
+		}
+		else
+		{
+			dir = 3; // Right
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+#endif // _JOYSTICKAXES_
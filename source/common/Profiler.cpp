@@ -0,0 +1,51 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstring>
+
+Profiler& Profiler::Instance()
+{
+	static Profiler instance;
+	return instance;
+}
+
+void Profiler::Add(const char* name, double fTime)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	unsigned int i = 0;
+	while ((i < m_samples.size()) && (m_names[i] != name) && (std::strcmp(m_samples[i].name.c_str(), name) != 0))
+	{
+		++i;
+	}
+
+	if (i == m_samples.size())
+	{
+		ProfileSample sample;
+		sample.name = name;
+		sample.calls = 0;
+		sample.total = 0.0;
+		sample.max = 0.0;
+
+		m_samples.push_back(sample);
+		m_names.push_back(name);
+	}
+
+	ProfileSample& sample = m_samples[i];
+	++sample.calls;
+	sample.total += fTime;
+	sample.max = std::max(sample.max, fTime);
+}
+
+void Profiler::GetSamples(std::vector<ProfileSample>& out) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	out = m_samples;
+}
+
+void Profiler::Reset()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_samples.clear();
+	m_names.clear();
+}
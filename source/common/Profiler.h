@@ -0,0 +1,76 @@
+#ifndef _PROFILER_
+#define _PROFILER_
+
+#include "CommonExport.h"
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Time spent in a scope, in seconds
+struct ProfileSample
+{
+	std::string name;
+	unsigned int calls;
+	double total;
+	double max; // longest call
+};
+
+// Accumulates the time spent in named scopes, see PROFILE_SCOPE()
+// Scopes are few and coarse, ex: the update and the draw of each frame, so they are kept in a small list
+class Profiler
+{
+public:
+
+	COMMON_API static Profiler& Instance();
+
+	// Adds a call of fTime seconds to the scope, safe to call from any thread
+	// name should be a string literal, it is only copied the first time the scope is seen
+	COMMON_API void Add(const char* name, double fTime);
+
+	// Returns every scope in the order they were first seen
+	COMMON_API void GetSamples(std::vector<ProfileSample>& out) const;
+
+	// Forgets every scope
+	COMMON_API void Reset();
+
+private:
+
+	mutable std::mutex m_mutex;
+	std::vector<ProfileSample> m_samples;
+	std::vector<const char*> m_names; // name passed for each sample, compared before the strings
+
+	Profiler() {}
+	Profiler(const Profiler&) = delete;
+	Profiler& operator=(const Profiler&) = delete;
+};
+
+// Measures the time until the end of the scope
+class ProfileScope
+{
+public:
+
+	explicit ProfileScope(const char* name) : m_name(name), m_start(std::chrono::high_resolution_clock::now()) {}
+
+	~ProfileScope()
+	{
+		std::chrono::duration<double> time = std::chrono::high_resolution_clock::now() - m_start;
+		Profiler::Instance().Add(m_name, time.count());
+	}
+
+private:
+
+	const char* m_name;
+	std::chrono::high_resolution_clock::time_point m_start;
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+// Profiles the rest of the current scope under name
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+
+#endif // _PROFILER_
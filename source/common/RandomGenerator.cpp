@@ -26,6 +26,11 @@ RandomGenerator::RandomGenerator()
 	}
 }
 
+void RandomGenerator::Seed(unsigned int uiSeed)
+{
+	m_generator.seed(uiSeed);
+}
+
 int RandomGenerator::Generate(int max)
 {
 	return Generate(0, max);
@@ -13,6 +13,9 @@ public:
 
 	COMMON_API static RandomGenerator& Instance();
 
+	// Restarts the sequence of random numbers from uiSeed, the same seed always gives the same sequence
+	COMMON_API void Seed(unsigned int uiSeed);
+
 	// Returns a random int between [0, max]
 	COMMON_API int Generate(int max);
 
@@ -0,0 +1,491 @@
+#include "RenderCapture.h"
+#include <algorithm>
+#include <iterator>
+#include <cstring>
+#include <cassert>
+
+using namespace std;
+
+namespace
+{
+	const char CAPTURE_MAGIC[4] = { 'R', 'C', 'A', 'P' };
+	const unsigned int CAPTURE_VERSION = 1;
+
+	// Index stored in place of a string when there is none, ex: the default font
+	const unsigned short NO_STRING = 0xffff;
+
+	// Reads values out of a loaded capture, once a read goes past the end of the data the stream becomes invalid
+	class CaptureStream
+	{
+	public:
+
+		CaptureStream(const vector<char>& data, size_t offset) : m_data(data), m_offset(offset), m_bValid(true)
+		{
+		}
+
+		void Read(void* pOut, size_t bytes)
+		{
+			if(!m_bValid || (bytes > (m_data.size() - m_offset)))
+			{
+				m_bValid = false;
+				memset(pOut, 0, bytes);
+				return;
+			}
+
+			memcpy(pOut, m_data.data() + m_offset, bytes);
+			m_offset += bytes;
+		}
+
+		template< class T >
+		T Read()
+		{
+			T value;
+			Read(&value, sizeof(T));
+			return value;
+		}
+
+		string ReadString()
+		{
+			unsigned short length = Read<unsigned short>();
+			string str(length, '\0');
+			if(length > 0)
+			{
+				Read(&str[0], length);
+			}
+
+			return str;
+		}
+
+		// Reads a uint32 length followed by an array of T into scratch, returns the number of elements read
+		template< class T >
+		unsigned int ReadArray(vector<char>& scratch)
+		{
+			unsigned int length = Read<unsigned int>();
+			if(!m_bValid || (length > (m_data.size() - m_offset) / sizeof(T)))
+			{
+				m_bValid = false;
+				return 0;
+			}
+
+			scratch.resize(length * sizeof(T));
+			Read(scratch.data(), scratch.size());
+			return length;
+		}
+
+		size_t GetOffset() const { return m_offset; }
+		bool IsValid() const { return m_bValid; }
+		bool IsEnd() const { return m_offset >= m_data.size(); }
+		void Invalidate() { m_bValid = false; }
+
+	private:
+
+		const vector<char>& m_data;
+		size_t m_offset;
+		bool m_bValid;
+	};
+
+	void AddUnique(vector<string>& list, const string& str)
+	{
+		if(find(list.begin(), list.end(), str) == list.end())
+		{
+			list.push_back(str);
+		}
+	}
+}
+
+RenderCaptureWriter::RenderCaptureWriter(const string& file, unsigned int frames) : m_uiFramesLeft(frames)
+{
+	m_stream.open(file, ios::binary | ios::trunc);
+
+	Write(CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+	Write(CAPTURE_VERSION);
+}
+
+bool RenderCaptureWriter::IsOpen() const
+{
+	return m_stream.is_open();
+}
+
+void RenderCaptureWriter::SetRenderSpace(RenderSpace space)
+{
+	Write(RenderCommand::RenderSpace);
+	Write((unsigned char)space);
+}
+
+void RenderCaptureWriter::DrawLine(const glm::vec3* pArray, unsigned int length, float fWidth, const glm::vec4& color, const glm::mat4& T)
+{
+	if(pArray == nullptr)
+		return;
+
+	Write(RenderCommand::Line);
+	Write(length);
+	Write(pArray, length * sizeof(glm::vec3));
+	Write(fWidth);
+	Write(color);
+	Write(T);
+}
+
+void RenderCaptureWriter::DrawString(const char* str, const glm::vec3& pos, const glm::vec4& color, float scale, const char* font, FontAlignment alignment)
+{
+	if(str == nullptr)
+		return;
+
+	unsigned short fontId = (font != nullptr) ? AddString(font) : NO_STRING;
+	unsigned short length = (unsigned short)min<size_t>(strlen(str), NO_STRING);
+
+	Write(RenderCommand::Text);
+	Write(fontId);
+	Write(length);
+	Write(str, length);
+	Write(pos);
+	Write(color);
+	Write(scale);
+	Write((unsigned char)alignment);
+}
+
+void RenderCaptureWriter::DrawSprite(const string& texture, const glm::mat4& T, const glm::vec4& color, const glm::vec2& tiling, unsigned int iCellId, const string& tech)
+{
+	unsigned short textureId = AddString(texture);
+	unsigned short techId = AddString(tech);
+
+	Write(RenderCommand::Sprite);
+	Write(textureId);
+	Write(techId);
+	Write(T);
+	Write(color);
+	Write(tiling);
+	Write(iCellId);
+}
+
+void RenderCaptureWriter::DrawSprites(const string& texture, const SpriteInstance* pArray, unsigned int length, const string& tech)
+{
+	WriteArray(RenderCommand::Sprites, texture, pArray, length, tech);
+}
+
+void RenderCaptureWriter::DrawSprites(const string& texture, const Sprite2D* pArray, unsigned int length, const string& tech)
+{
+	WriteArray(RenderCommand::Sprites2D, texture, pArray, length, tech);
+}
+
+void RenderCaptureWriter::DrawParticles(const string& texture, const ParticleVertex* pArray, unsigned int length, const string& tech)
+{
+	WriteArray(RenderCommand::Particles, texture, pArray, length, tech);
+}
+
+void RenderCaptureWriter::DrawMesh(const string& mesh, const string& texture, const glm::mat4& T, const glm::vec4& color, const string& tech)
+{
+	unsigned short meshId = AddString(mesh);
+	unsigned short textureId = AddString(texture);
+	unsigned short techId = AddString(tech);
+
+	Write(RenderCommand::Mesh);
+	Write(meshId);
+	Write(textureId);
+	Write(techId);
+	Write(T);
+	Write(color);
+}
+
+bool RenderCaptureWriter::Present(const Camera* pWorldCamera)
+{
+	if(pWorldCamera != nullptr)
+	{
+		Write(RenderCommand::WorldCamera);
+		Write(pWorldCamera->View());
+		Write(pWorldCamera->Proj());
+	}
+
+	Write(RenderCommand::Present);
+
+	if(m_uiFramesLeft > 0)
+	{
+		--m_uiFramesLeft;
+	}
+
+	if(m_uiFramesLeft == 0)
+	{
+		m_stream.close();
+		return true;
+	}
+
+	return false;
+}
+
+unsigned short RenderCaptureWriter::AddString(const string& str)
+{
+	auto iter = m_strings.find(str);
+	if(iter != m_strings.end())
+		return iter->second;
+
+	assert(m_strings.size() < NO_STRING);
+
+	unsigned short id = (unsigned short)m_strings.size();
+	unsigned short length = (unsigned short)min<size_t>(str.size(), NO_STRING);
+
+	m_strings.emplace(str, id);
+
+	Write(RenderCommand::String);
+	Write(id);
+	Write(length);
+	Write(str.data(), length);
+
+	return id;
+}
+
+void RenderCaptureWriter::Write(const void* pData, size_t bytes)
+{
+	m_stream.write(static_cast<const char*>(pData), bytes);
+}
+
+template< class T >
+void RenderCaptureWriter::WriteArray(RenderCommand command, const string& texture, const T* pArray, unsigned int length, const string& tech)
+{
+	if(pArray == nullptr)
+		return;
+
+	unsigned short textureId = AddString(texture);
+	unsigned short techId = AddString(tech);
+
+	Write(command);
+	Write(textureId);
+	Write(techId);
+	Write(length);
+	Write(pArray, length * sizeof(T));
+}
+
+void RenderCaptureReader::CaptureCamera::Set(const glm::mat4& view, const glm::mat4& proj)
+{
+	m_View = view;
+	m_Proj = proj;
+	Update();
+}
+
+bool RenderCaptureReader::Load(const string& file)
+{
+	m_data.clear();
+	m_frames.clear();
+	m_strings.clear();
+	m_textures.clear();
+
+	ifstream stream(file, ios::binary);
+	if(!stream.is_open())
+		return false;
+
+	m_data.assign(istreambuf_iterator<char>(stream), istreambuf_iterator<char>());
+
+	CaptureStream header(m_data, 0);
+	char magic[4];
+	header.Read(magic, sizeof(magic));
+	unsigned int version = header.Read<unsigned int>();
+
+	if(!header.IsValid() || (memcmp(magic, CAPTURE_MAGIC, sizeof(magic)) != 0) || (version != CAPTURE_VERSION))
+		return false;
+
+	size_t offset = header.GetOffset();
+	while(offset < m_data.size())
+	{
+		size_t frame = offset;
+		if(!Parse(offset, nullptr))
+		{
+			// The last frame is incomplete if the capture was interrupted
+			break;
+		}
+
+		m_frames.push_back(frame);
+	}
+
+	return !m_frames.empty();
+}
+
+unsigned int RenderCaptureReader::GetNumFrames() const
+{
+	return (unsigned int)m_frames.size();
+}
+
+const vector<string>& RenderCaptureReader::GetTextures() const
+{
+	return m_textures;
+}
+
+void RenderCaptureReader::Replay(unsigned int frame, IRenderer& renderer)
+{
+	assert(frame < m_frames.size());
+
+	size_t offset = m_frames[frame];
+	bool bSuccess = Parse(offset, &renderer);
+	assert(bSuccess);
+}
+
+bool RenderCaptureReader::Parse(size_t& offset, IRenderer* pRenderer)
+{
+	CaptureStream stream(m_data, offset);
+
+	auto GetString = [&](unsigned short id) -> const string&
+	{
+		static const string empty;
+		if(id >= m_strings.size())
+		{
+			stream.Invalidate();
+			return empty;
+		}
+
+		return m_strings[id];
+	};
+
+	while(stream.IsValid() && !stream.IsEnd())
+	{
+		RenderCommand command = stream.Read<RenderCommand>();
+
+		switch(command)
+		{
+		case RenderCommand::String:
+		{
+			unsigned short id = stream.Read<unsigned short>();
+			string str = stream.ReadString();
+
+			// Strings are already in the table when a frame is replayed
+			if(id == m_strings.size())
+			{
+				m_strings.push_back(str);
+			}
+			else if(id > m_strings.size())
+			{
+				stream.Invalidate();
+			}
+			break;
+		}
+		case RenderCommand::RenderSpace:
+		{
+			RenderSpace space = (RenderSpace)stream.Read<unsigned char>();
+			if(pRenderer != nullptr && stream.IsValid())
+			{
+				pRenderer->SetRenderSpace(space);
+			}
+			break;
+		}
+		case RenderCommand::Line:
+		{
+			unsigned int length = stream.ReadArray<glm::vec3>(m_scratch);
+			float fWidth = stream.Read<float>();
+			glm::vec4 color = stream.Read<glm::vec4>();
+			glm::mat4 T = stream.Read<glm::mat4>();
+			if(pRenderer != nullptr && stream.IsValid())
+			{
+				pRenderer->DrawLine(reinterpret_cast<const glm::vec3*>(m_scratch.data()), length, fWidth, color, T);
+			}
+			break;
+		}
+		case RenderCommand::Text:
+		{
+			unsigned short fontId = stream.Read<unsigned short>();
+			string str = stream.ReadString();
+			glm::vec3 pos = stream.Read<glm::vec3>();
+			glm::vec4 color = stream.Read<glm::vec4>();
+			float scale = stream.Read<float>();
+			FontAlignment alignment = (FontAlignment)stream.Read<unsigned char>();
+			const char* font = (fontId != NO_STRING) ? GetString(fontId).c_str() : nullptr;
+			if(pRenderer != nullptr && stream.IsValid())
+			{
+				pRenderer->DrawString(str.c_str(), pos, color, scale, font, alignment);
+			}
+			break;
+		}
+		case RenderCommand::Sprite:
+		{
+			const string& texture = GetString(stream.Read<unsigned short>());
+			const string& tech = GetString(stream.Read<unsigned short>());
+			glm::mat4 T = stream.Read<glm::mat4>();
+			glm::vec4 color = stream.Read<glm::vec4>();
+			glm::vec2 tiling = stream.Read<glm::vec2>();
+			unsigned int iCellId = stream.Read<unsigned int>();
+			if(pRenderer == nullptr)
+			{
+				AddUnique(m_textures, texture);
+			}
+			else if(stream.IsValid())
+			{
+				pRenderer->DrawSprite(texture, T, color, tiling, iCellId, tech);
+			}
+			break;
+		}
+		case RenderCommand::Sprites:
+		case RenderCommand::Sprites2D:
+		case RenderCommand::Particles:
+		{
+			const string& texture = GetString(stream.Read<unsigned short>());
+			const string& tech = GetString(stream.Read<unsigned short>());
+
+			unsigned int length = 0;
+			if(command == RenderCommand::Sprites)
+			{
+				length = stream.ReadArray<SpriteInstance>(m_scratch);
+			}
+			else if(command == RenderCommand::Sprites2D)
+			{
+				length = stream.ReadArray<Sprite2D>(m_scratch);
+			}
+			else
+			{
+				length = stream.ReadArray<ParticleVertex>(m_scratch);
+			}
+
+			if(pRenderer == nullptr)
+			{
+				AddUnique(m_textures, texture);
+			}
+			else if(stream.IsValid())
+			{
+				if(command == RenderCommand::Sprites)
+				{
+					pRenderer->DrawSprites(texture, reinterpret_cast<const SpriteInstance*>(m_scratch.data()), length, tech);
+				}
+				else if(command == RenderCommand::Sprites2D)
+				{
+					pRenderer->DrawSprites(texture, reinterpret_cast<const Sprite2D*>(m_scratch.data()), length, tech);
+				}
+				else
+				{
+					pRenderer->DrawParticles(texture, reinterpret_cast<const ParticleVertex*>(m_scratch.data()), length, tech);
+				}
+			}
+			break;
+		}
+		case RenderCommand::Mesh:
+		{
+			const string& mesh = GetString(stream.Read<unsigned short>());
+			const string& texture = GetString(stream.Read<unsigned short>());
+			const string& tech = GetString(stream.Read<unsigned short>());
+			glm::mat4 T = stream.Read<glm::mat4>();
+			glm::vec4 color = stream.Read<glm::vec4>();
+			if(pRenderer == nullptr)
+			{
+				AddUnique(m_textures, texture);
+			}
+			else if(stream.IsValid())
+			{
+				pRenderer->DrawMesh(mesh, texture, T, color, tech);
+			}
+			break;
+		}
+		case RenderCommand::WorldCamera:
+		{
+			glm::mat4 view = stream.Read<glm::mat4>();
+			glm::mat4 proj = stream.Read<glm::mat4>();
+			if(pRenderer != nullptr && stream.IsValid())
+			{
+				m_camera.Set(view, proj);
+				pRenderer->SetCamera(&m_camera);
+			}
+			break;
+		}
+		case RenderCommand::Present:
+			offset = stream.GetOffset();
+			return true;
+		default:
+			stream.Invalidate();
+			break;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,114 @@
+#ifndef _RENDERCAPTURE_
+#define _RENDERCAPTURE_
+
+#include "CommonExport.h"
+#include "IRenderer.h"
+#include "Camera.h"
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+#include <string>
+
+// A render capture is a binary file that stores every command submitted to the renderer during one or more frames
+// Layout: "RCAP", uint32 version, followed by a list of commands
+// Each command is a single byte followed by its payload, resources are referenced by an index into the string table
+enum class RenderCommand : unsigned char
+{
+	String, // uint16 id, uint16 length, chars: adds a string to the string table
+	RenderSpace, // uint8 space
+	Line, // uint32 length, vec3[length], float width, vec4 color, mat4 transformation
+	Text, // uint16 font, uint16 length, chars, vec3 pos, vec4 color, float scale, uint8 alignment
+	Sprite, // uint16 texture, uint16 tech, mat4 transformation, vec4 color, vec2 tiling, uint32 cellId
+	Sprites, // uint16 texture, uint16 tech, uint32 length, SpriteInstance[length]
+	Sprites2D, // uint16 texture, uint16 tech, uint32 length, Sprite2D[length]
+	Particles, // uint16 texture, uint16 tech, uint32 length, ParticleVertex[length]
+	Mesh, // uint16 mesh, uint16 texture, uint16 tech, mat4 transformation, vec4 color
+	WorldCamera, // mat4 view, mat4 proj: world camera used when the frame is presented
+	Present // end of the frame
+};
+
+// Records the commands submitted to a renderer into a render capture
+class RenderCaptureWriter
+{
+public:
+
+	// Creates the capture file, frames is the number of frames to record
+	COMMON_API RenderCaptureWriter(const std::string& file, unsigned int frames);
+
+	// Returns true if the file was created
+	COMMON_API bool IsOpen() const;
+
+	// Record a single command, the parameters match the ones of IRenderer
+	COMMON_API void SetRenderSpace(RenderSpace space);
+	COMMON_API void DrawLine(const glm::vec3* pArray, unsigned int length, float fWidth, const glm::vec4& color, const glm::mat4& T);
+	COMMON_API void DrawString(const char* str, const glm::vec3& pos, const glm::vec4& color, float scale, const char* font, FontAlignment alignment);
+	COMMON_API void DrawSprite(const std::string& texture, const glm::mat4& T, const glm::vec4& color, const glm::vec2& tiling, unsigned int iCellId, const std::string& tech);
+	COMMON_API void DrawSprites(const std::string& texture, const SpriteInstance* pArray, unsigned int length, const std::string& tech);
+	COMMON_API void DrawSprites(const std::string& texture, const Sprite2D* pArray, unsigned int length, const std::string& tech);
+	COMMON_API void DrawParticles(const std::string& texture, const ParticleVertex* pArray, unsigned int length, const std::string& tech);
+	COMMON_API void DrawMesh(const std::string& mesh, const std::string& texture, const glm::mat4& T, const glm::vec4& color, const std::string& tech);
+
+	// Ends the current frame, pWorldCamera may be null if there is no world camera
+	// Returns true once all of the frames have been recorded
+	COMMON_API bool Present(const Camera* pWorldCamera);
+
+private:
+
+	std::ofstream m_stream;
+	std::unordered_map<std::string, unsigned short> m_strings;
+	unsigned int m_uiFramesLeft;
+
+	// Returns the index of the string in the string table, the string gets written to the file the first time it is used
+	unsigned short AddString(const std::string& str);
+
+	void Write(const void* pData, size_t bytes);
+
+	template< class T >
+	void Write(const T& value)
+	{
+		Write(&value, sizeof(T));
+	}
+
+	template< class T >
+	void WriteArray(RenderCommand command, const std::string& texture, const T* pArray, unsigned int length, const std::string& tech);
+};
+
+// Loads a render capture and submits its frames to a renderer
+class RenderCaptureReader
+{
+public:
+
+	// Loads the capture file, returns false if the file cannot be read or is not a valid capture
+	COMMON_API bool Load(const std::string& file);
+
+	// Returns the number of frames in the capture
+	COMMON_API unsigned int GetNumFrames() const;
+
+	// Returns the textures referenced by the capture
+	COMMON_API const std::vector<std::string>& GetTextures() const;
+
+	// Submits every command of the frame to the renderer, Present() is not called
+	COMMON_API void Replay(unsigned int frame, IRenderer& renderer);
+
+private:
+
+	// World camera restored from the matrices stored in the capture
+	class CaptureCamera : public PerspectiveCamera
+	{
+	public:
+		void Set(const glm::mat4& view, const glm::mat4& proj);
+	};
+
+	std::vector<char> m_data;
+	std::vector<size_t> m_frames; // offset of the first command of each frame
+	std::vector<std::string> m_strings;
+	std::vector<std::string> m_textures;
+	std::vector<char> m_scratch; // arrays are copied out of m_data so that they are correctly aligned
+	CaptureCamera m_camera;
+
+	// Parses the commands of a single frame starting at offset, the commands are submitted to pRenderer if it is not null
+	// Returns false if the data is malformed
+	bool Parse(size_t& offset, IRenderer* pRenderer);
+};
+
+#endif // _RENDERCAPTURE_